@@ -22,6 +22,8 @@ struct ActionResult {
     std::string error;
     int64_t item_id = 0;
     std::string item_name;
+    int64_t started_us = 0;   // steady_clock microseconds when the call started
+    int64_t duration_us = 0;  // Time spent resolving arguments and calling the function
 };
 
 /**
@@ -96,6 +98,18 @@ public:
      */
     ActionResult execute_from_payload(const nlohmann::json& payload);
 
+    /**
+     * Execute every action of an execute_actions message in a single pass.
+     *
+     * Each entry of the array has the same shape as an execute_action payload.
+     * The Lua state is fetched once and function paths are resolved once per
+     * distinct action for the whole batch.
+     *
+     * @param actions The "actions" array from the IPC message payload
+     * @return One ActionResult per entry, in the same order
+     */
+    std::vector<ActionResult> execute_batch(const nlohmann::json& actions);
+
     /**
      * Parse an ArgType from its string representation.
      */
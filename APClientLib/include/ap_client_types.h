@@ -89,6 +89,7 @@ namespace IPCMessageType {
     // Framework -> Client
     constexpr const char* AP_MESSAGE = "ap_message";
     constexpr const char* EXECUTE_ACTION = "execute_action";
+    constexpr const char* EXECUTE_ACTIONS = "execute_actions";
     constexpr const char* LIFECYCLE = "lifecycle";
     constexpr const char* ERROR_MSG = "error";
     constexpr const char* REGISTRATION_RESPONSE = "registration_response";
@@ -3,7 +3,9 @@
 
 #include <sol/sol.hpp>
 
+#include <chrono>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 namespace ap::client {
@@ -35,6 +37,157 @@ public:
         try {
             // Resolve the function from the action path
             sol::object func = resolve_function_path(*lua, action);
+            return invoke(*lua, func, action, args, std::move(result));
+
+        } catch (const sol::error& e) {
+            result.success = false;
+            result.error = "Sol2 error: " + std::string(e.what());
+            return result;
+        } catch (const std::exception& e) {
+            result.success = false;
+            result.error = "Exception: " + std::string(e.what());
+            return result;
+        }
+    }
+
+    ActionResult execute_from_payload(const nlohmann::json& payload) {
+        ActionResult result;
+        std::string action;
+        std::vector<ActionArg> args;
+
+        if (!parse_payload(payload, action, args, result)) {
+            return result;
+        }
+
+        return execute(action, args, result.item_id, result.item_name);
+    }
+
+    std::vector<ActionResult> execute_batch(const nlohmann::json& actions) {
+        std::vector<ActionResult> results;
+        if (!actions.is_array()) {
+            return results;
+        }
+        results.reserve(actions.size());
+
+        // Resolve the Lua state once for the whole batch
+        sol::state_view* lua = APClientManager::instance().get_lua_state();
+
+        // Batches are usually many copies of a few actions
+        std::unordered_map<std::string, sol::object> function_cache;
+
+        for (const auto& payload : actions) {
+            ActionResult result;
+            std::string action;
+            std::vector<ActionArg> args;
+
+            if (!parse_payload(payload, action, args, result)) {
+                results.push_back(std::move(result));
+                continue;
+            }
+
+            if (!lua) {
+                result.success = false;
+                result.error = "Lua state not available";
+                results.push_back(std::move(result));
+                continue;
+            }
+
+            try {
+                auto it = function_cache.find(action);
+                if (it == function_cache.end()) {
+                    it = function_cache.emplace(action, resolve_function_path(*lua, action)).first;
+                }
+                results.push_back(invoke(*lua, it->second, action, args, std::move(result)));
+
+            } catch (const sol::error& e) {
+                result.success = false;
+                result.error = "Sol2 error: " + std::string(e.what());
+                results.push_back(std::move(result));
+            } catch (const std::exception& e) {
+                result.success = false;
+                result.error = "Exception: " + std::string(e.what());
+                results.push_back(std::move(result));
+            }
+        }
+
+        return results;
+    }
+
+private:
+    /**
+     * Extract action, arguments and item identity from a single action payload.
+     * Returns false (with result filled in) if the payload is unusable.
+     */
+    bool parse_payload(
+        const nlohmann::json& payload,
+        std::string& action,
+        std::vector<ActionArg>& args,
+        ActionResult& result
+    ) {
+        try {
+            // Extract required fields
+            result.item_id = payload.value("item_id", 0LL);
+            result.item_name = payload.value("item_name", "");
+            action = payload.value("action", "");
+
+            if (action.empty()) {
+                result.success = false;
+                result.error = "No action specified in payload";
+                return false;
+            }
+
+            // Parse arguments
+            if (payload.contains("args") && payload["args"].is_array()) {
+                for (const auto& arg_json : payload["args"]) {
+                    ActionArg arg;
+                    arg.name = arg_json.value("name", "");
+                    arg.type = APActionExecutor::parse_arg_type(arg_json.value("type", "string"));
+                    arg.value = arg_json.value("value", nlohmann::json());
+                    args.push_back(arg);
+                }
+            }
+
+            return true;
+
+        } catch (const nlohmann::json::exception& e) {
+            result.success = false;
+            result.error = "JSON parse error: " + std::string(e.what());
+            return false;
+        }
+    }
+
+    /**
+     * Call an already-resolved action function and record how long it took.
+     */
+    ActionResult invoke(
+        sol::state_view& lua,
+        const sol::object& func,
+        const std::string& action,
+        const std::vector<ActionArg>& args,
+        ActionResult result
+    ) {
+        auto started = std::chrono::steady_clock::now();
+        result = call_action(lua, func, action, args, std::move(result));
+        auto finished = std::chrono::steady_clock::now();
+
+        result.started_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            started.time_since_epoch()).count();
+        result.duration_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            finished - started).count();
+        return result;
+    }
+
+    /**
+     * Call an already-resolved action function with the given arguments.
+     */
+    ActionResult call_action(
+        sol::state_view& lua,
+        const sol::object& func,
+        const std::string& action,
+        const std::vector<ActionArg>& args,
+        ActionResult result
+    ) {
+        try {
             if (!func.is<sol::function>()) {
                 result.success = false;
                 result.error = "Function not found: " + action;
@@ -43,8 +196,9 @@ public:
 
             // Build arguments
             std::vector<sol::object> lua_args;
+            lua_args.reserve(args.size());
             for (const auto& arg : args) {
-                sol::object resolved = resolve_argument(*lua, arg);
+                sol::object resolved = resolve_argument(lua, arg);
                 lua_args.push_back(resolved);
             }
 
@@ -102,46 +256,6 @@ public:
         }
     }
 
-    ActionResult execute_from_payload(const nlohmann::json& payload) {
-        ActionResult result;
-
-        try {
-            // Extract required fields
-            int64_t item_id = payload.value("item_id", 0LL);
-            std::string item_name = payload.value("item_name", "");
-            std::string action = payload.value("action", "");
-
-            result.item_id = item_id;
-            result.item_name = item_name;
-
-            if (action.empty()) {
-                result.success = false;
-                result.error = "No action specified in payload";
-                return result;
-            }
-
-            // Parse arguments
-            std::vector<ActionArg> args;
-            if (payload.contains("args") && payload["args"].is_array()) {
-                for (const auto& arg_json : payload["args"]) {
-                    ActionArg arg;
-                    arg.name = arg_json.value("name", "");
-                    arg.type = APActionExecutor::parse_arg_type(arg_json.value("type", "string"));
-                    arg.value = arg_json.value("value", nlohmann::json());
-                    args.push_back(arg);
-                }
-            }
-
-            return execute(action, args, item_id, item_name);
-
-        } catch (const nlohmann::json::exception& e) {
-            result.success = false;
-            result.error = "JSON parse error: " + std::string(e.what());
-            return result;
-        }
-    }
-
-private:
     /**
      * Resolve a function path like "MyUserObj.UnlockTechnology" to the actual Lua function.
      */
@@ -236,6 +350,10 @@ ActionResult APActionExecutor::execute_from_payload(const nlohmann::json& payloa
     return impl_->execute_from_payload(payload);
 }
 
+std::vector<ActionResult> APActionExecutor::execute_batch(const nlohmann::json& actions) {
+    return impl_->execute_batch(actions);
+}
+
 ArgType APActionExecutor::parse_arg_type(const std::string& type_str) {
     if (type_str == "string") {
         return ArgType::String;
@@ -33,6 +33,9 @@ static std::mutex g_log_mutex;
 // Cached lifecycle state - updated before callbacks are invoked
 static std::string g_current_lifecycle_state = "UNINITIALIZED";
 
+// Batched action_result replies are split at this much message text
+static constexpr size_t ACTION_RESULTS_MAX_BYTES = 24 * 1024;
+
 // =============================================================================
 // Callback Storage
 // =============================================================================
@@ -164,6 +167,126 @@ static bool invoke_optional_callback(
 // Message Handling
 // =============================================================================
 
+/**
+ * Execute a single action payload and report the result to the framework.
+ */
+static void execute_action_payload(const nlohmann::json& payload) {
+    auto result = g_action_executor->execute_from_payload(payload);
+
+    // Invoke item received callback
+    int64_t item_id = payload.value("item_id", int64_t(0));
+    std::string item_name = payload.value("item_name", "");
+    std::string sender = payload.value("sender", "");
+
+    invoke_optional_callback(g_callback_item_received, "on_item_received", [&](sol::protected_function& cb) {
+        return cb(item_id, item_name, sender);
+    });
+
+    // Send result back to framework
+    if (g_ipc_client && g_ipc_client->is_connected()) {
+        ap::ClientIPCMessage response;
+        response.type = IPCMessageType::ACTION_RESULT;
+        response.source = g_mod_id;
+        response.target = "framework";
+        response.payload = {
+            {"item_id", result.item_id},
+            {"item_name", result.item_name},
+            {"success", result.success},
+            {"error", result.error},
+            {"started_us", result.started_us},
+            {"duration_us", result.duration_us}
+        };
+        g_ipc_client->send_message(response);
+    }
+
+    // If action failed, log it
+    if (!result.success) {
+        log_internal("error", "Action execution failed for " + item_name + ": " + result.error);
+        notify_framework_of_error("action_failed", result.error);
+    }
+}
+
+/**
+ * Execute an execute_actions batch and report all results in one message.
+ */
+static void execute_action_batch(const nlohmann::json& actions) {
+    auto results = g_action_executor->execute_batch(actions);
+
+    nlohmann::json results_json = nlohmann::json::array();
+    size_t failed = 0;
+    std::string first_error;
+    for (size_t i = 0; i < results.size(); ++i) {
+        auto& result = results[i];
+        const auto& entry = actions[i];
+
+        // A malformed entry fails on its own; the rest of the batch still runs
+        if (!entry.is_object()) {
+            result.success = false;
+            result.error = "Action entry is not an object";
+        } else {
+            std::string sender = entry.value("sender", "");
+            invoke_optional_callback(g_callback_item_received, "on_item_received", [&](sol::protected_function& cb) {
+                return cb(result.item_id, result.item_name, sender);
+            });
+        }
+
+        results_json.push_back({
+            {"item_id", result.item_id},
+            {"item_name", result.item_name},
+            {"success", result.success},
+            {"error", result.error},
+            {"started_us", result.started_us},
+            {"duration_us", result.duration_us}
+        });
+
+        if (!result.success) {
+            log_internal("error", "Action execution failed for " + result.item_name + ": " + result.error);
+            if (failed++ == 0) {
+                first_error = result.error;
+            }
+        }
+    }
+
+    // One error for the whole batch; the per-action detail is in the results
+    if (failed > 0) {
+        notify_framework_of_error("action_failed",
+            std::to_string(failed) + " of " + std::to_string(results.size()) +
+            " actions failed (first: " + first_error + ")");
+    }
+
+    // Send all results back to framework
+    if (!g_ipc_client || !g_ipc_client->is_connected()) {
+        return;
+    }
+
+    // Split so every reply fits the framework's 64 KiB pipe read buffer
+    nlohmann::json page = nlohmann::json::array();
+    size_t page_bytes = 0;
+    auto send_page = [&]() {
+        if (page.empty()) {
+            return;
+        }
+        ap::ClientIPCMessage response;
+        response.type = IPCMessageType::ACTION_RESULT;
+        response.source = g_mod_id;
+        response.target = "framework";
+        response.payload = {{"results", std::move(page)}};
+        g_ipc_client->send_message(response);
+        page = nlohmann::json::array();
+        page_bytes = 0;
+    };
+
+    for (auto& entry : results_json) {
+        size_t entry_bytes = entry.dump().size() + 1;
+        if (page_bytes + entry_bytes > ACTION_RESULTS_MAX_BYTES) {
+            send_page();
+        }
+        page.push_back(std::move(entry));
+        page_bytes += entry_bytes;
+    }
+    send_page();
+}
+
 /**
  * Handle incoming messages from the framework.
  */
@@ -177,37 +300,16 @@ void handle_message(const ap::ClientIPCMessage& msg) {
     if (msg.type == IPCMessageType::EXECUTE_ACTION) {
         // Execute the action using the action executor
         if (g_action_executor) {
-            auto result = g_action_executor->execute_from_payload(msg.payload);
-
-            // Invoke item received callback
-            int64_t item_id = msg.payload.value("item_id", int64_t(0));
-            std::string item_name = msg.payload.value("item_name", "");
-            std::string sender = msg.payload.value("sender", "");
-
-            invoke_optional_callback(g_callback_item_received, "on_item_received", [&](sol::protected_function& cb) {
-                return cb(item_id, item_name, sender);
-            });
-
-            // Send result back to framework
-            if (g_ipc_client && g_ipc_client->is_connected()) {
-                ap::ClientIPCMessage response;
-                response.type = IPCMessageType::ACTION_RESULT;
-                response.source = g_mod_id;
-                response.target = "framework";
-                response.payload = {
-                    {"item_id", result.item_id},
-                    {"item_name", result.item_name},
-                    {"success", result.success},
-                    {"error", result.error}
-                };
-                g_ipc_client->send_message(response);
-            }
+            execute_action_payload(msg.payload);
+        } else {
+            log_internal("error", "Action executor not initialized");
+            notify_framework_of_error("action_executor_missing", "APActionExecutor not initialized");
+        }
 
-            // If action failed, log it
-            if (!result.success) {
-                log_internal("error", "Action execution failed for " + item_name + ": " + result.error);
-                notify_framework_of_error("action_failed", result.error);
-            }
+    } else if (msg.type == IPCMessageType::EXECUTE_ACTIONS) {
+        // Several actions for this mod in one message
+        if (g_action_executor) {
+            execute_action_batch(msg.payload.value("actions", nlohmann::json::array()));
         } else {
             log_internal("error", "Action executor not initialized");
             notify_framework_of_error("action_executor_missing", "APActionExecutor not initialized");
@@ -9,9 +9,12 @@
 #include <vector>
 #include <optional>
 #include <cstdint>
+#include <filesystem>
 
 namespace ap {
 
+class NameCache;
+
 /**
  * @brief Received item information.
  */
@@ -68,6 +71,11 @@ struct SlotInfo {
  * 4. In room_info_callback, call connect_slot() with credentials
  * 5. slot_connected_callback or slot_refused_callback fires
  * 6. Continue polling to receive items/messages
+ *
+ * poll(), connect() and disconnect() run on the polling thread while the game
+ * thread sends; every call into apclientpp is made under one lock, so a send
+ * never sees the connection being replaced. Callbacks run inside poll() and
+ * may call back into this object.
  */
 class AP_API APClient {
 public:
@@ -76,11 +84,13 @@ public:
     using SlotConnectedCallback = std::function<void(const SlotInfo&)>;
     using SlotRefusedCallback = std::function<void(const std::vector<std::string>&)>;
     using ItemReceivedCallback = std::function<void(const ReceivedItem&)>;
+    using ItemsReceivedCallback = std::function<void(const std::vector<ReceivedItem>&)>;
     using LocationScoutedCallback = std::function<void(const std::vector<ScoutResult>&)>;
     using DisconnectedCallback = std::function<void()>;
     using PrintCallback = std::function<void(const std::string&)>;
     using PrintJsonCallback = std::function<void(const std::string& type, const nlohmann::json& data)>;
     using BouncedCallback = std::function<void(const nlohmann::json& data)>;
+    using WakeCallback = std::function<void()>;
 
     APClient();
     ~APClient();
@@ -137,6 +147,15 @@ public:
      */
     bool is_slot_connected() const;
 
+    /**
+     * @brief Enable the on-disk data package cache.
+     * @param folder Directory for cached games (see DataPackageCache).
+     *
+     * Must be called before connect(). Cached games are handed to apclientpp
+     * on connect so only games whose checksum changed are downloaded.
+     */
+    void set_data_package_cache_folder(const std::filesystem::path& folder);
+
     // ==========================================================================
     // Polling
     // ==========================================================================
@@ -146,8 +165,10 @@ public:
      *
      * MUST be called regularly (e.g., every frame) to process incoming messages.
      * Callbacks are invoked from within this function.
+     *
+     * @return true if any server traffic or connection state change was handled.
      */
-    void poll();
+    bool poll();
 
     // ==========================================================================
     // Outgoing Messages
@@ -156,8 +177,9 @@ public:
     /**
      * @brief Send location check(s) to the server.
      * @param location_ids Vector of location IDs to mark as checked.
+     * @return true if sent; false if no slot is connected (nothing is sent).
      */
-    void send_location_checks(const std::vector<int64_t>& location_ids);
+    bool send_location_checks(const std::vector<int64_t>& location_ids);
 
     /**
      * @brief Scout location(s) to see what items they contain.
@@ -222,6 +244,16 @@ public:
      */
     std::string get_player_name(int player_id) const;
 
+    /**
+     * @brief Get the current snapshot of interned item/location/player names.
+     * @return Shared snapshot (never null; empty before the first connect).
+     *
+     * Thread-safe. The snapshot is rebuilt when the data package changes or a
+     * slot connects, and gives direct table access (NameTable::entries()) so
+     * callers that only need IDs can skip name lookups entirely.
+     */
+    std::shared_ptr<const NameCache> get_name_cache() const;
+
     /**
      * @brief Get the current player's slot number.
      * @return Slot number, or -1 if not connected.
@@ -260,6 +292,14 @@ public:
      */
     void set_item_received_callback(ItemReceivedCallback callback);
 
+    /**
+     * @brief Set callback for whole ReceivedItems packets.
+     *
+     * When set, this takes precedence over the per-item callback so that
+     * history replays on connect can be handled as a single batch.
+     */
+    void set_items_received_callback(ItemsReceivedCallback callback);
+
     /**
      * @brief Set callback for scouted locations.
      */
@@ -285,6 +325,15 @@ public:
      */
     void set_bounced_callback(BouncedCallback callback);
 
+    /**
+     * @brief Set callback fired after an outgoing packet is queued.
+     *
+     * Lets the poller flush the send right away instead of at its next
+     * scheduled poll. Nothing signals incoming packets, so the reply is
+     * still picked up on the poller's normal interval.
+     */
+    void set_wake_callback(WakeCallback callback);
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl_;
@@ -84,6 +84,7 @@ public:
     LogLevel get_log_level() const { return config_.log_level; }
     const std::string& get_log_file() const { return config_.log_file; }
     bool get_log_to_console() const { return config_.log_to_console; }
+    const LoggingConfig& get_logging() const { return config_.logging; }
 
     const TimeoutConfig& get_timeouts() const { return config_.timeouts; }
     const RetryConfig& get_retry() const { return config_.retry; }
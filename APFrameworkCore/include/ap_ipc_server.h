@@ -83,6 +83,15 @@ public:
      */
     std::vector<IPCMessage> get_pending_messages();
 
+    /**
+     * @brief Move all pending messages into a caller-owned buffer.
+     * @param out Receives the messages; its previous contents are discarded.
+     *
+     * Swaps buffers with the queue, so reusing @p out every frame avoids
+     * reallocating. Use this instead of poll() to dispatch messages yourself.
+     */
+    void get_pending_messages(std::vector<IPCMessage>& out);
+
     /**
      * @brief Poll for new messages (non-blocking).
      *
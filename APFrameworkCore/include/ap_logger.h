@@ -2,6 +2,7 @@
 
 #include "ap_types.h"
 #include "ap_exports.h"
+#include "binary_log.h"
 
 #include <string>
 #include <fstream>
@@ -9,9 +10,75 @@
 #include <functional>
 #include <sstream>
 #include <memory>
+#include <optional>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <set>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 namespace ap {
 
+// =============================================================================
+// Deferred Message Formatting
+// =============================================================================
+
+inline void log_append(std::string& out, std::string_view value) { out.append(value); }
+inline void log_append(std::string& out, const char* value) { out.append(value ? value : "(null)"); }
+inline void log_append(std::string& out, char value) { out.push_back(value); }
+inline void log_append(std::string& out, bool value) { out.append(value ? "true" : "false"); }
+
+template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+void log_append(std::string& out, T value) {
+    out.append(std::to_string(value));
+}
+
+/**
+ * @brief Concatenate log message parts (strings, chars, bools, numbers).
+ *
+ * Used by AP_LOG so the message is only built once the level check passed.
+ */
+template <typename... Args>
+std::string log_concat(const Args&... args) {
+    std::string out;
+    (log_append(out, args), ...);
+    return out;
+}
+
+/**
+ * @brief A log entry kept in memory for get_logs.
+ */
+struct LogEntry {
+    uint64_t sequence = 0;                 // Increases by one per entry, starting at 1
+    std::chrono::system_clock::time_point time;
+    LogLevel level = LogLevel::Info;
+    std::string thread;
+    std::string component;                 // Leading "[component] " of the message, if any
+    std::string message;                   // Message without the component prefix
+};
+
+/**
+ * @brief Filter and cursor for APLogger::query_logs().
+ */
+struct LogQuery {
+    uint64_t after = 0;                    // Only entries with a larger sequence
+    bool newest = false;                   // Return the newest matches instead of the oldest
+    LogLevel min_level = LogLevel::Trace;
+    std::set<LogLevel> levels;             // Empty = all levels at/above min_level
+    std::set<std::string> components;      // Empty = all components
+    size_t limit = 100;
+    size_t max_bytes = 0;                  // Stop once messages total this many bytes; 0 = no cap
+};
+
+struct LogPage {
+    std::vector<LogEntry> entries;         // Oldest first
+    uint64_t first_sequence = 0;           // Oldest entry still in memory (0 if none)
+    uint64_t last_sequence = 0;            // Newest entry logged so far
+    bool more = false;                     // Matches left out (later ones, or older ones when newest)
+};
+
 class AP_API APLogger {
 public:
     static APLogger& instance();
@@ -19,9 +86,49 @@ public:
     APLogger(const APLogger&) = delete;
     APLogger& operator=(const APLogger&) = delete;
 
-    bool init(LogLevel min_level, const std::string& log_file_path, bool console_output);
+    /**
+     * @brief Open the text log and, optionally, the binary log.
+     * @param binary_log_path Compact binary sink (see binary_log.h); empty
+     *        to disable. Decode it with the ap_log_decoder tool.
+     */
+    bool init(LogLevel min_level, const std::string& log_file_path, bool console_output,
+              const std::string& binary_log_path = "");
     void shutdown();
 
+    /**
+     * @brief Switch to the asynchronous backend.
+     *
+     * Callers push records into a lock-free ring and return; a background
+     * writer batches file and console output and flushes per the config.
+     * Fatal records drain the ring synchronously. No-op before init() or
+     * when already enabled.
+     */
+    void enable_async(const LoggingConfig& config);
+
+    /**
+     * @brief Drain pending records, stop the writer and go back to
+     * synchronous writes. Called by shutdown().
+     */
+    void disable_async();
+
+    bool is_async() const;
+
+    /**
+     * @brief Rotate the text log once it reaches max_file_size_mb or is
+     *        rotate_interval_hours old.
+     *
+     * The log is renamed to <name>.<YYYYMMDD-HHMMSS>.log and reopened. The
+     * logging thread only does the rename. Compressing the old file and
+     * deleting files beyond max_rotated_files happen on a background thread.
+     * No-op before init() or without a log file.
+     */
+    void configure_rotation(const LoggingConfig& config);
+
+    /**
+     * @brief Write out everything logged so far and flush the file.
+     */
+    void flush();
+
     void trace(const std::string& message);
     void debug(const std::string& message);
     void info(const std::string& message);
@@ -30,11 +137,129 @@ public:
     void fatal(const std::string& message);
 
     void log(LogLevel level, const std::string& message);
+
+    /**
+     * @brief Log "[component] message"; known component names use their
+     *        own level (see set_component_level()).
+     */
     void log(LogLevel level, const std::string& component, const std::string& message);
 
+    /**
+     * @brief Log `message` as given, filtered by the level of `component`.
+     */
+    void log(LogLevel level, LogComponent component, const std::string& message);
+
     void set_min_level(LogLevel level);
     LogLevel get_min_level() const;
 
+    /**
+     * @brief Whether a record at `level` would be written (lock-free).
+     */
+    bool is_enabled(LogLevel level) const {
+        return level >= min_level_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Whether a record at `level` for `component` would be written.
+     *
+     * One table lookup: the component's own level if set, else the global one.
+     */
+    bool is_enabled(LogLevel level, LogComponent component) const {
+        if (component < LogComponent::None) {
+            int level_override =
+                component_levels_[static_cast<size_t>(component)].load(std::memory_order_relaxed);
+            if (level_override != INHERIT_LEVEL) {
+                return static_cast<int>(level) >= level_override;
+            }
+        }
+        return is_enabled(level);
+    }
+
+    // =========================================================================
+    // Per-Component Levels
+    // =========================================================================
+
+    /**
+     * @brief Give `component` its own minimum level, above or below the
+     *        global one. No-op for LogComponent::None.
+     */
+    void set_component_level(LogComponent component, LogLevel level);
+
+    /**
+     * @brief Make `component` follow the global level again.
+     */
+    void clear_component_level(LogComponent component);
+
+    /**
+     * @brief The component's own level, or nullopt if it follows the global one.
+     */
+    std::optional<LogLevel> get_component_level(LogComponent component) const;
+
+    /**
+     * @brief Log the concatenation of `args` if `level` is enabled.
+     *
+     * The arguments themselves are still evaluated by the caller; use AP_LOG
+     * when computing them is not free.
+     */
+    template <typename... Args>
+    void logf(LogLevel level, const Args&... args) {
+        if (is_enabled(level)) {
+            write_log_entry(level, log_concat(args...));
+        }
+    }
+
+    // =========================================================================
+    // Format-String Logging
+    // =========================================================================
+
+    /**
+     * @brief Intern a component and "{}" format string.
+     * @return Format ID for log_format(). AP_LOG_FMT calls this once per
+     *         call site.
+     */
+    uint32_t register_format(LogComponent component, const std::string& format);
+
+    /**
+     * @brief Log a registered format with raw arguments.
+     *
+     * The message is formatted and logged as "[component] message". With
+     * the binary log open the arguments are also written to it as-is, and
+     * the text is only formatted if a text sink (log file, console,
+     * callback or history) is active.
+     *
+     * `format` is the string already interned as `format_id`; it is taken
+     * only so AP_LOG_FMT can forward its arguments unchanged.
+     */
+    template <typename... Args>
+    void log_format(LogLevel level, LogComponent component, uint32_t format_id,
+                    const char* /*format*/, const Args&... args) {
+        if (is_enabled(level, component)) {
+            std::string& encoded = format_scratch();
+            encoded.clear();
+            binary_log::encode_args(encoded, args...);
+            write_format_record(level, format_id, encoded);
+        }
+    }
+
+    bool is_binary_enabled() const;
+
+    // =========================================================================
+    // In-Memory History
+    // =========================================================================
+
+    /**
+     * @brief Keep the last `capacity` entries in memory; 0 disables and
+     *        clears the history.
+     */
+    void set_history_capacity(size_t capacity);
+
+    /**
+     * @brief Page through the in-memory history.
+     *
+     * Includes AP_LOG_FMT records, formatted as text.
+     */
+    LogPage query_logs(const LogQuery& query) const;
+
     void set_console_output(bool enabled);
     bool get_console_output() const;
 
@@ -46,33 +271,133 @@ public:
     static std::string get_thread_name();
 
 private:
-    APLogger() = default;
+    struct LogRecord;
+    class AsyncWriter;
+    class BinarySink;
+    class History;
+    class Rotator;
+
+    APLogger();
     ~APLogger();
 
     void write_log_entry(LogLevel level, const std::string& message);
-    std::string get_timestamp() const;
-    std::string format_log_entry(LogLevel level, const std::string& message) const;
+    void write_format_record(LogLevel level, uint32_t format_id, const std::string& encoded_args);
+    void write_text_entry(LogLevel level, const std::string& message);     // File, console, callback, history
+    void update_text_sinks();              // Requires mutex_
+    void rotate_if_needed();               // Requires mutex_
+    static std::string& format_scratch();  // Per-thread argument buffer
+    // Both require mutex_ (they use the timestamp cache)
+    void append_timestamp(std::string& out, std::chrono::system_clock::time_point time) const;
+    void format_log_entry(std::string& out, const LogRecord& record) const;
+
+    static constexpr int INHERIT_LEVEL = -1;
 
-    LogLevel min_level_ = LogLevel::Info;
+    std::atomic<LogLevel> min_level_{LogLevel::Info};
+    std::atomic<int> component_levels_[LOG_COMPONENT_COUNT];    // LogLevel value or INHERIT_LEVEL
     std::ofstream log_file_;
+    std::string log_file_path_;
     bool console_output_ = true;
     bool initialized_ = false;
     LogCallback log_callback_;
     mutable std::mutex mutex_;
+    std::atomic<bool> text_sinks_enabled_{true};   // File, console or callback; set under mutex_
+
+    // Formatting state, guarded by mutex_
+    mutable int64_t cached_second_ = INT64_MIN;
+    mutable std::string cached_prefix_;    // "[YYYY-MM-DD HH:MM:SS." for cached_second_
+    std::string line_buffer_;              // Reused for every formatted line
+
+    // Async backend; writer_ outlives every producer that saw async_enabled_
+    std::unique_ptr<AsyncWriter> writer_;
+    std::atomic<bool> async_enabled_{false};
+    std::atomic<int> active_producers_{0};
+    std::mutex async_mutex_;               // Serializes enable/disable
+
+    // Binary sink; owns the format registry, so it exists before init()
+    std::unique_ptr<BinarySink> binary_;
+    std::atomic<bool> binary_enabled_{false};
+
+    std::unique_ptr<History> history_;
+
+    // Rotation, guarded by mutex_
+    std::unique_ptr<Rotator> rotator_;
+    uint64_t log_file_bytes_ = 0;
+    uint64_t rotate_max_bytes_ = 0;        // 0 = no size limit
+    std::chrono::steady_clock::duration rotate_interval_{};   // Zero = no age limit
+    std::chrono::steady_clock::time_point log_file_opened_;
 };
 
-#define AP_LOG_TRACE(msg) ap::APLogger::instance().trace(msg)
-#define AP_LOG_DEBUG(msg) ap::APLogger::instance().debug(msg)
-#define AP_LOG_INFO(msg) ap::APLogger::instance().info(msg)
-#define AP_LOG_WARN(msg) ap::APLogger::instance().warn(msg)
-#define AP_LOG_ERROR(msg) ap::APLogger::instance().error(msg)
-#define AP_LOG_FATAL(msg) ap::APLogger::instance().fatal(msg)
-
-#define AP_LOG_TRACE_F(component, msg) ap::APLogger::instance().log(ap::LogLevel::Trace, component, msg)
-#define AP_LOG_DEBUG_F(component, msg) ap::APLogger::instance().log(ap::LogLevel::Debug, component, msg)
-#define AP_LOG_INFO_F(component, msg) ap::APLogger::instance().log(ap::LogLevel::Info, component, msg)
-#define AP_LOG_WARN_F(component, msg) ap::APLogger::instance().log(ap::LogLevel::Warn, component, msg)
-#define AP_LOG_ERROR_F(component, msg) ap::APLogger::instance().log(ap::LogLevel::Error, component, msg)
-#define AP_LOG_FATAL_F(component, msg) ap::APLogger::instance().log(ap::LogLevel::Fatal, component, msg)
+/**
+ * @brief Log the concatenation of the remaining arguments at `level`.
+ *
+ * The level is checked first; when it is disabled none of the message
+ * arguments are evaluated, so no strings are built or allocated:
+ *
+ *     AP_LOG(ap::LogLevel::Debug, "IPC message from ", client_id, ": ", msg.type);
+ */
+#define AP_LOG(level, ...) \
+    do { \
+        ap::APLogger& ap_log_instance = ap::APLogger::instance(); \
+        if (ap_log_instance.is_enabled(level)) { \
+            ap_log_instance.log(level, ap::log_concat(__VA_ARGS__)); \
+        } \
+    } while (0)
+
+/**
+ * @brief AP_LOG filtered by the level of an ap::LogComponent.
+ *
+ * The message is written as given; the AP_LOG_<LEVEL>_C wrappers prefix it
+ * with "[component] ".
+ */
+#define AP_LOG_C(level, component, ...) \
+    do { \
+        ap::APLogger& ap_log_instance = ap::APLogger::instance(); \
+        if (ap_log_instance.is_enabled(level, component)) { \
+            ap_log_instance.log(level, component, ap::log_concat(__VA_ARGS__)); \
+        } \
+    } while (0)
+
+// First argument of a non-empty list; the extra level of expansion keeps
+// MSVC's traditional preprocessor from passing __VA_ARGS__ as one argument
+#define AP_LOG_EXPAND_(x) x
+#define AP_LOG_FIRST_(...) AP_LOG_EXPAND_(AP_LOG_FIRST_IMPL_(__VA_ARGS__, ~))
+#define AP_LOG_FIRST_IMPL_(first, ...) first
+
+/**
+ * @brief Log a "{}" format string with raw arguments under an ap::LogComponent.
+ *
+ * The format is the first variadic argument and is registered once per call
+ * site. The record is filtered by the component's level. When the binary
+ * log is open the format ID and the encoded arguments are written to it:
+ *
+ *     AP_LOG_FMT(ap::LogLevel::Debug, ap::LogComponent::IPC, "Message from {}: {}", client_id, msg.type);
+ */
+#define AP_LOG_FMT(level, component, ...) \
+    do { \
+        ap::APLogger& ap_log_instance = ap::APLogger::instance(); \
+        if (ap_log_instance.is_enabled(level, component)) { \
+            static const uint32_t ap_log_format_id = \
+                ap_log_instance.register_format(component, AP_LOG_FIRST_(__VA_ARGS__)); \
+            ap_log_instance.log_format(level, component, ap_log_format_id, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define AP_LOG_TRACE(...) AP_LOG(ap::LogLevel::Trace, __VA_ARGS__)
+#define AP_LOG_DEBUG(...) AP_LOG(ap::LogLevel::Debug, __VA_ARGS__)
+#define AP_LOG_INFO(...) AP_LOG(ap::LogLevel::Info, __VA_ARGS__)
+#define AP_LOG_WARN(...) AP_LOG(ap::LogLevel::Warn, __VA_ARGS__)
+#define AP_LOG_ERROR(...) AP_LOG(ap::LogLevel::Error, __VA_ARGS__)
+#define AP_LOG_FATAL(...) AP_LOG(ap::LogLevel::Fatal, __VA_ARGS__)
+
+// "[component] message", filtered by the level of the ap::LogComponent
+#define AP_LOG_COMPONENT_(level, component, ...) \
+    AP_LOG_C(level, component, "[", ap::log_component_to_string(component), "] ", __VA_ARGS__)
+
+#define AP_LOG_TRACE_C(component, ...) AP_LOG_COMPONENT_(ap::LogLevel::Trace, component, __VA_ARGS__)
+#define AP_LOG_DEBUG_C(component, ...) AP_LOG_COMPONENT_(ap::LogLevel::Debug, component, __VA_ARGS__)
+#define AP_LOG_INFO_C(component, ...) AP_LOG_COMPONENT_(ap::LogLevel::Info, component, __VA_ARGS__)
+#define AP_LOG_WARN_C(component, ...) AP_LOG_COMPONENT_(ap::LogLevel::Warn, component, __VA_ARGS__)
+#define AP_LOG_ERROR_C(component, ...) AP_LOG_COMPONENT_(ap::LogLevel::Error, component, __VA_ARGS__)
+#define AP_LOG_FATAL_C(component, ...) AP_LOG_COMPONENT_(ap::LogLevel::Fatal, component, __VA_ARGS__)
 
 } // namespace ap
@@ -60,6 +60,8 @@ public:
      * @return Number of return values pushed to Lua stack.
      *
      * This starts the lifecycle state machine and returns a Lua module table.
+     * Mod discovery and capability generation continue on a worker thread;
+     * update() advances the lifecycle as each stage completes.
      */
     int init(lua_State* L);
 
@@ -94,6 +96,11 @@ public:
      * @param new_state Target state.
      * @param message Optional message for the transition.
      * @return true if transition was allowed.
+     *
+     * Allowed only if a row of the lifecycle transition table leads from the
+     * current state to new_state; that row is taken, action included. The
+     * game thread applies it immediately. Other threads queue it for the
+     * next update() and get true once it is queued.
      */
     bool transition_to(LifecycleState new_state, const std::string& message = "");
 
@@ -117,9 +124,13 @@ public:
      * @brief Register a mod with the framework.
      * @param mod_id Mod identifier.
      * @param version Mod version string.
-     * @return true if registration was accepted.
+     * @return true if registration was accepted, or queued for processing
+     *         when called off the game thread.
      *
-     * Called by client mods during REGISTRATION phase.
+     * Called by client mods during REGISTRATION phase. Calls from threads
+     * other than the game thread are queued for the next update(). Either
+     * way the mod is sent a REGISTRATION_RESPONSE, with success false and a
+     * reason if it was rejected.
      */
     bool register_mod(const std::string& mod_id, const std::string& version);
 
@@ -127,13 +138,17 @@ public:
      * @brief Register a priority client with the framework.
      * @param mod_id Mod identifier (must match pattern archipelago.<game>.*).
      * @param version Mod version string.
-     * @return true if registration was accepted.
+     * @return true if registration was accepted, or queued for processing
+     *         when called off the game thread (see register_mod()).
      */
     bool register_priority_client(const std::string& mod_id, const std::string& version);
 
     // ==========================================================================
     // Priority Client Commands
     // ==========================================================================
+    //
+    // Safe from any thread: calls from other threads are queued and run at
+    // the start of the next update() on the game thread.
 
     /**
      * @brief Restart the framework (from priority client).
@@ -5,12 +5,14 @@
 #include "ap_client.h"
 #include "ap_capabilities.h"
 #include "ap_state_manager.h"
+#include "message_queues.h"
 
 #include <string>
 #include <vector>
 #include <memory>
 #include <functional>
 #include <optional>
+#include <unordered_map>
 
 namespace ap {
 
@@ -116,6 +118,37 @@ public:
                                                     const std::string& item_name,
                                                     const std::string& sender_name);
 
+    /**
+     * @brief Route a batch of received items to their owning mods.
+     * @param items Items to route, in receive order.
+     * @param count Number of items.
+     * @param progression_counts Optional next progression count per item ID.
+     *        Pass the same map for every chunk of a batch that is routed over
+     *        several calls, so repeated items keep counting up.
+     * @param delivered Optional; set to the number of leading items that were
+     *        handed to IPC. Less than count when a send failed: the caller
+     *        should route that item and the rest again later rather than count
+     *        them as applied. Nothing more is sent after the failure, though
+     *        later items already sent to other mods are not taken back.
+     * @return PendingActions for every item that has an action to execute.
+     *
+     * Used for history replays and multi-item packets. Items are grouped per
+     * owning mod and each mod receives an EXECUTE_ACTIONS message whose
+     * payload holds an "actions" array, instead of one IPC round-trip per item.
+     * A mod's actions are split over several messages in order when they would
+     * not fit the IPC read buffer.
+     */
+    std::vector<PendingAction> route_item_receipts(
+        const ItemReceivedEvent* items, size_t count,
+        std::unordered_map<int64_t, int>* progression_counts = nullptr,
+        size_t* delivered = nullptr);
+
+    std::vector<PendingAction> route_item_receipts(
+        const std::vector<ItemReceivedEvent>& items,
+        std::unordered_map<int64_t, int>* progression_counts = nullptr) {
+        return route_item_receipts(items.data(), items.size(), progression_counts);
+    }
+
     /**
      * @brief Resolve arguments for an item action.
      * @param item Item ownership with action definition.
@@ -191,6 +224,13 @@ public:
      */
     void handle_action_result(const std::string& mod_id, const ActionResult& result);
 
+    /**
+     * @brief Handle a batched action result from a client mod.
+     * @param mod_id Source mod ID.
+     * @param results Results in the order the actions were sent.
+     */
+    void handle_action_results(const std::string& mod_id, const std::vector<ActionResult>& results);
+
     // ==========================================================================
     // Lifecycle & Error Broadcasting
     // ==========================================================================
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "ap_exports.h"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace ap {
+
+class APMetrics;
+struct MetricShard;
+
+// =============================================================================
+// Metric Handles
+// =============================================================================
+
+/**
+ * @brief Handle to a monotonic counter.
+ *
+ * Cheap to copy. add() writes to the calling thread's shard without locking,
+ * so it is safe and uncontended from any thread. A default-constructed handle
+ * (or one returned when the registry is full) ignores updates.
+ */
+class AP_API MetricCounter {
+public:
+    MetricCounter() = default;
+
+    void add(uint64_t value = 1) const;
+
+private:
+    friend class APMetrics;
+    explicit MetricCounter(uint32_t id) : id_(id) {}
+
+    uint32_t id_ = UINT32_MAX;
+};
+
+/**
+ * @brief Handle to a gauge (a value that goes up and down, e.g. a queue depth).
+ *
+ * Gauges are not sharded: the last set() wins, from whichever thread.
+ */
+class AP_API MetricGauge {
+public:
+    MetricGauge() = default;
+
+    void set(int64_t value) const {
+        if (cell_) cell_->store(value, std::memory_order_relaxed);
+    }
+
+    void add(int64_t delta) const {
+        if (cell_) cell_->fetch_add(delta, std::memory_order_relaxed);
+    }
+
+private:
+    friend class APMetrics;
+    explicit MetricGauge(std::atomic<int64_t>* cell) : cell_(cell) {}
+
+    std::atomic<int64_t>* cell_ = nullptr;
+};
+
+/**
+ * @brief Handle to a log-linear (HDR-style) histogram.
+ *
+ * Values are bucketed with 16 sub-buckets per power of two, so reported
+ * percentiles are within ~6% of the recorded value. Values above 2^36 are
+ * clamped. Durations are recorded in microseconds.
+ */
+class AP_API MetricHistogram {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    MetricHistogram() = default;
+
+    void record(uint64_t value) const;
+
+    void record_duration(Clock::duration duration) const {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        record(us > 0 ? static_cast<uint64_t>(us) : 0);
+    }
+
+    void record_since(Clock::time_point start) const {
+        record_duration(Clock::now() - start);
+    }
+
+private:
+    friend class APMetrics;
+    explicit MetricHistogram(uint32_t id) : id_(id) {}
+
+    uint32_t id_ = UINT32_MAX;
+};
+
+/**
+ * @brief Counters that share a prefix and differ by a runtime label
+ *        ("ipc.in.register", "ipc.in.log", ...).
+ *
+ * Caches the handle per label, so the registry is only consulted the first
+ * time a label is seen.
+ */
+class AP_API MetricCounterFamily {
+public:
+    explicit MetricCounterFamily(std::string prefix) : prefix_(std::move(prefix)) {}
+
+    void add(const std::string& label, uint64_t value = 1);
+
+private:
+    std::string prefix_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, MetricCounter> counters_;
+};
+
+// =============================================================================
+// Registry
+// =============================================================================
+
+/**
+ * @brief Process-wide registry of counters, gauges and histograms.
+ *
+ * Counters and histograms are written to thread-local shards and merged when
+ * a snapshot is taken, so hot paths never share a cache line or a lock. A
+ * shard outlives its thread and is reused by the next new thread, so totals
+ * survive thread restarts (polling thread reconnects, log rotation workers).
+ *
+ * Metrics are registered by name; registering the same name again returns
+ * the same metric. Look handles up once and keep them.
+ */
+class AP_API APMetrics {
+public:
+    static constexpr size_t MAX_COUNTERS = 256;
+    static constexpr size_t MAX_GAUGES = 64;
+    static constexpr size_t MAX_HISTOGRAMS = 16;
+
+    static APMetrics& instance();
+
+    MetricCounter counter(const std::string& name);
+    MetricGauge gauge(const std::string& name);
+    MetricHistogram histogram(const std::string& name);
+
+    /**
+     * @brief Merge all shards into one JSON document.
+     * @return {"counters": {...}, "gauges": {...}, "histograms": {name:
+     *         {"count", "sum", "mean", "max", "p50", "p90", "p99"}}}
+     */
+    nlohmann::json snapshot() const;
+
+private:
+    friend class MetricCounter;
+    friend class MetricHistogram;
+
+    class Impl;
+
+    /**
+     * @brief The calling thread's shard, acquired on first use.
+     */
+    static MetricShard& local_shard();
+
+    APMetrics();
+    ~APMetrics();
+
+    APMetrics(const APMetrics&) = delete;
+    APMetrics& operator=(const APMetrics&) = delete;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace ap
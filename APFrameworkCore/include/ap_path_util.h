@@ -99,6 +99,9 @@ public:
     static std::filesystem::path get_config_path();
     static std::filesystem::path get_session_state_path();
 
+    /** Data package cache folder (<output>/datapackage/) */
+    static std::filesystem::path get_data_package_cache_path();
+
     // =========================================================================
     // File Operations
     // =========================================================================
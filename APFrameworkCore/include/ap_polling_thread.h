@@ -4,6 +4,7 @@
 #include "ap_client.h"
 #include "stop_token.h"
 #include "message_queues.h"
+#include "polling_policy.h"
 
 #include <memory>
 #include <thread>
@@ -14,11 +15,15 @@ namespace ap {
 /**
  * @brief Background thread for polling the AP server.
  *
- * Runs APClient::poll() at a configurable interval and queues events
- * for processing on the main thread.
+ * Runs APClient::poll() and queues events for processing on the main thread.
  *
  * Thread model:
- * - Polling thread calls APClient::poll() at regular intervals
+ * - After a poll that handled packets, the thread re-polls immediately to
+ *   drain whatever is already buffered
+ * - Otherwise it blocks until woken (outgoing sends call wake()) or until the
+ *   interval chosen by its PollingPolicy elapses
+ * - Incoming packets cannot wake it: apclientpp exposes no socket readiness,
+ *   so a server message waits up to one interval
  * - Events from callbacks are queued in thread-safe queues
  * - Main thread retrieves events via get_events() or process_events()
  */
@@ -26,6 +31,10 @@ class AP_API APPollingThread {
 public:
     using EventHandler = std::function<void(const FrameworkEvent&)>;
 
+    // Returns false if the event was only partly handled and should be
+    // passed again, from the front of the queue, on the next call
+    using ResumableEventHandler = std::function<bool(const FrameworkEvent&)>;
+
     APPollingThread();
     ~APPollingThread();
 
@@ -38,7 +47,8 @@ public:
     /**
      * @brief Start the polling thread.
      * @param client AP client to poll.
-     * @param interval_ms Polling interval in milliseconds.
+     * @param interval_ms Fixed interval of the default config, used only if
+     *        no policy was set (the default policy is adaptive).
      * @return true if started successfully.
      */
     bool start(APClient* client, int interval_ms = 16);
@@ -58,7 +68,7 @@ public:
 
     /**
      * @brief Get all queued events.
-     * @return Vector of events.
+     * @return Vector of events (copies; prefer process_events()).
      *
      * Should be called from main thread.
      */
@@ -68,25 +78,73 @@ public:
      * @brief Process all queued events with handler.
      * @param handler Function to call for each event.
      *
-     * Should be called from main thread.
+     * Should be called from main thread. Events are passed by reference to
+     * their queue slot and are only valid during the handler call.
      */
     void process_events(EventHandler handler);
 
     /**
-     * @brief Set the polling interval.
+     * @brief Process queued events while @p keep_going returns true.
+     * @param handler Function to call for each event; returning false stops
+     *        and keeps that event queued (e.g. a batch routed in chunks).
+     * @param keep_going Checked before each event (e.g. a frame budget).
+     * @return Number of events fully processed; the rest stay queued in order.
+     *
+     * Should be called from main thread.
+     */
+    size_t process_events(ResumableEventHandler handler, const std::function<bool()>& keep_going);
+
+    /**
+     * @brief Wake the polling thread so it polls immediately.
+     *
+     * Thread-safe. APClient calls this after queueing an outgoing packet.
+     */
+    void wake();
+
+    /**
+     * @brief Drop the client's connection and open a new one without
+     *        stopping the thread.
+     * @param connect Run on the polling thread once the old connection is
+     *        dropped (nullptr only drops it).
+     *
+     * Thread-safe and non-blocking: the polling thread does the work between
+     * two polls, so the client is never used by two threads at once. It then
+     * queues a LifecycleEvent to CONNECTING ("Connection reset"); events
+     * queued before it came from the old connection.
+     */
+    void reset_connection(std::function<void(APClient&)> connect = nullptr);
+
+    /**
+     * @brief Replace the policy with a fixed polling interval.
      * @param interval_ms New interval in milliseconds.
      */
     void set_interval(int interval_ms);
 
     /**
-     * @brief Get the current polling interval.
+     * @brief Get the interval most recently chosen by the policy.
      * @return Interval in milliseconds.
      */
     int get_interval() const;
 
+    /**
+     * @brief Set the policy that decides the wait between polls.
+     * @param policy New policy (may be swapped while running).
+     */
+    void set_policy(std::unique_ptr<PollingPolicy> policy);
+
+    /**
+     * @brief Tell the policy which lifecycle state the framework is in.
+     * @param state Current lifecycle state.
+     *
+     * Thread-safe. Called by APManager on every transition.
+     */
+    void set_lifecycle_state(LifecycleState state);
+
     /**
      * @brief Get the event queue for direct access.
      * @return Reference to the event queue.
+     *
+     * The queue is single-consumer: only the main thread may pop from it.
      */
     EventQueue& get_event_queue();
 
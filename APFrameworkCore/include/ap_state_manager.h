@@ -10,6 +10,8 @@
 #include <memory>
 #include <optional>
 #include <cstdint>
+#include <chrono>
+#include <vector>
 
 namespace ap {
 
@@ -134,6 +136,41 @@ public:
      */
     void set_checked_locations(const std::set<int64_t>& locations);
 
+    // ==========================================================================
+    // Offline Location Checks
+    // ==========================================================================
+
+    /**
+     * @brief Queue location checks that could not be sent to the server.
+     * @param location_ids Location IDs (duplicates are merged).
+     *
+     * Persisted with the session state so checks survive a restart.
+     */
+    void add_pending_location_checks(const std::vector<int64_t>& location_ids);
+
+    /**
+     * @brief Get all queued location checks.
+     * @return Location IDs in ascending order.
+     */
+    std::vector<int64_t> get_pending_location_checks() const;
+
+    /**
+     * @brief Get number of queued location checks.
+     * @return Count of pending checks.
+     */
+    size_t get_pending_location_check_count() const;
+
+    /**
+     * @brief Get when the oldest pending check was queued.
+     * @return Queue time, or std::nullopt if nothing is pending.
+     */
+    std::optional<std::chrono::system_clock::time_point> get_pending_since() const;
+
+    /**
+     * @brief Drop all queued location checks (after they were sent).
+     */
+    void clear_pending_location_checks();
+
     // ==========================================================================
     // Item Progression Counts
     // ==========================================================================
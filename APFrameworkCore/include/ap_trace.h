@@ -0,0 +1,126 @@
+#pragma once
+
+#include "ap_exports.h"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace ap {
+
+struct TraceBuffer;
+
+/**
+ * @brief Records timed scopes per thread and exports them as a Chrome trace.
+ *
+ * Disabled by default; while disabled a ScopedTrace costs one relaxed load.
+ * Each thread writes complete events into its own ring buffer (the oldest
+ * events are overwritten once it is full), so tracing a frame hitch never
+ * waits on another thread. The export opens in chrome://tracing or
+ * ui.perfetto.dev, with one track per thread.
+ *
+ * Timestamps are steady_clock microseconds, so events recorded by another
+ * module in the same process (e.g. client mods reporting action timings)
+ * can be merged with record_external().
+ */
+class AP_API APTracer {
+public:
+    static constexpr size_t EVENTS_PER_THREAD = 16384;
+
+    static APTracer& instance();
+
+    bool is_enabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void set_enabled(bool enabled);
+
+    /**
+     * @brief Drop every recorded event.
+     */
+    void clear();
+
+    /**
+     * @brief Record a complete event on the calling thread's track.
+     * @param name Static string (string literal); it is stored by pointer.
+     */
+    void record(const char* name, int64_t start_us, int64_t duration_us);
+
+    /**
+     * @brief Record an event measured elsewhere on a named track.
+     * @param track Track name, e.g. "mod:archipelago.game.client".
+     */
+    void record_external(const std::string& track, const std::string& name,
+                         int64_t start_us, int64_t duration_us);
+
+    /**
+     * @brief Build the Chrome trace JSON ({"traceEvents": [...]}).
+     */
+    nlohmann::json export_chrome() const;
+
+    /**
+     * @brief Write the Chrome trace to a file.
+     * @return Number of events written, or -1 if the file could not be written.
+     */
+    long write_chrome_trace(const std::filesystem::path& path) const;
+
+    static int64_t now_us() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    class Impl;
+
+    /**
+     * @brief The calling thread's buffer, acquired on first use.
+     */
+    TraceBuffer& local_buffer();
+
+    APTracer();
+    ~APTracer();
+
+    APTracer(const APTracer&) = delete;
+    APTracer& operator=(const APTracer&) = delete;
+
+    std::atomic<bool> enabled_{false};
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Times the enclosing scope when tracing is enabled.
+ */
+class ScopedTrace {
+public:
+    explicit ScopedTrace(const char* name)
+        : name_(APTracer::instance().is_enabled() ? name : nullptr),
+          start_us_(name_ ? APTracer::now_us() : 0) {}
+
+    ~ScopedTrace() {
+        if (name_) {
+            APTracer::instance().record(name_, start_us_, APTracer::now_us() - start_us_);
+        }
+    }
+
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+private:
+    const char* name_;
+    int64_t start_us_;
+};
+
+} // namespace ap
+
+#define AP_TRACE_CONCAT_INNER(a, b) a##b
+#define AP_TRACE_CONCAT(a, b) AP_TRACE_CONCAT_INNER(a, b)
+
+/**
+ * @brief Trace the rest of the enclosing scope under a string-literal name.
+ */
+#define AP_TRACE_SCOPE(name) ::ap::ScopedTrace AP_TRACE_CONCAT(ap_trace_scope_, __LINE__)(name)
@@ -39,6 +39,22 @@ enum class LogLevel {
     Fatal = 5
 };
 
+/**
+ * @brief Subsystems whose log level can be set separately from the global one.
+ *
+ * Values index a fixed table in APLogger, so checks stay O(1).
+ */
+enum class LogComponent : uint8_t {
+    IPC = 0,
+    Router,
+    Capabilities,
+    Polling,
+    LuaClient,         // LOG messages sent by mods
+    None               // No component; follows the global level
+};
+
+constexpr size_t LOG_COMPONENT_COUNT = static_cast<size_t>(LogComponent::None);
+
 enum class ModType {
     Regular,
     Priority
@@ -118,6 +134,40 @@ inline std::string log_level_to_string(LogLevel level) {
     }
 }
 
+inline LogLevel log_level_from_string(const std::string& str, LogLevel fallback = LogLevel::Info) {
+    if (str == "trace" || str == "TRACE") return LogLevel::Trace;
+    if (str == "debug" || str == "DEBUG") return LogLevel::Debug;
+    if (str == "info" || str == "INFO") return LogLevel::Info;
+    if (str == "warn" || str == "WARN") return LogLevel::Warn;
+    if (str == "error" || str == "ERROR") return LogLevel::Error;
+    if (str == "fatal" || str == "FATAL") return LogLevel::Fatal;
+    return fallback;
+}
+
+inline const char* log_component_to_string(LogComponent component) {
+    switch (component) {
+        case LogComponent::IPC: return "IPC";
+        case LogComponent::Router: return "Router";
+        case LogComponent::Capabilities: return "Capabilities";
+        case LogComponent::Polling: return "Polling";
+        case LogComponent::LuaClient: return "LuaClient";
+        default: return "";
+    }
+}
+
+/**
+ * @brief Case-sensitive lookup by name; unknown names map to LogComponent::None.
+ */
+inline LogComponent log_component_from_string(const std::string& str) {
+    for (size_t i = 0; i < LOG_COMPONENT_COUNT; ++i) {
+        auto component = static_cast<LogComponent>(i);
+        if (str == log_component_to_string(component)) {
+            return component;
+        }
+    }
+    return LogComponent::None;
+}
+
 inline std::string item_type_to_string(ItemType type) {
     switch (type) {
         case ItemType::Progression: return "progression";
@@ -302,6 +352,8 @@ struct SessionState {
     std::string game_name;
     int received_item_index = 0;
     std::set<int64_t> checked_locations;
+    std::set<int64_t> pending_location_checks;     // Checked while offline, not yet sent
+    std::chrono::system_clock::time_point pending_since;
     std::map<int64_t, int> item_progression_counts;
     std::string ap_server;
     int ap_port = 38281;
@@ -309,6 +361,7 @@ struct SessionState {
 
     nlohmann::json to_json() const {
         std::vector<int64_t> checked_vec(checked_locations.begin(), checked_locations.end());
+        std::vector<int64_t> pending_vec(pending_location_checks.begin(), pending_location_checks.end());
         nlohmann::json progression_counts = nlohmann::json::object();
         for (const auto& [id, count] : item_progression_counts) {
             progression_counts[std::to_string(id)] = count;
@@ -323,6 +376,8 @@ struct SessionState {
             {"game_name", game_name},
             {"received_item_index", received_item_index},
             {"checked_locations", checked_vec},
+            {"pending_location_checks", pending_vec},
+            {"pending_since", std::chrono::system_clock::to_time_t(pending_since)},
             {"item_progression_counts", progression_counts},
             {"ap_server", ap_server},
             {"ap_port", ap_port},
@@ -344,6 +399,16 @@ struct SessionState {
             }
         }
 
+        if (j.contains("pending_location_checks") && j["pending_location_checks"].is_array()) {
+            for (const auto& loc : j["pending_location_checks"]) {
+                state.pending_location_checks.insert(loc.get<int64_t>());
+            }
+        }
+
+        if (j.contains("pending_since")) {
+            state.pending_since = std::chrono::system_clock::from_time_t(j["pending_since"].get<std::time_t>());
+        }
+
         if (j.contains("item_progression_counts") && j["item_progression_counts"].is_object()) {
             for (const auto& [key, val] : j["item_progression_counts"].items()) {
                 state.item_progression_counts[std::stoll(key)] = val.get<int>();
@@ -454,13 +519,37 @@ struct RetryConfig {
     int initial_delay_ms = 1000;
     double backoff_multiplier = 2.0;
     int max_delay_ms = 10000;
+    double jitter = 0.2;                   // +/- fraction applied to reconnect delays
 };
 
 struct ThreadingConfig {
-    int polling_interval_ms = 16;
+    int polling_interval_ms = 16;          // Poll interval when adaptive polling is off
+    bool adaptive_polling = true;
+    int polling_min_interval_ms = 4;       // Cadence during traffic and handshakes
+    int polling_idle_interval_ms = 100;    // Adaptive ceiling once idle
+    double polling_backoff_multiplier = 1.5;
     int ipc_poll_interval_ms = 10;
     int queue_max_size = 1000;
     int shutdown_timeout_ms = 5000;
+    int update_budget_us = 2000;           // Main-thread time per update for bulk work; 0 = unlimited
+    int update_item_chunk = 250;           // Received items routed between budget checks
+};
+
+struct LoggingConfig {
+    bool async = true;                     // Background writer instead of writing on the caller
+    int queue_size = 8192;                 // Records buffered before producers wait (or drop)
+    int flush_interval_ms = 200;           // Max time buffered output stays unflushed
+    LogLevel flush_level = LogLevel::Warn; // Records at/above this level are flushed immediately
+    bool drop_when_full = false;           // Drop instead of waiting when the queue is full
+    std::string binary_file;               // Binary log next to the text log; empty = off
+    int memory_entries = 2000;             // Recent entries kept for get_logs; 0 = off
+    int max_file_size_mb = 50;             // Rotate the text log at this size; 0 = no limit
+    int rotate_interval_hours = 0;         // Also rotate after this long; 0 = off
+    int max_rotated_files = 5;             // Rotated logs kept (oldest deleted first)
+    bool compress_rotated = true;          // Gzip rotated logs in the background
+    std::map<std::string, LogLevel> component_levels;   // Per-component overrides ("IPC": trace)
+    int metrics_interval_s = 0;            // Log a metrics snapshot this often; 0 = off
+    bool trace_enabled = false;            // Record scoped-timer traces from startup
 };
 
 struct APServerConfig {
@@ -469,6 +558,7 @@ struct APServerConfig {
     std::string slot_name;
     std::string password;
     bool auto_reconnect = true;
+    int reconnect_max_attempts = -1;       // Attempts before ERROR_STATE (-1 = unlimited)
 };
 
 struct FrameworkConfig {
@@ -477,6 +567,7 @@ struct FrameworkConfig {
     LogLevel log_level = LogLevel::Info;
     std::string log_file = "ap_framework.log";
     bool log_to_console = true;
+    LoggingConfig logging;
     TimeoutConfig timeouts;
     RetryConfig retry;
     ThreadingConfig threading;
@@ -491,6 +582,7 @@ namespace IPCMessageType {
     // Framework -> Client
     constexpr const char* AP_MESSAGE = "ap_message";
     constexpr const char* EXECUTE_ACTION = "execute_action";
+    constexpr const char* EXECUTE_ACTIONS = "execute_actions";
     constexpr const char* LIFECYCLE = "lifecycle";
     constexpr const char* ERROR_MSG = "error";  // Note: ERROR conflicts with Windows macro
     constexpr const char* REGISTRATION_RESPONSE = "registration_response";
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace ap::binary_log {
+
+// =============================================================================
+// File Format
+// =============================================================================
+//
+// A binary log starts with FILE_MAGIC and FILE_VERSION (uint16), followed by
+// a stream of entries. Each entry starts with one tag byte. All integers are
+// little-endian, as written by the x86/x64 hosts the framework runs on.
+//
+//   TAG_COMPONENT  uint16 id, uint16 length, name bytes
+//   TAG_THREAD     uint8 id, uint16 length, name bytes
+//   TAG_FORMAT     uint32 id, uint16 component id, uint16 length, format bytes
+//   TAG_RECORD     int64 time (us since epoch), uint8 level, uint8 thread,
+//                  uint16 component, uint32 format id, uint16 args length,
+//                  encoded arguments
+//
+// Definitions are written before the first record that uses them. Format
+// strings use "{}" placeholders, which are filled in order by the arguments.
+// Format ID 0 is the implicit "{}", used for plain text messages.
+
+constexpr char FILE_MAGIC[4] = {'A', 'P', 'L', 'B'};
+constexpr uint16_t FILE_VERSION = 1;
+
+constexpr uint8_t TAG_COMPONENT = 'C';
+constexpr uint8_t TAG_THREAD = 'T';
+constexpr uint8_t TAG_FORMAT = 'F';
+constexpr uint8_t TAG_RECORD = 'R';
+
+constexpr uint32_t PLAIN_FORMAT_ID = 0;
+constexpr uint16_t NO_COMPONENT_ID = 0;
+
+// Argument type tags
+constexpr uint8_t ARG_INT = 'i';       // int64
+constexpr uint8_t ARG_UINT = 'u';      // uint64
+constexpr uint8_t ARG_DOUBLE = 'd';    // double
+constexpr uint8_t ARG_BOOL = 'b';      // uint8
+constexpr uint8_t ARG_STRING = 's';    // uint16 length, bytes
+
+constexpr size_t MAX_FIELD_LENGTH = 0xFFFF;
+
+template <typename T>
+void append_raw(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+/**
+ * @brief Append a uint16 length and the bytes (truncated to 64 KiB).
+ */
+inline void append_string(std::string& out, std::string_view value) {
+    size_t length = value.size() < MAX_FIELD_LENGTH ? value.size() : MAX_FIELD_LENGTH;
+    append_raw<uint16_t>(out, static_cast<uint16_t>(length));
+    out.append(value.data(), length);
+}
+
+// =============================================================================
+// Argument Encoding
+// =============================================================================
+
+inline void encode_arg(std::string& out, std::string_view value) {
+    out.push_back(static_cast<char>(ARG_STRING));
+    append_string(out, value);
+}
+
+inline void encode_arg(std::string& out, const char* value) {
+    encode_arg(out, std::string_view(value ? value : "(null)"));
+}
+
+inline void encode_arg(std::string& out, char value) {
+    encode_arg(out, std::string_view(&value, 1));
+}
+
+inline void encode_arg(std::string& out, bool value) {
+    out.push_back(static_cast<char>(ARG_BOOL));
+    out.push_back(value ? 1 : 0);
+}
+
+template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+void encode_arg(std::string& out, T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        out.push_back(static_cast<char>(ARG_DOUBLE));
+        append_raw<double>(out, static_cast<double>(value));
+    } else if constexpr (std::is_signed_v<T>) {
+        out.push_back(static_cast<char>(ARG_INT));
+        append_raw<int64_t>(out, static_cast<int64_t>(value));
+    } else {
+        out.push_back(static_cast<char>(ARG_UINT));
+        append_raw<uint64_t>(out, static_cast<uint64_t>(value));
+    }
+}
+
+template <typename... Args>
+void encode_args(std::string& out, const Args&... args) {
+    (encode_arg(out, args), ...);
+}
+
+// =============================================================================
+// Decoding
+// =============================================================================
+
+/**
+ * @brief Bounds-checked cursor over an encoded buffer.
+ */
+class Reader {
+public:
+    Reader(const char* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    bool read(T& value) {
+        if (size_ - pos_ < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    bool read_string(std::string_view& value) {
+        uint16_t length = 0;
+        if (!read(length) || size_ - pos_ < length) {
+            return false;
+        }
+        value = std::string_view(data_ + pos_, length);
+        pos_ += length;
+        return true;
+    }
+
+    bool done() const { return pos_ >= size_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+/**
+ * @brief Append one decoded argument as text.
+ * @return false if the buffer is truncated or the type tag is unknown.
+ */
+inline bool append_decoded_arg(std::string& out, Reader& reader) {
+    uint8_t type = 0;
+    if (!reader.read(type)) {
+        return false;
+    }
+
+    switch (type) {
+        case ARG_INT: {
+            int64_t value = 0;
+            if (!reader.read(value)) return false;
+            out.append(std::to_string(value));
+            return true;
+        }
+        case ARG_UINT: {
+            uint64_t value = 0;
+            if (!reader.read(value)) return false;
+            out.append(std::to_string(value));
+            return true;
+        }
+        case ARG_DOUBLE: {
+            double value = 0.0;
+            if (!reader.read(value)) return false;
+            out.append(std::to_string(value));
+            return true;
+        }
+        case ARG_BOOL: {
+            uint8_t value = 0;
+            if (!reader.read(value)) return false;
+            out.append(value ? "true" : "false");
+            return true;
+        }
+        case ARG_STRING: {
+            std::string_view value;
+            if (!reader.read_string(value)) return false;
+            out.append(value);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Fill the "{}" placeholders of `format` with encoded arguments.
+ *
+ * Missing arguments leave "{}" in place; extra arguments are appended,
+ * separated by spaces, so nothing recorded is lost.
+ */
+inline std::string format_message(std::string_view format, const char* args, size_t args_size) {
+    std::string out;
+    out.reserve(format.size() + args_size);
+    Reader reader(args, args_size);
+
+    size_t pos = 0;
+    while (pos < format.size()) {
+        size_t brace = format.find("{}", pos);
+        if (brace == std::string_view::npos) {
+            out.append(format.substr(pos));
+            break;
+        }
+        out.append(format.substr(pos, brace - pos));
+        if (reader.done() || !append_decoded_arg(out, reader)) {
+            out.append("{}");
+        }
+        pos = brace + 2;
+    }
+
+    while (!reader.done()) {
+        out.push_back(' ');
+        if (!append_decoded_arg(out, reader)) {
+            out.append("<corrupt>");
+            break;
+        }
+    }
+    return out;
+}
+
+} // namespace ap::binary_log
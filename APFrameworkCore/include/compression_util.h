@@ -0,0 +1,33 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace ap {
+
+/**
+ * @brief zlib helpers for payloads sent over IPC.
+ */
+class CompressionUtil {
+public:
+    /**
+     * @brief Compress `data` as a zlib stream (RFC 1950).
+     * @param level zlib level, 1 (fastest) to 9 (smallest).
+     * @return false if zlib fails; `out` is then left empty.
+     */
+    static bool zlib_compress(const std::string& data, std::string& out, int level = 6);
+
+    /**
+     * @brief Standard base64 (RFC 4648, with padding), for binary data in JSON.
+     */
+    static std::string base64_encode(const std::string& data);
+
+    /**
+     * @brief Gzip `source` into `destination` in 64 KiB chunks.
+     * @return false on any read/write error; a partial destination is removed.
+     */
+    static bool gzip_file(const std::filesystem::path& source,
+                          const std::filesystem::path& destination, int level = 6);
+};
+
+} // namespace ap
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+namespace ap {
+
+/**
+ * @brief On-disk cache of AP data package entries, one file per game.
+ *
+ * Each game is stored as <game>_<checksum>.apdp in MessagePack form. On
+ * connect the cached games are handed to apclientpp, which compares their
+ * checksums with the server's RoomInfo and only downloads games whose
+ * checksum changed; those are then written back via store().
+ *
+ * Not thread-safe; owned and used by a single APClient.
+ */
+class DataPackageCache {
+public:
+    /**
+     * @brief Construct a cache rooted at a folder (created on first store).
+     * @param folder Directory holding the .apdp files.
+     */
+    explicit DataPackageCache(std::filesystem::path folder);
+
+    /**
+     * @brief Load every cached game.
+     * @return Data package JSON ({"games": {name: {...}}}); empty games if none.
+     *
+     * Unreadable or malformed files, and files superseded by a newer checksum
+     * for the same game, are logged and deleted; none of them throw.
+     */
+    nlohmann::json load_all();
+
+    /**
+     * @brief Persist games whose checksum is not cached yet.
+     * @param data_package Data package JSON ({"games": {name: {...}}}).
+     * @return Number of games written.
+     *
+     * Games without a checksum cannot be validated later and are skipped.
+     */
+    size_t store(const nlohmann::json& data_package);
+
+    const std::filesystem::path& folder() const { return folder_; }
+
+private:
+    std::filesystem::path path_for(const std::string& game, const std::string& checksum) const;
+    void remove_file(const std::filesystem::path& path);
+
+    std::filesystem::path folder_;
+
+    // Game name -> (checksum, file) for the games known to be on disk
+    struct CachedGame {
+        std::string checksum;
+        std::filesystem::path path;
+    };
+    std::unordered_map<std::string, CachedGame> cached_;
+};
+
+} // namespace ap
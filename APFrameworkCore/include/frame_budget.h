@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+
+namespace ap {
+
+/**
+ * @brief Time allowance for the work done in one APManager::update().
+ *
+ * Bulk work calls has_time() between units and leaves the rest for the next
+ * update. Once the deadline has passed the budget stays spent, so later
+ * stages of the same update do not start new work. A zero budget never runs
+ * out.
+ */
+class FrameBudget {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FrameBudget(std::chrono::microseconds budget)
+        : started_(Clock::now()),
+          deadline_(budget.count() > 0 ? started_ + budget : Clock::time_point::max()) {}
+
+    /**
+     * @brief Whether there is time left for another unit of work.
+     */
+    bool has_time() {
+        if (!spent_ && deadline_ != Clock::time_point::max() && Clock::now() >= deadline_) {
+            spent_ = true;
+        }
+        return !spent_;
+    }
+
+    /**
+     * @brief Whether has_time() has returned false during this update.
+     */
+    bool spent() const {
+        return spent_;
+    }
+
+    std::chrono::microseconds elapsed() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - started_);
+    }
+
+private:
+    Clock::time_point started_;
+    Clock::time_point deadline_;
+    bool spent_ = false;
+};
+
+} // namespace ap
@@ -1,11 +1,14 @@
 #pragma once
 
 #include "thread_safe_queue.h"
+#include "recycling_queue.h"
 #include "ap_types.h"
 
+#include <chrono>
 #include <string>
 #include <functional>
 #include <variant>
+#include <vector>
 
 namespace ap {
 
@@ -36,6 +39,18 @@ struct ItemReceivedEvent {
     std::string sender;
     int64_t location_id;
     bool is_self;  // true if item was sent by this player
+    int index = -1;  // Position in the slot's received items list (-1 if unknown)
+    std::chrono::steady_clock::time_point received_at{};  // When the polling thread queued it
+};
+
+/**
+ * @brief Event dispatched when a ReceivedItems packet carries several items.
+ *
+ * The AP server replays the entire received-items history when a slot
+ * connects, so these batches are handled in bulk on the main thread.
+ */
+struct ItemBatchReceivedEvent {
+    std::vector<ItemReceivedEvent> items;
 };
 
 /**
@@ -81,6 +96,7 @@ struct APMessageEvent {
  */
 using FrameworkEvent = std::variant<
     ItemReceivedEvent,
+    ItemBatchReceivedEvent,
     LocationScoutEvent,
     LifecycleEvent,
     ErrorEvent,
@@ -89,8 +105,15 @@ using FrameworkEvent = std::variant<
 
 /**
  * @brief Queue for events to be dispatched on main thread.
- */
-using EventQueue = ThreadSafeQueue<FrameworkEvent>;
+ *
+ * Single producer (polling thread), single consumer (main thread), so this
+ * is a lock-free ring. Overflow spills to a locked list rather than dropping
+ * events, since losing an item event would desync the slot. Slots recycle
+ * their payload strings and the main thread reads (and routes items) in
+ * place, so steady-state event flow does not allocate on either side
+ * (measured per thread by benchmarks/event_queue_bench.cpp).
+ */
+using EventQueue = RecyclingQueue<FrameworkEvent>;
 
 // =============================================================================
 // Callback Types
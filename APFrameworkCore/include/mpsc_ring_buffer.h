@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ap {
+
+/**
+ * @brief Bounded lock-free multi-producer / single-consumer ring buffer.
+ *
+ * Each slot carries a sequence number (Vyukov's bounded queue): producers
+ * claim a slot with one CAS on the tail and publish it by bumping the slot's
+ * sequence, so producers never block each other or the consumer.
+ *
+ * Slots are filled and consumed in place and never destroyed, so values
+ * that own heap storage (strings, vectors) keep their capacity across laps.
+ *
+ * @tparam T Default-constructible element type.
+ */
+template <typename T>
+class MPSCRingBuffer {
+public:
+    /**
+     * @brief Construct a ring buffer.
+     * @param capacity Number of slots (rounded up to a power of two).
+     */
+    explicit MPSCRingBuffer(size_t capacity = 8192)
+        : capacity_(round_up_pow2(capacity)),
+          mask_(capacity_ - 1),
+          cells_(std::make_unique<Cell[]>(capacity_)) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCRingBuffer(const MPSCRingBuffer&) = delete;
+    MPSCRingBuffer& operator=(const MPSCRingBuffer&) = delete;
+
+    /**
+     * @brief Fill the next free slot in place (any thread).
+     * @param fill Callable invoked as fill(T&); must overwrite every field.
+     * @return false if the ring is full (nothing is written).
+     */
+    template <typename Fill>
+    bool try_emplace_with(Fill&& fill) {
+        Cell* cell = nullptr;
+        size_t pos = tail_.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(cell->value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Visit every published slot in place (consumer only).
+     * @param visit Callable invoked as visit(T&).
+     * @return Number of elements visited.
+     *
+     * Stops at the first slot a producer has claimed but not yet published,
+     * so FIFO order is preserved.
+     */
+    template <typename Visit>
+    size_t consume_all(Visit&& visit) {
+        size_t count = 0;
+        for (;;) {
+            Cell& cell = cells_[head_ & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            if (seq != head_ + 1) {
+                break;
+            }
+
+            visit(cell.value);
+            cell.sequence.store(head_ + capacity_, std::memory_order_release);
+            ++head_;
+            ++count;
+        }
+        if (count > 0) {
+            consumed_.store(head_, std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Approximate number of queued elements (any thread).
+     */
+    size_t size_approx() const {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = consumed_.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : 0;
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    static size_t round_up_pow2(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) size_t head_ = 0;              // Consumer-private
+    std::atomic<size_t> consumed_{0};          // head_ published for size_approx()
+};
+
+} // namespace ap
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ap {
+
+/**
+ * @brief ID/name pair pointing into a NameCache's interned storage.
+ */
+struct NameEntry {
+    int64_t id = 0;
+    std::string_view name;
+};
+
+/**
+ * @brief ID-sorted, contiguous table of names.
+ *
+ * entries() gives direct access to the underlying array, so callers can
+ * walk or binary-search it without building any strings.
+ */
+class NameTable {
+public:
+    /**
+     * @brief Replace the table contents (sorted by ID internally).
+     */
+    void assign(std::vector<NameEntry> entries);
+
+    /**
+     * @brief Look up a name by ID.
+     * @return The interned name, or an empty view if unknown.
+     */
+    std::string_view find(int64_t id) const;
+
+    const std::vector<NameEntry>& entries() const { return entries_; }
+    const NameEntry* begin() const { return entries_.data(); }
+    const NameEntry* end() const { return entries_.data() + entries_.size(); }
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+private:
+    std::vector<NameEntry> entries_;
+};
+
+/**
+ * @brief Item and location names for one game.
+ */
+struct GameNames {
+    NameTable items;
+    NameTable locations;
+};
+
+/**
+ * @brief Per-slot player names.
+ */
+struct PlayerNames {
+    int slot = 0;
+    std::string_view alias;
+    std::string_view game;
+};
+
+/**
+ * @brief Immutable snapshot of every name in the multiworld.
+ *
+ * Built from the AP data package plus the room's player list. All names are
+ * interned: each distinct string is stored once in the snapshot and handed
+ * out as a std::string_view that stays valid as long as the snapshot lives.
+ * Share snapshots via std::shared_ptr<const NameCache>.
+ */
+class NameCache {
+public:
+    /**
+     * @brief Input describing one player in the room.
+     */
+    struct Player {
+        int slot = 0;
+        std::string alias;
+        std::string game;
+    };
+
+    /**
+     * @brief Build a snapshot.
+     * @param data_package Data package JSON ({"games": {name: {...}}}).
+     * @param players Players in the room.
+     * @return New snapshot.
+     */
+    static std::shared_ptr<const NameCache> build(const nlohmann::json& data_package,
+                                                  const std::vector<Player>& players);
+
+    /**
+     * @brief Build a snapshot reusing another snapshot's game tables.
+     *
+     * Player aliases change far more often than the data package, so this
+     * avoids re-interning every item and location name.
+     */
+    static std::shared_ptr<const NameCache> with_players(const std::shared_ptr<const NameCache>& base,
+                                                         const std::vector<Player>& players);
+
+    /**
+     * @brief Get the name tables for a game.
+     * @return Pointer to the tables, or nullptr if the game is unknown.
+     */
+    const GameNames* game(std::string_view game_name) const;
+
+    std::string_view item_name(std::string_view game_name, int64_t item_id) const;
+    std::string_view location_name(std::string_view game_name, int64_t location_id) const;
+
+    /**
+     * @brief Look up a player by slot.
+     * @return Pointer to the player entry, or nullptr if unknown.
+     */
+    const PlayerNames* player(int slot) const;
+
+    /**
+     * @brief All players, sorted by slot.
+     */
+    const std::vector<PlayerNames>& players() const { return players_->entries; }
+
+    size_t game_count() const;
+
+private:
+    struct StringPool {
+        std::string_view intern(std::string_view value);
+        std::unordered_set<std::string> strings;
+    };
+
+    struct GameTables {
+        StringPool pool;
+        std::unordered_map<std::string_view, GameNames> games;
+    };
+
+    struct PlayerTable {
+        StringPool pool;
+        std::vector<PlayerNames> entries;
+    };
+
+    static std::shared_ptr<const PlayerTable> build_players(const std::vector<Player>& players);
+
+    std::shared_ptr<const GameTables> games_ = std::make_shared<GameTables>();
+    std::shared_ptr<const PlayerTable> players_ = std::make_shared<PlayerTable>();
+};
+
+} // namespace ap
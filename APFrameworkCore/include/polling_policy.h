@@ -0,0 +1,143 @@
+#pragma once
+
+#include "ap_types.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace ap {
+
+/**
+ * @brief Decides how long the polling thread waits between AP polls.
+ *
+ * next_interval() is called from the polling thread after every poll.
+ * current_interval() may be called from any thread for diagnostics.
+ */
+class PollingPolicy {
+public:
+    virtual ~PollingPolicy() = default;
+
+    /**
+     * @brief Compute the wait before the next poll.
+     * @param had_activity true if the last poll handled server traffic.
+     * @param state Current framework lifecycle state.
+     * @return Time to wait (the thread still wakes early for outgoing sends).
+     */
+    virtual std::chrono::milliseconds next_interval(bool had_activity, LifecycleState state) = 0;
+
+    /**
+     * @brief Get the most recently chosen interval.
+     * @return Current interval.
+     */
+    virtual std::chrono::milliseconds current_interval() const = 0;
+};
+
+/**
+ * @brief Always waits the same interval (the pre-adaptive behaviour).
+ */
+class FixedPollingPolicy : public PollingPolicy {
+public:
+    explicit FixedPollingPolicy(int interval_ms) : interval_ms_(std::max(1, interval_ms)) {}
+
+    std::chrono::milliseconds next_interval(bool, LifecycleState) override {
+        return std::chrono::milliseconds(interval_ms_);
+    }
+
+    std::chrono::milliseconds current_interval() const override {
+        return std::chrono::milliseconds(interval_ms_);
+    }
+
+private:
+    int interval_ms_;
+};
+
+/**
+ * @brief Polls tightly while busy and backs off while idle.
+ *
+ * - Traffic, or a handshake state (CONNECTING, SYNCING), pins the interval
+ *   to min_interval_ms.
+ * - For activity_linger_ms after the last traffic the interval stays at
+ *   min_interval_ms, since replies and follow-up prints arrive in bursts.
+ * - After that the interval grows by backoff_multiplier per idle poll up to
+ *   max_interval_ms.
+ *
+ * RESYNCING is not a handshake state: most of it is spent waiting out
+ * reconnect delays, and each attempt's traffic pins the interval anyway.
+ *
+ * Incoming packets cannot wake the thread, so max_interval_ms is what an
+ * unprompted server message (an item sent by another player) waits at most.
+ * It trades that latency for background CPU (polling_idle_interval_ms).
+ */
+class AdaptivePollingPolicy : public PollingPolicy {
+public:
+    struct Settings {
+        int min_interval_ms = 4;
+        int max_interval_ms = 100;
+        double backoff_multiplier = 1.5;
+        int activity_linger_ms = 250;
+    };
+
+    explicit AdaptivePollingPolicy(const Settings& settings)
+        : settings_(normalize(settings)),
+          current_ms_(settings_.min_interval_ms) {}
+
+    std::chrono::milliseconds next_interval(bool had_activity, LifecycleState state) override {
+        auto now = std::chrono::steady_clock::now();
+        if (had_activity) {
+            last_activity_ = now;
+        }
+
+        int next;
+        if (had_activity || is_handshake_state(state) ||
+            now - last_activity_ < std::chrono::milliseconds(settings_.activity_linger_ms)) {
+            next = settings_.min_interval_ms;
+        } else {
+            next = std::min(settings_.max_interval_ms,
+                std::max(current_ms_ + 1,
+                    static_cast<int>(current_ms_ * settings_.backoff_multiplier)));
+        }
+
+        current_ms_ = next;
+        return std::chrono::milliseconds(next);
+    }
+
+    std::chrono::milliseconds current_interval() const override {
+        return std::chrono::milliseconds(current_ms_.load());
+    }
+
+private:
+    static bool is_handshake_state(LifecycleState state) {
+        return state == LifecycleState::CONNECTING ||
+               state == LifecycleState::SYNCING;
+    }
+
+    static Settings normalize(Settings s) {
+        s.max_interval_ms = std::max(1, s.max_interval_ms);
+        s.min_interval_ms = std::clamp(s.min_interval_ms, 1, s.max_interval_ms);
+        s.backoff_multiplier = std::max(1.0, s.backoff_multiplier);
+        return s;
+    }
+
+    const Settings settings_;
+    std::atomic<int> current_ms_;
+    std::chrono::steady_clock::time_point last_activity_{};
+};
+
+/**
+ * @brief Create the polling policy described by the threading config.
+ */
+inline std::unique_ptr<PollingPolicy> make_polling_policy(const ThreadingConfig& config) {
+    if (!config.adaptive_polling) {
+        return std::make_unique<FixedPollingPolicy>(config.polling_interval_ms);
+    }
+
+    AdaptivePollingPolicy::Settings settings;
+    settings.min_interval_ms = config.polling_min_interval_ms;
+    settings.max_interval_ms = config.polling_idle_interval_ms;
+    settings.backoff_multiplier = config.polling_backoff_multiplier;
+    return std::make_unique<AdaptivePollingPolicy>(settings);
+}
+
+} // namespace ap
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "spsc_ring_buffer.h"
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace ap {
+
+/**
+ * @brief Ring slot that keeps warm storage for every alternative of a variant.
+ *
+ * When a slot is reused for a different alternative, the current alternative
+ * is parked in a per-type spare and the new one is moved in from its spare,
+ * so string and container members keep their heap buffers instead of being
+ * freed and reallocated.
+ */
+template <typename Variant>
+class RecyclingSlot;
+
+template <typename... Ts>
+class RecyclingSlot<std::variant<Ts...>> {
+public:
+    using Variant = std::variant<Ts...>;
+
+    /**
+     * @brief Switch the slot to alternative E, reusing its previous storage.
+     * @return Reference to the (stale) E; the caller must overwrite every field.
+     */
+    template <typename E>
+    E& reuse_as() {
+        if (auto* current = std::get_if<E>(&value_)) {
+            return *current;
+        }
+        park();
+        return value_.template emplace<E>(std::move(std::get<E>(spares_)));
+    }
+
+    /**
+     * @brief Replace the slot's value (no buffer reuse for the new value).
+     */
+    void assign(Variant&& value) {
+        park();
+        value_ = std::move(value);
+    }
+
+    const Variant& get() const {
+        return value_;
+    }
+
+private:
+    void park() {
+        std::visit([this](auto& current) {
+            using C = std::decay_t<decltype(current)>;
+            std::get<C>(spares_) = std::move(current);
+        }, value_);
+    }
+
+    Variant value_;
+    std::tuple<Ts...> spares_;
+};
+
+/**
+ * @brief SPSC queue of variant events whose payload storage is recycled.
+ *
+ * The producer fills slots in place with emplace<E>() and the consumer
+ * reads them in place with consume_all(), so in steady state no payload is
+ * allocated by the producer or freed by the consumer.
+ *
+ * @tparam Variant A std::variant of default-constructible event types.
+ */
+template <typename Variant>
+class RecyclingQueue {
+public:
+    /**
+     * @brief Construct a queue.
+     * @param capacity Number of recycled slots (rounded up to a power of two).
+     */
+    explicit RecyclingQueue(size_t capacity = 256)
+        : ring_(capacity, OverflowPolicy::Spill) {}
+
+    /**
+     * @brief Fill the next slot as alternative E (producer only).
+     * @param fill Callable invoked as fill(E&); must overwrite every field.
+     */
+    template <typename E, typename Fill>
+    bool emplace(Fill&& fill) {
+        return ring_.emplace_with([&fill](RecyclingSlot<Variant>& slot) {
+            fill(slot.template reuse_as<E>());
+        });
+    }
+
+    /**
+     * @brief Push a fully built event (producer only, no buffer reuse).
+     */
+    bool push(Variant event) {
+        return ring_.emplace_with([&event](RecyclingSlot<Variant>& slot) {
+            slot.assign(std::move(event));
+        });
+    }
+
+    /**
+     * @brief Visit every queued event in place (consumer only).
+     * @param handler Callable invoked as handler(const Variant&).
+     * @return Number of events visited.
+     *
+     * References are only valid for the duration of the handler call.
+     */
+    template <typename Handler>
+    size_t consume_all(Handler&& handler) {
+        return ring_.consume_all([&handler](RecyclingSlot<Variant>& slot) {
+            handler(slot.get());
+        });
+    }
+
+    /**
+     * @brief Visit queued events in place until @p keep_going returns false
+     *        (consumer only).
+     * @param handler Callable invoked as handler(const Variant&). May return
+     *        bool; false keeps a partly handled event at the front.
+     * @param keep_going Callable checked before each event.
+     * @return Number of events released; the rest stay queued in order.
+     */
+    template <typename Handler, typename Predicate>
+    size_t consume_while(Handler&& handler, Predicate&& keep_going) {
+        return ring_.consume_while([&handler](RecyclingSlot<Variant>& slot) {
+            return handler(slot.get());
+        }, keep_going);
+    }
+
+    /**
+     * @brief Copy out all queued events (consumer only).
+     * @return Vector of events in FIFO order.
+     */
+    std::vector<Variant> pop_all() {
+        std::vector<Variant> events;
+        consume_all([&events](const Variant& event) {
+            events.push_back(event);
+        });
+        return events;
+    }
+
+    bool empty() const {
+        return ring_.empty();
+    }
+
+    size_t size() const {
+        return ring_.size();
+    }
+
+    /**
+     * @brief Discard all queued events (consumer only).
+     */
+    void clear() {
+        consume_all([](const Variant&) {});
+    }
+
+private:
+    SPSCRingBuffer<RecyclingSlot<Variant>> ring_;
+};
+
+} // namespace ap
@@ -7,6 +7,8 @@
 #include <chrono>
 #include <thread>
 #include <optional>
+#include <random>
+#include <algorithm>
 
 namespace ap {
 
@@ -18,6 +20,7 @@ struct RetryPolicy {
     int initial_delay_ms = 1000;
     double backoff_multiplier = 2.0;
     int max_delay_ms = 10000;
+    double jitter = 0.0;            // +/- fraction of each delay (BackoffSchedule only)
 
     /**
      * @brief Create from RetryConfig.
@@ -27,11 +30,80 @@ struct RetryPolicy {
             config.max_retries,
             config.initial_delay_ms,
             config.backoff_multiplier,
-            config.max_delay_ms
+            config.max_delay_ms,
+            config.jitter
         };
     }
 };
 
+/**
+ * @brief Non-blocking exponential backoff with jitter.
+ *
+ * Unlike retry_with_backoff(), nothing sleeps here: schedule() only returns
+ * the delay, and the caller runs the attempt from its own timer (e.g. a
+ * TimerQueue driven once per frame), so retries never stall its thread.
+ *
+ * A negative policy.max_retries means retry forever.
+ */
+class BackoffSchedule {
+public:
+    explicit BackoffSchedule(RetryPolicy policy = {})
+        : policy_(policy), rng_(std::random_device{}()) {
+        reset();
+    }
+
+    /**
+     * @brief Forget previous attempts (call after a success).
+     */
+    void reset() {
+        attempts_ = 0;
+        next_delay_ms_ = policy_.initial_delay_ms;
+    }
+
+    /**
+     * @brief Compute the delay before the next attempt.
+     * @return The jittered delay, or std::nullopt if the retry budget is spent.
+     */
+    std::optional<std::chrono::milliseconds> schedule() {
+        if (exhausted()) {
+            return std::nullopt;
+        }
+
+        double delay = next_delay_ms_;
+        if (policy_.jitter > 0.0) {
+            std::uniform_real_distribution<double> spread(-policy_.jitter, policy_.jitter);
+            delay *= 1.0 + spread(rng_);
+        }
+        auto delay_ms = std::chrono::milliseconds(static_cast<int64_t>(std::max(delay, 0.0)));
+
+        next_delay_ms_ = std::min(static_cast<int>(next_delay_ms_ * policy_.backoff_multiplier),
+                                  policy_.max_delay_ms);
+        return delay_ms;
+    }
+
+    /**
+     * @brief Count an attempt as started.
+     * @return 1-based attempt number.
+     */
+    int begin_attempt() {
+        return ++attempts_;
+    }
+
+    int attempts() const { return attempts_; }
+
+    bool exhausted() const {
+        return policy_.max_retries >= 0 && attempts_ >= policy_.max_retries;
+    }
+
+    const RetryPolicy& policy() const { return policy_; }
+
+private:
+    RetryPolicy policy_;
+    std::mt19937 rng_;
+    int attempts_ = 0;
+    int next_delay_ms_ = 0;
+};
+
 /**
  * @brief Result of a retry operation.
  */
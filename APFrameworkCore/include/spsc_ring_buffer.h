@@ -0,0 +1,426 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <optional>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace ap {
+
+/**
+ * @brief What SPSCRingBuffer does when the ring is full.
+ */
+enum class OverflowPolicy {
+    DropNewest,  // Reject the push and count it as dropped
+    Spill        // Move to a mutex-protected overflow list; nothing is lost
+};
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer ring buffer.
+ *
+ * Intended for one producer thread handing work to one consumer thread
+ * (e.g. polling thread -> main thread). push() must only be called from
+ * the producer and try_pop()/pop_all()/clear() only from the consumer.
+ *
+ * While the ring has space, push and pop are wait-free (two atomic indices,
+ * no mutex, no condition variable). Under OverflowPolicy::Spill, a full ring
+ * diverts pushes to an overflow list until the consumer drains it, which
+ * keeps FIFO order without ever dropping elements.
+ *
+ * @tparam T Element type. Must be default-constructible and move-assignable.
+ */
+template <typename T>
+class SPSCRingBuffer {
+public:
+    /**
+     * @brief Construct a ring buffer.
+     * @param capacity Minimum number of slots (rounded up to a power of two).
+     * @param policy Behaviour when the ring is full.
+     */
+    explicit SPSCRingBuffer(size_t capacity = 1024,
+                            OverflowPolicy policy = OverflowPolicy::Spill)
+        : slots_(round_up_pow2(capacity)),
+          mask_(slots_.size() - 1),
+          policy_(policy) {}
+
+    // Delete copy/move operations (indices are shared between threads)
+    SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+    SPSCRingBuffer& operator=(const SPSCRingBuffer&) = delete;
+    SPSCRingBuffer(SPSCRingBuffer&&) = delete;
+    SPSCRingBuffer& operator=(SPSCRingBuffer&&) = delete;
+
+    /**
+     * @brief Push an element (producer only).
+     * @param item Item to push.
+     * @return true if queued, false if dropped by OverflowPolicy::DropNewest.
+     */
+    bool push(const T& item) {
+        T copy(item);
+        return push(std::move(copy));
+    }
+
+    /**
+     * @brief Push an element (producer only, move version).
+     * @param item Item to push.
+     * @return true if queued, false if dropped by OverflowPolicy::DropNewest.
+     */
+    bool push(T&& item) {
+        if (!spilling_.load(std::memory_order_acquire) && try_push_ring(item)) {
+            return true;
+        }
+
+        if (policy_ == OverflowPolicy::DropNewest) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        // The consumer may have drained the overflow since the check above
+        if (!spilling_.load(std::memory_order_relaxed) && try_push_ring(item)) {
+            return true;
+        }
+        overflow_.push_back(std::move(item));
+        spilling_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Construct an element in place in the next free slot (producer only).
+     * @param fill Callable invoked as fill(T&) on the reused slot.
+     * @return true if queued, false if dropped by OverflowPolicy::DropNewest.
+     *
+     * The slot still holds whatever the consumer left in it, so @p fill must
+     * overwrite every field. Reusing slots this way lets element members keep
+     * their heap capacity across pushes.
+     */
+    template <typename Fill>
+    bool emplace_with(Fill&& fill) {
+        if (!spilling_.load(std::memory_order_acquire) && try_fill_ring(fill)) {
+            return true;
+        }
+
+        if (policy_ == OverflowPolicy::DropNewest) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        if (!spilling_.load(std::memory_order_relaxed) && try_fill_ring(fill)) {
+            return true;
+        }
+        fill(overflow_.emplace_back());
+        spilling_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Visit and release every queued element in place (consumer only).
+     * @param visit Callable invoked as visit(T&) for each element in FIFO order.
+     * @return Number of elements visited.
+     *
+     * Elements are never moved out of their slots, so nothing is freed on the
+     * consumer thread; the producer overwrites the slot on its next pass.
+     * Each ring slot is released as soon as its visit returns.
+     */
+    template <typename Visitor>
+    size_t consume_all(Visitor&& visit) {
+        // Every element is released here, whatever the visitor returns
+        auto visit_all = [&visit](T& item) { visit(item); };
+        size_t count = visit_carried(visit_all, [] { return true; });
+
+        std::vector<T> spilled;
+        size_t tail = tail_.load(std::memory_order_acquire);
+
+        if (spilling_.load(std::memory_order_acquire)) {
+            // Snapshot the ring under the lock: everything up to this tail
+            // predates everything in the overflow list
+            std::lock_guard<std::mutex> lock(overflow_mutex_);
+            tail = tail_.load(std::memory_order_acquire);
+            spilled.swap(overflow_);
+            spilling_.store(false, std::memory_order_release);
+        }
+
+        for (size_t head = head_.load(std::memory_order_relaxed); head != tail; ++head) {
+            visit(slots_[head & mask_]);
+            head_.store(head + 1, std::memory_order_release);
+            ++count;
+        }
+        for (auto& item : spilled) {
+            visit(item);
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Visit queued elements in place until @p keep_going returns false
+     *        (consumer only).
+     * @param visit Callable invoked as visit(T&) for each element in FIFO order.
+     *        If it returns bool, false means the element is only partly
+     *        handled: it stays at the front and the call returns.
+     * @param keep_going Callable checked before each element.
+     * @return Number of elements released; the rest stay queued in order.
+     *
+     * Used to spread a backlog over several frames, down to part of a single
+     * element. The overflow list is only taken once the ring is empty; any of
+     * it left unvisited is kept aside and visited first on the next call.
+     */
+    template <typename Visitor, typename Predicate>
+    size_t consume_while(Visitor&& visit, Predicate&& keep_going) {
+        size_t count = visit_carried(visit, keep_going);
+        if (carried_head_ < carried_.size()) {
+            return count;
+        }
+
+        for (;;) {
+            size_t tail = tail_.load(std::memory_order_acquire);
+            for (size_t head = head_.load(std::memory_order_relaxed); head != tail; ++head) {
+                if (!keep_going() || !release_after(visit, slots_[head & mask_])) {
+                    return count;
+                }
+                head_.store(head + 1, std::memory_order_release);
+                ++count;
+            }
+
+            if (!spilling_.load(std::memory_order_acquire)) {
+                return count;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(overflow_mutex_);
+                if (tail_.load(std::memory_order_acquire) != tail) {
+                    continue;  // Pushed to the ring before the spill began
+                }
+                carried_.swap(overflow_);
+                carried_count_.store(carried_.size(), std::memory_order_relaxed);
+                spilling_.store(false, std::memory_order_release);
+            }
+            return count + visit_carried(visit, keep_going);
+        }
+    }
+
+    /**
+     * @brief Try to pop the oldest element (consumer only).
+     * @return The element if available, std::nullopt otherwise.
+     */
+    std::optional<T> try_pop() {
+        if (carried_head_ < carried_.size()) {
+            T item = std::move(carried_[carried_head_++]);
+            release_carried();
+            return item;
+        }
+
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head != tail_.load(std::memory_order_acquire)) {
+            T item = std::move(slots_[head & mask_]);
+            head_.store(head + 1, std::memory_order_release);
+            return item;
+        }
+
+        if (!spilling_.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+
+        // Ring is empty, so the overflow list holds the oldest elements
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        if (overflow_.empty()) {
+            return std::nullopt;
+        }
+        T item = std::move(overflow_.front());
+        overflow_.erase(overflow_.begin());
+        if (overflow_.empty()) {
+            spilling_.store(false, std::memory_order_release);
+        }
+        return item;
+    }
+
+    /**
+     * @brief Pop all available elements (consumer only).
+     * @return Vector of all elements in FIFO order.
+     */
+    std::vector<T> pop_all() {
+        std::vector<T> items;
+        pop_all(items);
+        return items;
+    }
+
+    /**
+     * @brief Pop all available elements into a caller-owned buffer (consumer only).
+     * @param items Receives the elements; its previous contents are discarded.
+     *
+     * Reusing the same buffer every frame keeps its capacity and avoids
+     * reallocating on steady traffic.
+     */
+    void pop_all(std::vector<T>& items) {
+        items.clear();
+        for (; carried_head_ < carried_.size(); ++carried_head_) {
+            items.push_back(std::move(carried_[carried_head_]));
+        }
+        release_carried();
+
+        if (!spilling_.load(std::memory_order_acquire)) {
+            drain_ring(items);
+            return;
+        }
+
+        // Hold the overflow lock so the producer cannot spill mid-drain;
+        // everything in the ring predates everything in the overflow list
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        drain_ring(items);
+        items.reserve(items.size() + overflow_.size());
+        for (auto& item : overflow_) {
+            items.push_back(std::move(item));
+        }
+        overflow_.clear();
+        spilling_.store(false, std::memory_order_release);
+    }
+
+    /**
+     * @brief Check if the buffer is empty (approximate while producing).
+     * @return true if empty.
+     */
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Get the number of queued elements (approximate while producing).
+     * @return Number of elements in the ring plus the overflow list.
+     */
+    size_t size() const {
+        size_t count = tail_.load(std::memory_order_acquire) -
+                       head_.load(std::memory_order_acquire) +
+                       carried_count_.load(std::memory_order_relaxed);
+        if (spilling_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(overflow_mutex_);
+            count += overflow_.size();
+        }
+        return count;
+    }
+
+    /**
+     * @brief Discard all queued elements (consumer only).
+     */
+    void clear() {
+        pop_all();
+    }
+
+    /**
+     * @brief Get the number of ring slots.
+     * @return Capacity of the lock-free ring.
+     */
+    size_t capacity() const {
+        return slots_.size();
+    }
+
+    /**
+     * @brief Get the number of elements rejected by OverflowPolicy::DropNewest.
+     * @return Dropped element count.
+     */
+    size_t dropped_count() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static size_t round_up_pow2(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    bool try_push_ring(T& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename Fill>
+    bool try_fill_ring(Fill& fill) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) {
+                return false;
+            }
+        }
+        fill(slots_[tail & mask_]);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Visit overflow elements left over by an interrupted consume_while()
+    template <typename Visitor, typename Predicate>
+    size_t visit_carried(Visitor& visit, Predicate&& keep_going) {
+        size_t count = 0;
+        while (carried_head_ < carried_.size() && keep_going() &&
+               release_after(visit, carried_[carried_head_])) {
+            ++carried_head_;
+            ++count;
+        }
+        release_carried();
+        return count;
+    }
+
+    // Visit one element; false if the visitor asked to keep it queued
+    template <typename Visitor>
+    static bool release_after(Visitor& visit, T& item) {
+        if constexpr (std::is_same_v<std::invoke_result_t<Visitor&, T&>, bool>) {
+            return visit(item);
+        } else {
+            visit(item);
+            return true;
+        }
+    }
+
+    void release_carried() {
+        if (carried_head_ == carried_.size()) {
+            carried_.clear();
+            carried_head_ = 0;
+        }
+        carried_count_.store(carried_.size() - carried_head_, std::memory_order_relaxed);
+    }
+
+    void drain_ring(std::vector<T>& items) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        items.reserve(items.size() + (tail - head));
+        for (; head != tail; ++head) {
+            items.push_back(std::move(slots_[head & mask_]));
+        }
+        head_.store(head, std::memory_order_release);
+    }
+
+    std::vector<T> slots_;
+    const size_t mask_;
+    const OverflowPolicy policy_;
+
+    // Producer and consumer indices live on separate cache lines
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;  // Producer's last view of head_
+
+    alignas(64) std::atomic<bool> spilling_{false};
+    mutable std::mutex overflow_mutex_;
+    std::vector<T> overflow_;
+    std::atomic<size_t> dropped_{0};
+
+    // Overflow elements taken by consume_while() but not yet visited; they
+    // predate everything in the ring (consumer only, except the count)
+    std::vector<T> carried_;
+    size_t carried_head_ = 0;
+    std::atomic<size_t> carried_count_{0};
+};
+
+} // namespace ap
@@ -1,10 +1,12 @@
 #pragma once
 
-#include <queue>
+#include <vector>
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include <optional>
 #include <chrono>
+#include <utility>
 
 namespace ap {
 
@@ -13,6 +15,10 @@ namespace ap {
  *
  * Provides blocking and non-blocking operations for producer-consumer patterns.
  *
+ * Elements live in a vector with a read offset, so pop_all() hands the whole
+ * buffer to the consumer with an O(1) swap instead of moving elements one at
+ * a time under the lock.
+ *
  * @tparam T Type of elements stored in the queue.
  */
 template <typename T>
@@ -32,7 +38,8 @@ public:
     // Allow move operations
     ThreadSafeQueue(ThreadSafeQueue&& other) noexcept {
         std::lock_guard<std::mutex> lock(other.mutex_);
-        queue_ = std::move(other.queue_);
+        buffer_ = std::move(other.buffer_);
+        head_ = std::exchange(other.head_, 0);
         max_size_ = other.max_size_;
         shutdown_ = other.shutdown_.load();
     }
@@ -40,7 +47,8 @@ public:
     ThreadSafeQueue& operator=(ThreadSafeQueue&& other) noexcept {
         if (this != &other) {
             std::scoped_lock lock(mutex_, other.mutex_);
-            queue_ = std::move(other.queue_);
+            buffer_ = std::move(other.buffer_);
+            head_ = std::exchange(other.head_, 0);
             max_size_ = other.max_size_;
             shutdown_ = other.shutdown_.load();
         }
@@ -58,10 +66,11 @@ public:
             if (shutdown_) {
                 return false;
             }
-            if (max_size_ > 0 && queue_.size() >= max_size_) {
+            if (max_size_ > 0 && count() >= max_size_) {
                 return false;
             }
-            queue_.push(item);
+            compact();
+            buffer_.push_back(item);
         }
         cv_.notify_one();
         return true;
@@ -78,10 +87,11 @@ public:
             if (shutdown_) {
                 return false;
             }
-            if (max_size_ > 0 && queue_.size() >= max_size_) {
+            if (max_size_ > 0 && count() >= max_size_) {
                 return false;
             }
-            queue_.push(std::move(item));
+            compact();
+            buffer_.push_back(std::move(item));
         }
         cv_.notify_one();
         return true;
@@ -93,12 +103,10 @@ public:
      */
     std::optional<T> try_pop() {
         std::lock_guard<std::mutex> lock(mutex_);
-        if (queue_.empty()) {
+        if (count() == 0) {
             return std::nullopt;
         }
-        T item = std::move(queue_.front());
-        queue_.pop();
-        return item;
+        return take_front();
     }
 
     /**
@@ -107,15 +115,13 @@ public:
      */
     std::optional<T> pop() {
         std::unique_lock<std::mutex> lock(mutex_);
-        cv_.wait(lock, [this] { return !queue_.empty() || shutdown_; });
+        cv_.wait(lock, [this] { return count() > 0 || shutdown_; });
 
-        if (shutdown_ && queue_.empty()) {
+        if (shutdown_ && count() == 0) {
             return std::nullopt;
         }
 
-        T item = std::move(queue_.front());
-        queue_.pop();
-        return item;
+        return take_front();
     }
 
     /**
@@ -126,17 +132,15 @@ public:
     template <typename Rep, typename Period>
     std::optional<T> pop_for(const std::chrono::duration<Rep, Period>& timeout) {
         std::unique_lock<std::mutex> lock(mutex_);
-        if (!cv_.wait_for(lock, timeout, [this] { return !queue_.empty() || shutdown_; })) {
+        if (!cv_.wait_for(lock, timeout, [this] { return count() > 0 || shutdown_; })) {
             return std::nullopt;  // Timeout
         }
 
-        if (shutdown_ && queue_.empty()) {
+        if (shutdown_ && count() == 0) {
             return std::nullopt;
         }
 
-        T item = std::move(queue_.front());
-        queue_.pop();
-        return item;
+        return take_front();
     }
 
     /**
@@ -145,13 +149,27 @@ public:
      */
     std::vector<T> pop_all() {
         std::vector<T> items;
+        pop_all(items);
+        return items;
+    }
+
+    /**
+     * @brief Pop all available elements into a caller-owned buffer.
+     * @param out Receives the elements; its previous contents are discarded.
+     *
+     * The queue's buffer and @p out are swapped under the lock, so producers
+     * are blocked for O(1) and the queue keeps @p out's capacity for the next
+     * round of pushes. Reusing the same @p out every frame avoids reallocating.
+     */
+    void pop_all(std::vector<T>& out) {
+        out.clear();
         std::lock_guard<std::mutex> lock(mutex_);
-        items.reserve(queue_.size());
-        while (!queue_.empty()) {
-            items.push_back(std::move(queue_.front()));
-            queue_.pop();
+        if (head_ > 0) {
+            // A partial try_pop() left consumed slots at the front
+            buffer_.erase(buffer_.begin(), buffer_.begin() + head_);
+            head_ = 0;
         }
-        return items;
+        buffer_.swap(out);
     }
 
     /**
@@ -160,7 +178,7 @@ public:
      */
     bool empty() const {
         std::lock_guard<std::mutex> lock(mutex_);
-        return queue_.empty();
+        return count() == 0;
     }
 
     /**
@@ -169,7 +187,7 @@ public:
      */
     size_t size() const {
         std::lock_guard<std::mutex> lock(mutex_);
-        return queue_.size();
+        return count();
     }
 
     /**
@@ -177,8 +195,8 @@ public:
      */
     void clear() {
         std::lock_guard<std::mutex> lock(mutex_);
-        std::queue<T> empty;
-        std::swap(queue_, empty);
+        buffer_.clear();
+        head_ = 0;
     }
 
     /**
@@ -209,14 +227,37 @@ public:
     void reset() {
         std::lock_guard<std::mutex> lock(mutex_);
         shutdown_ = false;
-        std::queue<T> empty;
-        std::swap(queue_, empty);
+        buffer_.clear();
+        head_ = 0;
     }
 
 private:
+    // Callers must hold mutex_
+    size_t count() const {
+        return buffer_.size() - head_;
+    }
+
+    T take_front() {
+        T item = std::move(buffer_[head_++]);
+        if (head_ == buffer_.size()) {
+            buffer_.clear();
+            head_ = 0;
+        }
+        return item;
+    }
+
+    void compact() {
+        // Reclaim slots consumed by try_pop()/pop() once they dominate the buffer
+        if (head_ > 32 && head_ * 2 >= buffer_.size()) {
+            buffer_.erase(buffer_.begin(), buffer_.begin() + head_);
+            head_ = 0;
+        }
+    }
+
     mutable std::mutex mutex_;
     std::condition_variable cv_;
-    std::queue<T> queue_;
+    std::vector<T> buffer_;
+    size_t head_ = 0;  // Index of the oldest element in buffer_
     size_t max_size_;
     std::atomic<bool> shutdown_;
 };
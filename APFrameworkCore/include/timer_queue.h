@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace ap {
+
+/**
+ * @brief Deadline timers driven by the thread that owns them.
+ *
+ * Nothing runs in the background: the owner calls run_due() (e.g. once per
+ * update) and every timer whose deadline has passed fires, earliest first.
+ * Checking for due timers costs one comparison against the earliest
+ * deadline, however many are armed. Not thread-safe.
+ *
+ * Callbacks may schedule or cancel timers, including clear().
+ */
+class TimerQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimerId = uint64_t;
+
+    /**
+     * @brief Arm a timer.
+     * @return Id for cancel(); never 0, so 0 can mean "no timer".
+     */
+    TimerId schedule(Clock::time_point deadline, std::function<void()> callback) {
+        TimerId id = next_id_++;
+        callbacks_.emplace(id, std::move(callback));
+        deadlines_.push({deadline, id});
+        return id;
+    }
+
+    template<typename Rep, typename Period>
+    TimerId schedule_after(std::chrono::duration<Rep, Period> delay, std::function<void()> callback) {
+        return schedule(Clock::now() + std::chrono::duration_cast<Clock::duration>(delay),
+                        std::move(callback));
+    }
+
+    /**
+     * @brief Disarm a timer.
+     * @return false if it already fired or was cancelled.
+     */
+    bool cancel(TimerId id) {
+        return callbacks_.erase(id) > 0;
+    }
+
+    /**
+     * @brief Disarm every timer.
+     */
+    void clear() {
+        callbacks_.clear();
+        deadlines_ = {};
+    }
+
+    /**
+     * @brief Fire every timer that is due.
+     * @return Number of timers fired.
+     */
+    size_t run_due(Clock::time_point now = Clock::now()) {
+        size_t fired = 0;
+        while (!deadlines_.empty() && deadlines_.top().deadline <= now) {
+            TimerId id = deadlines_.top().id;
+            deadlines_.pop();
+
+            // Cancelled timers leave their deadline behind; skip it here
+            auto it = callbacks_.find(id);
+            if (it == callbacks_.end()) {
+                continue;
+            }
+            auto callback = std::move(it->second);
+            callbacks_.erase(it);
+
+            callback();
+            ++fired;
+        }
+        return fired;
+    }
+
+    /**
+     * @brief Earliest deadline of an armed timer.
+     */
+    std::optional<Clock::time_point> next_deadline() {
+        while (!deadlines_.empty() && callbacks_.count(deadlines_.top().id) == 0) {
+            deadlines_.pop();
+        }
+        if (deadlines_.empty()) {
+            return std::nullopt;
+        }
+        return deadlines_.top().deadline;
+    }
+
+    size_t size() const {
+        return callbacks_.size();
+    }
+
+private:
+    struct Entry {
+        Clock::time_point deadline;
+        TimerId id;
+
+        // Earliest deadline on top; equal deadlines fire in scheduling order
+        bool operator>(const Entry& other) const {
+            return deadline != other.deadline ? deadline > other.deadline : id > other.id;
+        }
+    };
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> deadlines_;
+    std::unordered_map<TimerId, std::function<void()>> callbacks_;
+    TimerId next_id_ = 1;
+};
+
+} // namespace ap
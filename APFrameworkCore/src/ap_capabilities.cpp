@@ -267,9 +267,8 @@ public:
             item.item_id = current_id++;
         }
 
-        APLogger::instance().log(LogLevel::Info,
-            "Assigned IDs: " + std::to_string(locations_.size()) + " locations, " +
-            std::to_string(items_.size()) + " items, base=" + std::to_string(base_id));
+        AP_LOG_INFO_C(LogComponent::Capabilities, "Assigned IDs: ", locations_.size(), " locations, ",
+                      items_.size(), " items, base=", base_id);
     }
 
     int64_t get_location_id(const std::string& mod_id,
@@ -423,7 +422,7 @@ public:
                                                             const std::string& game_name) const {
         auto output_folder = APPathUtil::find_output_folder();
         if (!output_folder) {
-            APLogger::instance().log(LogLevel::Error,
+            AP_LOG_ERROR_C(LogComponent::Capabilities,
                 "Could not find output folder for capabilities config");
             return {};
         }
@@ -432,8 +431,7 @@ public:
         auto output_path = *output_folder / filename;
 
         if (write_capabilities_config(output_path, slot_name, game_name)) {
-            APLogger::instance().log(LogLevel::Info,
-                "Wrote capabilities config: " + output_path.string());
+            AP_LOG_INFO_C(LogComponent::Capabilities, "Wrote capabilities config: ", output_path.string());
             return output_path;
         }
 
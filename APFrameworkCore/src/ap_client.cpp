@@ -1,5 +1,7 @@
 #include "ap_client.h"
 #include "ap_logger.h"
+#include "name_cache.h"
+#include "data_package_cache.h"
 
 #include <apclient.hpp>
 #include <mutex>
@@ -25,6 +27,7 @@ public:
 
     bool connect(const std::string& server, int port,
                  const std::string& game, const std::string& uuid) {
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
         if (client_) {
             disconnect();
         }
@@ -40,15 +43,14 @@ public:
 
             // Set up callbacks
             setup_callbacks();
+            load_cached_data_package();
 
-            APLogger::instance().log(LogLevel::Info,
-                "AP Client connecting to: " + uri);
+            AP_LOG_INFO("AP Client connecting to: ", uri);
 
             return true;
 
         } catch (const std::exception& e) {
-            APLogger::instance().log(LogLevel::Error,
-                "Failed to create AP client: " + std::string(e.what()));
+            AP_LOG_ERROR("Failed to create AP client: ", e.what());
             return false;
         }
     }
@@ -56,6 +58,7 @@ public:
     bool connect_slot(const std::string& slot_name,
                       const std::string& password,
                       int items_handling) {
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
         if (!client_) {
             return false;
         }
@@ -66,20 +69,20 @@ public:
         try {
             // Items handling: 0x1 = remote_items, 0x2 = remote_items_all, 0x4 = receive_own_world
             client_->ConnectSlot(slot_name, password, items_handling, {"Lua"}, {0, 5, 0});
+            notify_wake();
 
-            APLogger::instance().log(LogLevel::Info,
-                "Connecting to slot: " + slot_name);
+            AP_LOG_INFO("Connecting to slot: ", slot_name);
 
             return true;
 
         } catch (const std::exception& e) {
-            APLogger::instance().log(LogLevel::Error,
-                "Failed to connect slot: " + std::string(e.what()));
+            AP_LOG_ERROR("Failed to connect slot: ", e.what());
             return false;
         }
     }
 
     void disconnect() {
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
         if (client_) {
             client_.reset();
         }
@@ -88,6 +91,7 @@ public:
     }
 
     bool is_connected() const {
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
         return client_ && client_->get_state() != APClientLib::State::DISCONNECTED;
     }
 
@@ -95,36 +99,56 @@ public:
         return slot_connected_;
     }
 
-    void poll() {
-        if (client_) {
-            client_->poll();
+    bool poll() {
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
+        if (!client_) {
+            return false;
         }
+
+        auto state_before = client_->get_state();
+        uint64_t activity_before = activity_;
+
+        client_->poll();
+
+        return activity_ != activity_before || client_->get_state() != state_before;
     }
 
-    void send_location_checks(const std::vector<int64_t>& location_ids) {
-        if (client_ && slot_connected_) {
-            std::list<int64_t> ids_list(location_ids.begin(), location_ids.end());
-            client_->LocationChecks(ids_list);
+    bool send_location_checks(const std::vector<int64_t>& location_ids) {
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
+        if (!client_ || !slot_connected_) {
+            return false;
+        }
+        std::list<int64_t> ids_list(location_ids.begin(), location_ids.end());
+        if (!client_->LocationChecks(ids_list)) {
+            return false;
         }
+        notify_wake();
+        return true;
     }
 
     void send_location_scouts(const std::vector<int64_t>& location_ids,
                               bool create_as_hint) {
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
         if (client_ && slot_connected_) {
             std::list<int64_t> ids_list(location_ids.begin(), location_ids.end());
             client_->LocationScouts(ids_list, create_as_hint ? 2 : 0);
+            notify_wake();
         }
     }
 
     void send_status_update(ClientStatus status) {
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
         if (client_ && slot_connected_) {
             client_->StatusUpdate(static_cast<APClientLib::ClientStatus>(status));
+            notify_wake();
         }
     }
 
     void send_say(const std::string& message) {
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
         if (client_ && slot_connected_) {
             client_->Say(message);
+            notify_wake();
         }
     }
 
@@ -132,19 +156,28 @@ public:
                      const std::vector<int>& slots,
                      const std::vector<std::string>& tags,
                      const nlohmann::json& data) {
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
         if (client_ && slot_connected_) {
             std::list<std::string> games_list(games.begin(), games.end());
             std::list<int> slots_list(slots.begin(), slots.end());
             std::list<std::string> tags_list(tags.begin(), tags.end());
             client_->Bounce(data, games_list, slots_list, tags_list);
+            notify_wake();
         }
     }
 
     std::optional<SlotInfo> get_slot_info() const {
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
         return slot_info_;
     }
 
     std::string get_location_name(int64_t location_id) const {
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
+        auto names = get_name_cache();
+        auto cached = names->location_name(game_, location_id);
+        if (!cached.empty()) {
+            return std::string(cached);
+        }
         if (client_) {
             return client_->get_location_name(location_id, game_);
         }
@@ -152,20 +185,22 @@ public:
     }
 
     std::string get_item_name(int64_t item_id) const {
-        if (client_) {
-            return client_->get_item_name(item_id, game_);
-        }
-        return "";
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
+        return lookup_item_name(*get_name_cache(), game_, item_id);
     }
 
     std::string get_player_name(int player_id) const {
-        if (client_) {
-            return client_->get_player_alias(player_id);
-        }
-        return "";
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
+        return lookup_player_name(*get_name_cache(), player_id);
+    }
+
+    std::shared_ptr<const NameCache> get_name_cache() const {
+        std::lock_guard<std::mutex> lock(name_cache_mutex_);
+        return name_cache_;
     }
 
     int get_player_number() const {
+        std::lock_guard<std::recursive_mutex> lock(client_mutex_);
         if (client_) {
             return client_->get_player_number();
         }
@@ -194,6 +229,10 @@ public:
         item_received_callback_ = std::move(callback);
     }
 
+    void set_items_received_callback(ItemsReceivedCallback callback) {
+        items_received_callback_ = std::move(callback);
+    }
+
     void set_location_scouted_callback(LocationScoutedCallback callback) {
         location_scouted_callback_ = std::move(callback);
     }
@@ -214,13 +253,93 @@ public:
         bounced_callback_ = std::move(callback);
     }
 
+    void set_wake_callback(WakeCallback callback) {
+        wake_callback_ = std::move(callback);
+    }
+
+    void set_data_package_cache_folder(const std::filesystem::path& folder) {
+        data_package_cache_ = std::make_unique<DataPackageCache>(folder);
+    }
+
 private:
+    // Cache first; apclientpp's own lookups only for names the cache lacks
+    std::string lookup_item_name(const NameCache& names, const std::string& game, int64_t item_id) const {
+        auto cached = names.item_name(game, item_id);
+        if (!cached.empty()) {
+            return std::string(cached);
+        }
+        if (client_) {
+            return client_->get_item_name(item_id, game);
+        }
+        return "";
+    }
+
+    std::string lookup_player_name(const NameCache& names, int player_id) const {
+        if (const PlayerNames* player = names.player(player_id)) {
+            return std::string(player->alias);
+        }
+        if (client_) {
+            return client_->get_player_alias(player_id);
+        }
+        return "";
+    }
+
+    /**
+     * @brief Rebuild the name cache.
+     * @param data_package New data package, or nullptr to refresh players only.
+     */
+    void rebuild_name_cache(const nlohmann::json* data_package) {
+        if (!client_) return;
+
+        std::vector<NameCache::Player> players;
+        for (const auto& player : client_->get_players()) {
+            players.push_back({player.slot, player.alias, client_->get_player_game(player.slot)});
+        }
+
+        std::shared_ptr<const NameCache> rebuilt = data_package
+            ? NameCache::build(*data_package, players)
+            : NameCache::with_players(get_name_cache(), players);
+
+        AP_LOG_DEBUG("Name cache rebuilt: ", rebuilt->game_count(), " games, ",
+            rebuilt->players().size(), " players");
+
+        std::lock_guard<std::mutex> lock(name_cache_mutex_);
+        name_cache_ = std::move(rebuilt);
+    }
+
+    /**
+     * @brief Seed apclientpp with cached games before the socket connects.
+     *
+     * apclientpp compares each game's checksum against RoomInfo and only
+     * requests the stale ones, so names resolve without a full download.
+     */
+    void load_cached_data_package() {
+        if (!data_package_cache_) return;
+
+        try {
+            nlohmann::json cached = data_package_cache_->load_all();
+            if (!cached["games"].empty()) {
+                client_->set_data_package(cached);
+                rebuild_name_cache(&cached);
+            }
+        } catch (const std::exception& e) {
+            AP_LOG_WARN("Failed to load data package cache: ", e.what());
+        }
+    }
+
+    void notify_wake() {
+        if (wake_callback_) {
+            wake_callback_();
+        }
+    }
+
     void setup_callbacks() {
         if (!client_) return;
 
         // Room info - fires when WebSocket connects
         client_->set_room_info_handler([this]() {
-            APLogger::instance().log(LogLevel::Debug, "Received room_info");
+            ++activity_;
+            AP_LOG_DEBUG("Received room_info");
 
             RoomInfo info;
             // Note: apclientpp doesn't expose all room info fields directly
@@ -236,11 +355,27 @@ private:
             }
         });
 
+        // Data package (names for every game in the room)
+        client_->set_data_package_changed_handler([this](const nlohmann::json& data_package) {
+            ++activity_;
+            rebuild_name_cache(&data_package);
+
+            if (data_package_cache_) {
+                try {
+                    data_package_cache_->store(data_package);
+                } catch (const std::exception& e) {
+                    AP_LOG_WARN("Failed to update data package cache: ", e.what());
+                }
+            }
+        });
+
         // Slot connected
         client_->set_slot_connected_handler([this](const nlohmann::json& slot_data) {
-            APLogger::instance().log(LogLevel::Info, "Slot connected");
+            ++activity_;
+            AP_LOG_INFO("Slot connected");
 
             slot_connected_ = true;
+            rebuild_name_cache(nullptr);
 
             SlotInfo info;
             info.slot_id = client_->get_player_number();
@@ -270,7 +405,8 @@ private:
 
         // Slot refused
         client_->set_slot_refused_handler([this](const std::list<std::string>& errors) {
-            APLogger::instance().log(LogLevel::Error, "Slot connection refused");
+            ++activity_;
+            AP_LOG_ERROR("Slot connection refused");
 
             slot_connected_ = false;
             std::vector<std::string> error_vec(errors.begin(), errors.end());
@@ -282,36 +418,55 @@ private:
 
         // Items received
         client_->set_items_received_handler([this](const std::list<APClientLib::NetworkItem>& items) {
+            ++activity_;
+            std::vector<ReceivedItem> batch;
+            batch.reserve(items.size());
+            auto names = get_name_cache();
+
             for (const auto& item : items) {
                 ReceivedItem received;
                 received.item_id = item.item;
                 received.location_id = item.location;
                 received.player_id = item.player;
-                received.item_name = get_item_name(item.item);
-                received.player_name = get_player_name(item.player);
-                received.index = received_item_index_++;
+                received.item_name = lookup_item_name(*names, game_, item.item);
+                received.player_name = lookup_player_name(*names, item.player);
+                received.index = item.index >= 0 ? item.index : received_item_index_.load();
+                received_item_index_ = received.index + 1;
 
-                APLogger::instance().log(LogLevel::Debug,
-                    "Received item: " + received.item_name +
-                    " from " + received.player_name);
+                AP_LOG_DEBUG("Received item: ", received.item_name, " from ", received.player_name);
 
-                if (item_received_callback_) {
+                if (items_received_callback_) {
+                    batch.push_back(std::move(received));
+                } else if (item_received_callback_) {
                     item_received_callback_(received);
                 }
             }
+
+            if (items_received_callback_ && !batch.empty()) {
+                items_received_callback_(batch);
+            }
         });
 
         // Location info (scout results)
         client_->set_location_info_handler([this](const std::list<APClientLib::NetworkItem>& items) {
+            ++activity_;
             std::vector<ScoutResult> results;
+            results.reserve(items.size());
+            auto names = get_name_cache();
+
             for (const auto& item : items) {
+                // Scouted items belong to the receiving player's game
+                const PlayerNames* receiver = names->player(item.player);
+                std::string item_game = receiver ? std::string(receiver->game) : game_;
+
                 ScoutResult result;
                 result.location_id = item.location;
                 result.item_id = item.item;
                 result.player_id = item.player;
-                result.item_name = get_item_name(item.item);
-                result.player_name = get_player_name(item.player);
-                results.push_back(result);
+                result.item_name = lookup_item_name(*names, item_game, item.item);
+                result.player_name = receiver ? std::string(receiver->alias)
+                                              : lookup_player_name(*names, item.player);
+                results.push_back(std::move(result));
             }
 
             if (location_scouted_callback_ && !results.empty()) {
@@ -321,7 +476,8 @@ private:
 
         // Socket disconnected
         client_->set_socket_disconnected_handler([this]() {
-            APLogger::instance().log(LogLevel::Warn, "Socket disconnected");
+            ++activity_;
+            AP_LOG_WARN("Socket disconnected");
             slot_connected_ = false;
 
             if (disconnected_callback_) {
@@ -331,6 +487,7 @@ private:
 
         // Print messages
         client_->set_print_handler([this](const std::string& msg) {
+            ++activity_;
             if (print_callback_) {
                 print_callback_(msg);
             }
@@ -338,6 +495,7 @@ private:
 
         // Print JSON messages
         client_->set_print_json_handler([this](const std::list<APClientLib::TextNode>& msg) {
+            ++activity_;
             // Convert to JSON for callback
             nlohmann::json data = nlohmann::json::array();
             for (const auto& node : msg) {
@@ -355,12 +513,17 @@ private:
 
         // Bounced packets
         client_->set_bounced_handler([this](const nlohmann::json& data) {
+            ++activity_;
             if (bounced_callback_) {
                 bounced_callback_(data);
             }
         });
     }
 
+    // client_ and slot_info_ are replaced on the polling thread (reconnects)
+    // while the game thread sends through them. Recursive because apclientpp
+    // handlers run inside poll() and call back in (room info -> connect_slot)
+    mutable std::recursive_mutex client_mutex_;
     std::unique_ptr<APClientLib> client_;
 
     std::string game_;
@@ -372,16 +535,27 @@ private:
     std::optional<SlotInfo> slot_info_;
     std::atomic<int> received_item_index_{0};
 
+    // Bumped by every server handler so poll() can report traffic
+    uint64_t activity_ = 0;
+
+    std::unique_ptr<DataPackageCache> data_package_cache_;
+
+    // Written on the polling thread, read from any thread
+    mutable std::mutex name_cache_mutex_;
+    std::shared_ptr<const NameCache> name_cache_ = std::make_shared<NameCache>();
+
     // Callbacks
     RoomInfoCallback room_info_callback_;
     SlotConnectedCallback slot_connected_callback_;
     SlotRefusedCallback slot_refused_callback_;
     ItemReceivedCallback item_received_callback_;
+    ItemsReceivedCallback items_received_callback_;
     LocationScoutedCallback location_scouted_callback_;
     DisconnectedCallback disconnected_callback_;
     PrintCallback print_callback_;
     PrintJsonCallback print_json_callback_;
     BouncedCallback bounced_callback_;
+    WakeCallback wake_callback_;
 };
 
 // =============================================================================
@@ -414,12 +588,12 @@ bool APClient::is_slot_connected() const {
     return impl_->is_slot_connected();
 }
 
-void APClient::poll() {
-    impl_->poll();
+bool APClient::poll() {
+    return impl_->poll();
 }
 
-void APClient::send_location_checks(const std::vector<int64_t>& location_ids) {
-    impl_->send_location_checks(location_ids);
+bool APClient::send_location_checks(const std::vector<int64_t>& location_ids) {
+    return impl_->send_location_checks(location_ids);
 }
 
 void APClient::send_location_scouts(const std::vector<int64_t>& location_ids,
@@ -458,6 +632,14 @@ std::string APClient::get_player_name(int player_id) const {
     return impl_->get_player_name(player_id);
 }
 
+void APClient::set_data_package_cache_folder(const std::filesystem::path& folder) {
+    impl_->set_data_package_cache_folder(folder);
+}
+
+std::shared_ptr<const NameCache> APClient::get_name_cache() const {
+    return impl_->get_name_cache();
+}
+
 int APClient::get_player_number() const {
     return impl_->get_player_number();
 }
@@ -482,6 +664,10 @@ void APClient::set_item_received_callback(ItemReceivedCallback callback) {
     impl_->set_item_received_callback(std::move(callback));
 }
 
+void APClient::set_items_received_callback(ItemsReceivedCallback callback) {
+    impl_->set_items_received_callback(std::move(callback));
+}
+
 void APClient::set_location_scouted_callback(LocationScoutedCallback callback) {
     impl_->set_location_scouted_callback(std::move(callback));
 }
@@ -502,4 +688,8 @@ void APClient::set_bounced_callback(BouncedCallback callback) {
     impl_->set_bounced_callback(std::move(callback));
 }
 
+void APClient::set_wake_callback(WakeCallback callback) {
+    impl_->set_wake_callback(std::move(callback));
+}
+
 } // namespace ap
@@ -6,6 +6,22 @@
 
 namespace ap {
 
+namespace {
+
+const char* log_level_name(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "trace";
+        case LogLevel::Debug: return "debug";
+        case LogLevel::Info: return "info";
+        case LogLevel::Warn: return "warn";
+        case LogLevel::Error: return "error";
+        case LogLevel::Fatal: return "fatal";
+    }
+    return "info";
+}
+
+} // namespace
+
 APConfig& APConfig::instance() {
     static APConfig instance;
     return instance;
@@ -35,13 +51,7 @@ bool APConfig::load(const std::filesystem::path& config_path) {
             config_.game_name = j["game_name"].get<std::string>();
         }
         if (j.contains("log_level")) {
-            std::string level = j["log_level"].get<std::string>();
-            if (level == "trace") config_.log_level = LogLevel::Trace;
-            else if (level == "debug") config_.log_level = LogLevel::Debug;
-            else if (level == "info") config_.log_level = LogLevel::Info;
-            else if (level == "warn") config_.log_level = LogLevel::Warn;
-            else if (level == "error") config_.log_level = LogLevel::Error;
-            else if (level == "fatal") config_.log_level = LogLevel::Fatal;
+            config_.log_level = log_level_from_string(j["log_level"].get<std::string>(), config_.log_level);
         }
         if (j.contains("log_file")) {
             config_.log_file = j["log_file"].get<std::string>();
@@ -50,6 +60,59 @@ bool APConfig::load(const std::filesystem::path& config_path) {
             config_.log_to_console = j["log_to_console"].get<bool>();
         }
 
+        // Logging section
+        if (j.contains("logging") && j["logging"].is_object()) {
+            const auto& l = j["logging"];
+            if (l.contains("async")) {
+                config_.logging.async = l["async"].get<bool>();
+            }
+            if (l.contains("queue_size")) {
+                config_.logging.queue_size = l["queue_size"].get<int>();
+            }
+            if (l.contains("flush_interval_ms")) {
+                config_.logging.flush_interval_ms = l["flush_interval_ms"].get<int>();
+            }
+            if (l.contains("flush_level")) {
+                config_.logging.flush_level = log_level_from_string(
+                    l["flush_level"].get<std::string>(), config_.logging.flush_level);
+            }
+            if (l.contains("drop_when_full")) {
+                config_.logging.drop_when_full = l["drop_when_full"].get<bool>();
+            }
+            if (l.contains("binary_file")) {
+                config_.logging.binary_file = l["binary_file"].get<std::string>();
+            }
+            if (l.contains("memory_entries")) {
+                config_.logging.memory_entries = l["memory_entries"].get<int>();
+            }
+            if (l.contains("max_file_size_mb")) {
+                config_.logging.max_file_size_mb = l["max_file_size_mb"].get<int>();
+            }
+            if (l.contains("rotate_interval_hours")) {
+                config_.logging.rotate_interval_hours = l["rotate_interval_hours"].get<int>();
+            }
+            if (l.contains("max_rotated_files")) {
+                config_.logging.max_rotated_files = l["max_rotated_files"].get<int>();
+            }
+            if (l.contains("compress_rotated")) {
+                config_.logging.compress_rotated = l["compress_rotated"].get<bool>();
+            }
+            if (l.contains("metrics_interval_s")) {
+                config_.logging.metrics_interval_s = l["metrics_interval_s"].get<int>();
+            }
+            if (l.contains("trace_enabled")) {
+                config_.logging.trace_enabled = l["trace_enabled"].get<bool>();
+            }
+            if (l.contains("component_levels") && l["component_levels"].is_object()) {
+                for (const auto& [component, level] : l["component_levels"].items()) {
+                    if (level.is_string()) {
+                        config_.logging.component_levels[component] =
+                            log_level_from_string(level.get<std::string>(), config_.log_level);
+                    }
+                }
+            }
+        }
+
         // Timeouts section
         if (j.contains("timeouts") && j["timeouts"].is_object()) {
             const auto& t = j["timeouts"];
@@ -85,6 +148,9 @@ bool APConfig::load(const std::filesystem::path& config_path) {
             if (r.contains("max_delay_ms")) {
                 config_.retry.max_delay_ms = r["max_delay_ms"].get<int>();
             }
+            if (r.contains("jitter")) {
+                config_.retry.jitter = r["jitter"].get<double>();
+            }
         }
 
         // Threading section
@@ -93,6 +159,18 @@ bool APConfig::load(const std::filesystem::path& config_path) {
             if (th.contains("polling_interval_ms")) {
                 config_.threading.polling_interval_ms = th["polling_interval_ms"].get<int>();
             }
+            if (th.contains("adaptive_polling")) {
+                config_.threading.adaptive_polling = th["adaptive_polling"].get<bool>();
+            }
+            if (th.contains("polling_min_interval_ms")) {
+                config_.threading.polling_min_interval_ms = th["polling_min_interval_ms"].get<int>();
+            }
+            if (th.contains("polling_idle_interval_ms")) {
+                config_.threading.polling_idle_interval_ms = th["polling_idle_interval_ms"].get<int>();
+            }
+            if (th.contains("polling_backoff_multiplier")) {
+                config_.threading.polling_backoff_multiplier = th["polling_backoff_multiplier"].get<double>();
+            }
             if (th.contains("ipc_poll_interval_ms")) {
                 config_.threading.ipc_poll_interval_ms = th["ipc_poll_interval_ms"].get<int>();
             }
@@ -102,6 +180,12 @@ bool APConfig::load(const std::filesystem::path& config_path) {
             if (th.contains("shutdown_timeout_ms")) {
                 config_.threading.shutdown_timeout_ms = th["shutdown_timeout_ms"].get<int>();
             }
+            if (th.contains("update_budget_us")) {
+                config_.threading.update_budget_us = th["update_budget_us"].get<int>();
+            }
+            if (th.contains("update_item_chunk")) {
+                config_.threading.update_item_chunk = th["update_item_chunk"].get<int>();
+            }
         }
 
         // AP Server section
@@ -122,6 +206,9 @@ bool APConfig::load(const std::filesystem::path& config_path) {
             if (ap.contains("auto_reconnect")) {
                 config_.ap_server.auto_reconnect = ap["auto_reconnect"].get<bool>();
             }
+            if (ap.contains("reconnect_max_attempts")) {
+                config_.ap_server.reconnect_max_attempts = ap["reconnect_max_attempts"].get<int>();
+            }
         }
 
         loaded_ = true;
@@ -148,19 +235,31 @@ bool APConfig::save(const std::filesystem::path& config_path) const {
     j["id_base"] = config_.id_base;
     j["game_name"] = config_.game_name;
 
-    // Convert log level to string
-    switch (config_.log_level) {
-        case LogLevel::Trace: j["log_level"] = "trace"; break;
-        case LogLevel::Debug: j["log_level"] = "debug"; break;
-        case LogLevel::Info: j["log_level"] = "info"; break;
-        case LogLevel::Warn: j["log_level"] = "warn"; break;
-        case LogLevel::Error: j["log_level"] = "error"; break;
-        case LogLevel::Fatal: j["log_level"] = "fatal"; break;
-    }
-
+    j["log_level"] = log_level_name(config_.log_level);
     j["log_file"] = config_.log_file;
     j["log_to_console"] = config_.log_to_console;
 
+    // Logging section
+    j["logging"] = {
+        {"async", config_.logging.async},
+        {"queue_size", config_.logging.queue_size},
+        {"flush_interval_ms", config_.logging.flush_interval_ms},
+        {"flush_level", log_level_name(config_.logging.flush_level)},
+        {"drop_when_full", config_.logging.drop_when_full},
+        {"binary_file", config_.logging.binary_file},
+        {"memory_entries", config_.logging.memory_entries},
+        {"max_file_size_mb", config_.logging.max_file_size_mb},
+        {"rotate_interval_hours", config_.logging.rotate_interval_hours},
+        {"max_rotated_files", config_.logging.max_rotated_files},
+        {"compress_rotated", config_.logging.compress_rotated},
+        {"metrics_interval_s", config_.logging.metrics_interval_s},
+        {"trace_enabled", config_.logging.trace_enabled},
+        {"component_levels", nlohmann::json::object()}
+    };
+    for (const auto& [component, level] : config_.logging.component_levels) {
+        j["logging"]["component_levels"][component] = log_level_name(level);
+    }
+
     // Timeouts section
     j["timeouts"] = {
         {"priority_registration_ms", config_.timeouts.priority_registration_ms},
@@ -175,15 +274,22 @@ bool APConfig::save(const std::filesystem::path& config_path) const {
         {"max_retries", config_.retry.max_retries},
         {"initial_delay_ms", config_.retry.initial_delay_ms},
         {"backoff_multiplier", config_.retry.backoff_multiplier},
-        {"max_delay_ms", config_.retry.max_delay_ms}
+        {"max_delay_ms", config_.retry.max_delay_ms},
+        {"jitter", config_.retry.jitter}
     };
 
     // Threading section
     j["threading"] = {
         {"polling_interval_ms", config_.threading.polling_interval_ms},
+        {"adaptive_polling", config_.threading.adaptive_polling},
+        {"polling_min_interval_ms", config_.threading.polling_min_interval_ms},
+        {"polling_idle_interval_ms", config_.threading.polling_idle_interval_ms},
+        {"polling_backoff_multiplier", config_.threading.polling_backoff_multiplier},
         {"ipc_poll_interval_ms", config_.threading.ipc_poll_interval_ms},
         {"queue_max_size", config_.threading.queue_max_size},
-        {"shutdown_timeout_ms", config_.threading.shutdown_timeout_ms}
+        {"shutdown_timeout_ms", config_.threading.shutdown_timeout_ms},
+        {"update_budget_us", config_.threading.update_budget_us},
+        {"update_item_chunk", config_.threading.update_item_chunk}
     };
 
     // AP Server section
@@ -192,7 +298,8 @@ bool APConfig::save(const std::filesystem::path& config_path) const {
         {"port", config_.ap_server.port},
         {"slot_name", config_.ap_server.slot_name},
         {"password", config_.ap_server.password},
-        {"auto_reconnect", config_.ap_server.auto_reconnect}
+        {"auto_reconnect", config_.ap_server.auto_reconnect},
+        {"reconnect_max_attempts", config_.ap_server.reconnect_max_attempts}
     };
 
     // Write with pretty printing
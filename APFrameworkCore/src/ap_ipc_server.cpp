@@ -1,5 +1,7 @@
 #include "ap_ipc_server.h"
 #include "ap_logger.h"
+#include "ap_metrics.h"
+#include "ap_trace.h"
 
 #include <thread>
 #include <mutex>
@@ -65,8 +67,7 @@ public:
         // Start the I/O thread
         io_thread_ = std::thread(&Impl::io_thread_func, this);
 
-        APLogger::instance().log(LogLevel::Info,
-            "IPC Server started on: " + pipe_name_);
+        AP_LOG_INFO_C(LogComponent::IPC, "IPC Server started on: ", pipe_name_);
         return true;
     }
 
@@ -99,7 +100,7 @@ public:
             clients_.clear();
         }
 
-        APLogger::instance().log(LogLevel::Info, "IPC Server stopped");
+        AP_LOG_INFO_C(LogComponent::IPC, "IPC Server stopped");
     }
 
     bool is_running() const {
@@ -139,13 +140,19 @@ public:
         return incoming_queue_.pop_all();
     }
 
+    void get_pending_messages(std::vector<IPCMessage>& out) {
+        incoming_queue_.pop_all(out);
+    }
+
     void poll() {
-        auto messages = incoming_queue_.pop_all();
-        for (const auto& msg : messages) {
+        // Reuse the drained buffer each frame so steady traffic doesn't reallocate
+        incoming_queue_.pop_all(poll_buffer_);
+        for (const auto& msg : poll_buffer_) {
             if (message_handler_) {
                 message_handler_(msg.source, msg);
             }
         }
+        poll_buffer_.clear();
     }
 
     std::vector<std::string> get_connected_clients() const {
@@ -200,8 +207,7 @@ private:
         // Create the initial listening pipe
         HANDLE listen_pipe = create_pipe_instance();
         if (listen_pipe == INVALID_HANDLE_VALUE) {
-            APLogger::instance().log(LogLevel::Error,
-                "Failed to create named pipe: " + std::to_string(GetLastError()));
+            AP_LOG_ERROR_C(LogComponent::IPC, "Failed to create named pipe: ", GetLastError());
             return;
         }
 
@@ -212,8 +218,7 @@ private:
         ConnectNamedPipe(listen_pipe, &connect_overlapped);
         DWORD connect_error = GetLastError();
         if (connect_error != ERROR_IO_PENDING && connect_error != ERROR_PIPE_CONNECTED) {
-            APLogger::instance().log(LogLevel::Error,
-                "ConnectNamedPipe failed: " + std::to_string(connect_error));
+            AP_LOG_ERROR_C(LogComponent::IPC, "ConnectNamedPipe failed: ", connect_error);
             CloseHandle(listen_pipe);
             CloseHandle(connect_overlapped.hEvent);
             return;
@@ -252,12 +257,12 @@ private:
             }
 
             if (result == WAIT_FAILED) {
-                APLogger::instance().log(LogLevel::Error,
-                    "WaitForMultipleObjects failed: " + std::to_string(GetLastError()));
+                AP_LOG_ERROR_C(LogComponent::IPC, "WaitForMultipleObjects failed: ", GetLastError());
                 continue;
             }
 
             DWORD index = result - WAIT_OBJECT_0;
+            AP_TRACE_SCOPE("IPC I/O");
 
             if (index == 0) {
                 // New client connection
@@ -315,8 +320,7 @@ private:
             clients_[temp_id] = std::move(conn);
         }
 
-        APLogger::instance().log(LogLevel::Debug,
-            "New client connected: " + temp_id);
+        AP_LOG_DEBUG_C(LogComponent::IPC, "New client connected: ", temp_id);
 
         if (connect_handler_) {
             connect_handler_(temp_id);
@@ -386,8 +390,7 @@ private:
         memcpy(&msg_length, conn->read_buffer.data(), 4);
 
         if (bytes_received < 4 + msg_length) {
-            APLogger::instance().log(LogLevel::Warn,
-                "Incomplete message from " + conn->client_id);
+            AP_LOG_WARN_C(LogComponent::IPC, "Incomplete message from ", conn->client_id);
             return;
         }
 
@@ -418,11 +421,11 @@ private:
             }
 
             msg.source = conn->client_id;
+            messages_in_.add(msg.type);
             incoming_queue_.push(std::move(msg));
 
         } catch (const nlohmann::json::exception& e) {
-            APLogger::instance().log(LogLevel::Error,
-                "JSON parse error from " + conn->client_id + ": " + e.what());
+            AP_LOG_ERROR_C(LogComponent::IPC, "JSON parse error from ", conn->client_id, ": ", e.what());
         }
     }
 
@@ -449,12 +452,12 @@ private:
                 &bytes_written,
                 nullptr  // Synchronous for now
             );
+            messages_out_.add(message.type);
 
             return success && bytes_written == buffer.size();
 
         } catch (const std::exception& e) {
-            APLogger::instance().log(LogLevel::Error,
-                "Failed to send message to " + conn->client_id + ": " + e.what());
+            AP_LOG_ERROR_C(LogComponent::IPC, "Failed to send message to ", conn->client_id, ": ", e.what());
             return false;
         }
     }
@@ -471,8 +474,7 @@ private:
         }
 
         if (conn) {
-            APLogger::instance().log(LogLevel::Debug,
-                "Client disconnected: " + client_id);
+            AP_LOG_DEBUG_C(LogComponent::IPC, "Client disconnected: ", client_id);
 
             if (disconnect_handler_) {
                 disconnect_handler_(client_id);
@@ -489,6 +491,11 @@ private:
     std::unordered_map<std::string, std::unique_ptr<ClientConnection>> clients_;
 
     ThreadSafeQueue<IPCMessage> incoming_queue_;
+    std::vector<IPCMessage> poll_buffer_;  // Main thread only
+
+    // Per message type: "ipc.in.<type>" / "ipc.out.<type>"
+    MetricCounterFamily messages_in_{"ipc.in."};
+    MetricCounterFamily messages_out_{"ipc.out."};
 
     MessageHandler message_handler_;
     ConnectHandler connect_handler_;
@@ -510,6 +517,7 @@ public:
     void broadcast(const IPCMessage&) {}
     void broadcast_except(const IPCMessage&, const std::string&) {}
     std::vector<IPCMessage> get_pending_messages() { return {}; }
+    void get_pending_messages(std::vector<IPCMessage>& out) { out.clear(); }
     void poll() {}
     std::vector<std::string> get_connected_clients() const { return {}; }
     bool is_client_connected(const std::string&) const { return false; }
@@ -559,6 +567,10 @@ std::vector<IPCMessage> APIPCServer::get_pending_messages() {
     return impl_->get_pending_messages();
 }
 
+void APIPCServer::get_pending_messages(std::vector<IPCMessage>& out) {
+    impl_->get_pending_messages(out);
+}
+
 void APIPCServer::poll() {
     impl_->poll();
 }
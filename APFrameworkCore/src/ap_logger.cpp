@@ -1,11 +1,21 @@
 #include "ap_logger.h"
+#include "mpsc_ring_buffer.h"
+#include "compression_util.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
 #include <iostream>
-#include <iomanip>
+#include <iterator>
 #include <chrono>
 #include <ctime>
 #include <thread>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -16,23 +26,801 @@ namespace ap {
 // File-scope thread-local variable (can't be exported from DLL)
 static thread_local std::string g_thread_name_ = "";
 
+// "[name]" as written in log lines; rebuilt lazily when the name changes
+static thread_local std::string g_thread_tag_ = "";
+
+// Argument buffers for format records and plain messages in the binary log
+static thread_local std::string g_format_scratch_;
+static thread_local std::string g_plain_scratch_;
+
+// Set while a thread is writing a batch, so a log callback that logs again
+// never waits on a full ring that only it can empty
+static thread_local bool g_in_async_writer_ = false;
+
+struct APLogger::LogRecord {
+    LogLevel level = LogLevel::Info;
+    std::chrono::system_clock::time_point time;
+    std::string thread_tag;
+    std::string message;
+};
+
+namespace {
+
+const std::string& current_thread_tag() {
+    if (g_thread_tag_.empty()) {
+        g_thread_tag_ = "[" + APLogger::get_thread_name() + "]";
+    }
+    return g_thread_tag_;
+}
+
+// "[LEVEL] " for each LogLevel, in enum order
+constexpr std::string_view LEVEL_TAGS[] = {
+    "[TRACE] ", "[DEBUG] ", "[INFO] ", "[WARN] ", "[ERROR] ", "[FATAL] "
+};
+
+std::string_view level_tag(LogLevel level) {
+    auto index = static_cast<size_t>(level);
+    return index < std::size(LEVEL_TAGS) ? LEVEL_TAGS[index] : std::string_view("[UNKNOWN] ");
+}
+
+} // namespace
+
+// =============================================================================
+// History
+// =============================================================================
+
+/**
+ * @brief Fixed-size ring of the most recent entries, for get_logs.
+ *
+ * Slots are overwritten in place, so a full ring stops allocating once the
+ * strings have grown to their usual sizes. Has its own mutex so a query
+ * copying a page never holds up the log writer.
+ */
+class APLogger::History {
+public:
+    void set_capacity(size_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slots_.clear();
+        slots_.shrink_to_fit();
+        slots_.resize(capacity);
+        count_ = 0;
+        enabled_.store(capacity > 0, std::memory_order_relaxed);
+    }
+
+    bool enabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void add(const LogRecord& record) {
+        if (!enabled_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        std::string_view message(record.message);
+        std::string_view component;
+        size_t close = message.find("] ");
+        if (!message.empty() && message.front() == '[' && close != std::string_view::npos &&
+            close <= MAX_COMPONENT_LENGTH && message.substr(1, close - 1).find_first_of("[ ") == std::string_view::npos) {
+            component = message.substr(1, close - 1);
+            message.remove_prefix(close + 2);
+        }
+
+        std::string_view thread(record.thread_tag);
+        if (thread.size() >= 2) {
+            thread = thread.substr(1, thread.size() - 2);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (slots_.empty()) {
+            return;
+        }
+
+        LogEntry& entry = slots_[(next_sequence_ - 1) % slots_.size()];
+        entry.sequence = next_sequence_++;
+        entry.time = record.time;
+        entry.level = record.level;
+        entry.thread.assign(thread);
+        entry.component.assign(component);
+        entry.message.assign(message);
+        count_ = std::min(count_ + 1, slots_.size());
+    }
+
+    LogPage query(const LogQuery& query) const {
+        LogPage page;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        page.last_sequence = next_sequence_ - 1;
+        if (count_ == 0 || query.limit == 0) {
+            return page;
+        }
+
+        uint64_t first = next_sequence_ - count_;
+        uint64_t last = next_sequence_ - 1;
+        uint64_t start = std::max(query.after + 1, first);
+        page.first_sequence = first;
+
+        size_t bytes = 0;
+        auto take = [&](const LogEntry& entry) {
+            if (page.entries.size() >= query.limit ||
+                (query.max_bytes > 0 && !page.entries.empty() && bytes >= query.max_bytes)) {
+                page.more = true;
+                return false;
+            }
+            bytes += entry.message.size() + entry.component.size();
+            page.entries.push_back(entry);
+            return true;
+        };
+
+        if (query.newest) {
+            for (uint64_t seq = last; seq >= start && seq > 0; --seq) {
+                const LogEntry& entry = at(seq);
+                if (matches(entry, query) && !take(entry)) {
+                    break;
+                }
+            }
+            std::reverse(page.entries.begin(), page.entries.end());
+        } else {
+            for (uint64_t seq = start; seq <= last; ++seq) {
+                const LogEntry& entry = at(seq);
+                if (matches(entry, query) && !take(entry)) {
+                    break;
+                }
+            }
+        }
+        return page;
+    }
+
+private:
+    static constexpr size_t MAX_COMPONENT_LENGTH = 64;
+
+    const LogEntry& at(uint64_t sequence) const {
+        return slots_[(sequence - 1) % slots_.size()];
+    }
+
+    static bool matches(const LogEntry& entry, const LogQuery& query) {
+        if (entry.level < query.min_level) {
+            return false;
+        }
+        if (!query.levels.empty() && query.levels.count(entry.level) == 0) {
+            return false;
+        }
+        if (!query.components.empty() && query.components.count(entry.component) == 0) {
+            return false;
+        }
+        return true;
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<LogEntry> slots_;
+    size_t count_ = 0;
+    uint64_t next_sequence_ = 1;
+    std::atomic<bool> enabled_{false};
+};
+
+// =============================================================================
+// Rotator
+// =============================================================================
+
+/**
+ * @brief Background half of log rotation: gzip and retention.
+ *
+ * The logger renames the full log itself (cheap) and hands the rotated path
+ * here. Files left uncompressed by an earlier session (for example, one that
+ * shut down mid-compression) are picked up on startup.
+ */
+class APLogger::Rotator {
+public:
+    Rotator(std::filesystem::path log_path, int max_files, bool compress)
+        : log_path_(std::move(log_path)),
+          max_files_(std::max(max_files, 0)),
+          compress_(compress) {
+        if (compress_) {
+            for (const auto& rotated : list_rotated()) {
+                if (rotated.extension() != ".gz") {
+                    jobs_.push_back(rotated);
+                }
+            }
+        }
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    ~Rotator() {
+        stop();
+    }
+
+    /**
+     * @brief Name for a log rotated at `time`, unique within the folder.
+     */
+    std::filesystem::path rotated_path(std::chrono::system_clock::time_point time) {
+        std::time_t time_t = std::chrono::system_clock::to_time_t(time);
+        std::tm tm_buf;
+#ifdef _WIN32
+        localtime_s(&tm_buf, &time_t);
+#else
+        localtime_r(&time_t, &tm_buf);
+#endif
+        char stamp[32];
+        std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm_buf);
+
+        // Suffixes only grow within a second, so a name freed by pruning is
+        // never reused for a newer file
+        if (last_stamp_ != stamp) {
+            last_stamp_ = stamp;
+            next_suffix_ = 0;
+        }
+
+        std::string base = log_path_.stem().string() + "." + stamp;
+        std::string extension = log_path_.extension().string();
+
+        std::error_code ec;
+        for (;;) {
+            int suffix = next_suffix_++;
+            std::filesystem::path candidate = log_path_.parent_path() /
+                (base + (suffix > 0 ? "-" + std::to_string(suffix) : "") + extension);
+            if (!std::filesystem::exists(candidate, ec) &&
+                !std::filesystem::exists(candidate.string() + ".gz", ec)) {
+                return candidate;
+            }
+        }
+    }
+
+    void submit(std::filesystem::path rotated) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(rotated));
+        }
+        cv_.notify_one();
+    }
+
+    /**
+     * @brief Finish the file being compressed and stop; queued files are
+     *        compressed by the next session.
+     */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+private:
+    void run() {
+        APLogger::set_thread_name("LogRotate");
+        prune();
+
+        for (;;) {
+            std::filesystem::path rotated;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+                if (stopping_) {
+                    return;
+                }
+                rotated = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+
+            if (compress_) {
+                compress(rotated);
+            }
+            prune();
+        }
+    }
+
+    void compress(const std::filesystem::path& rotated) {
+        std::filesystem::path gz = rotated.string() + ".gz";
+        auto started = std::chrono::steady_clock::now();
+
+        std::error_code ec;
+        auto size = std::filesystem::file_size(rotated, ec);
+        if (!CompressionUtil::gzip_file(rotated, gz)) {
+            AP_LOG_WARN("[APLogger] Failed to compress rotated log: ", rotated.filename().string());
+            return;
+        }
+        std::filesystem::remove(rotated, ec);
+
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+        AP_LOG_INFO("[APLogger] Compressed ", gz.filename().string(), " (", ec ? 0 : size / 1024,
+                    " KiB) in ", ms, "ms");
+    }
+
+    /**
+     * @brief Rotated logs of this log file, oldest first.
+     */
+    std::vector<std::filesystem::path> list_rotated() const {
+        std::vector<std::filesystem::path> rotated;
+        std::string prefix = log_path_.stem().string() + ".";
+        std::string extension = log_path_.extension().string();
+
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(log_path_.parent_path(), ec)) {
+            std::string name = entry.path().filename().string();
+            bool has_stamp = name.size() > prefix.size() && name.compare(0, prefix.size(), prefix) == 0 &&
+                             std::isdigit(static_cast<unsigned char>(name[prefix.size()]));
+            bool has_extension = ends_with(name, extension) || ends_with(name, extension + ".gz");
+            if (entry.is_regular_file(ec) && has_stamp && has_extension) {
+                rotated.push_back(entry.path());
+            }
+        }
+
+        // Chronological: by timestamp, then by the "-N" suffix of files
+        // rotated within the same second (none sorts first)
+        auto order = [&prefix](const std::filesystem::path& path) {
+            std::string name = path.filename().string().substr(prefix.size());
+            std::string stamp = name.substr(0, name.find_first_not_of("0123456789-"));
+            size_t dash = stamp.find('-', stamp.find('-') + 1);
+            int suffix = dash == std::string::npos ? 0 : std::atoi(stamp.c_str() + dash + 1);
+            return std::make_pair(stamp.substr(0, dash), suffix);
+        };
+        std::sort(rotated.begin(), rotated.end(),
+                  [&](const auto& a, const auto& b) { return order(a) < order(b); });
+        return rotated;
+    }
+
+    void prune() {
+        auto rotated = list_rotated();
+        std::error_code ec;
+        for (size_t i = 0; i + max_files_ < rotated.size(); ++i) {
+            {
+                // Keep files that are still queued for compression
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (std::find(jobs_.begin(), jobs_.end(), rotated[i]) != jobs_.end()) {
+                    continue;
+                }
+            }
+            std::filesystem::remove(rotated[i], ec);
+        }
+    }
+
+    static bool ends_with(const std::string& value, const std::string& suffix) {
+        return value.size() >= suffix.size() &&
+               value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    const std::filesystem::path log_path_;
+    const size_t max_files_;
+    const bool compress_;
+
+    // rotated_path() state; only called by the logger under its mutex_
+    std::string last_stamp_;
+    int next_suffix_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::filesystem::path> jobs_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+// =============================================================================
+// Async Writer
+// =============================================================================
+
+/**
+ * @brief Background writer for the async backend.
+ *
+ * Producers fill ring slots in place (the strings keep their capacity across
+ * laps) and only wake the writer for urgent records or a half-full ring;
+ * otherwise the writer wakes every flush interval and writes the whole batch
+ * with a single lock of APLogger::mutex_ and at most one flush.
+ */
+class APLogger::AsyncWriter {
+public:
+    AsyncWriter(APLogger& logger, const LoggingConfig& config)
+        : logger_(logger),
+          flush_interval_(std::max(config.flush_interval_ms, 1)),
+          flush_level_(config.flush_level),
+          drop_when_full_(config.drop_when_full),
+          ring_(static_cast<size_t>(std::max(config.queue_size, 64))) {
+        last_flush_ = std::chrono::steady_clock::now();
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    ~AsyncWriter() {
+        stop();
+    }
+
+    void push(LogLevel level, const std::string& message) {
+        auto fill = [&](LogRecord& record) {
+            record.level = level;
+            record.time = std::chrono::system_clock::now();
+            record.thread_tag = current_thread_tag();
+            record.message = message;
+        };
+
+        while (!ring_.try_emplace_with(fill)) {
+            if (drop_when_full_ || g_in_async_writer_) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            wake();
+            std::this_thread::yield();
+        }
+
+        // Pairs with the fence in run(): either we see the writer idle or it
+        // sees our record before it sleeps
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (idle_.load(std::memory_order_relaxed) &&
+            (level >= flush_level_ || ring_.size_approx() >= ring_.capacity() / 2)) {
+            wake();
+        }
+    }
+
+    /**
+     * @brief Write everything published so far and flush, on the caller.
+     */
+    void drain() {
+        write_batch(true);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+        }
+        wake_cv_.notify_one();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        write_batch(true);
+    }
+
+private:
+    void run() {
+        APLogger::set_thread_name("Logger");
+
+        for (;;) {
+            bool wrote = write_batch(false);
+
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            if (!running_) {
+                break;
+            }
+            if (wrote) {
+                continue;
+            }
+
+            idle_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            wake_cv_.wait_for(lock, flush_interval_, [this]() {
+                return !running_ || wake_pending_ || ring_.size_approx() > 0;
+            });
+            wake_pending_ = false;
+            idle_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void wake() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            wake_pending_ = true;
+        }
+        wake_cv_.notify_one();
+    }
+
+    /**
+     * @brief Consume the ring and write it out.
+     * @param force_flush Flush the file and console even if no flush is due.
+     * @return true if any records were written.
+     */
+    bool write_batch(bool force_flush) {
+        std::lock_guard<std::mutex> consume_lock(consume_mutex_);
+        std::lock_guard<std::mutex> lock(logger_.mutex_);
+
+        g_in_async_writer_ = true;
+
+        bool urgent = false;
+        size_t written = 0;
+
+        uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            LogRecord notice;
+            notice.level = LogLevel::Warn;
+            notice.time = std::chrono::system_clock::now();
+            notice.thread_tag = current_thread_tag();
+            notice.message = "[APLogger] Log queue full, dropped " + std::to_string(dropped) + " records";
+            write_record(notice);
+            urgent = true;
+        }
+
+        written = ring_.consume_all([&](LogRecord& record) {
+            write_record(record);
+            urgent = urgent || record.level >= flush_level_;
+        });
+
+        dirty_ = dirty_ || written > 0 || dropped > 0;
+
+        auto now = std::chrono::steady_clock::now();
+        bool due = dirty_ && now - last_flush_ >= flush_interval_;
+        if (force_flush || urgent || due) {
+            if (logger_.log_file_.is_open()) {
+                logger_.log_file_.flush();
+            }
+            if (logger_.console_output_) {
+                std::cout.flush();
+            }
+            last_flush_ = now;
+            dirty_ = false;
+        }
+
+        g_in_async_writer_ = false;
+        return written > 0;
+    }
+
+    // Caller holds logger_.mutex_
+    void write_record(const LogRecord& record) {
+        std::string& line = logger_.line_buffer_;
+        logger_.format_log_entry(line, record);
+        logger_.history_->add(record);
+
+        if (logger_.log_file_.is_open()) {
+            logger_.log_file_ << line << '\n';
+            logger_.log_file_bytes_ += line.size() + 1;
+            logger_.rotate_if_needed();
+        }
+
+        if (logger_.console_output_) {
+            std::ostream& out = record.level >= LogLevel::Error ? std::cerr : std::cout;
+            out << line << '\n';
+        }
+
+        if (logger_.log_callback_) {
+            try {
+                logger_.log_callback_(record.level, line);
+            } catch (...) {
+                // Ignore callback exceptions
+            }
+        }
+    }
+
+    APLogger& logger_;
+    const std::chrono::milliseconds flush_interval_;
+    const LogLevel flush_level_;
+    const bool drop_when_full_;
+
+    MPSCRingBuffer<LogRecord> ring_;
+    std::atomic<uint64_t> dropped_{0};
+
+    std::mutex consume_mutex_;             // Single consumer: writer thread or a draining caller
+    std::chrono::steady_clock::time_point last_flush_;
+    bool dirty_ = false;                   // Written since the last flush
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    bool running_ = true;                  // Guarded by wake_mutex_
+    bool wake_pending_ = false;            // Guarded by wake_mutex_
+    std::atomic<bool> idle_{false};
+
+    std::thread thread_;
+};
+
+// =============================================================================
+// Binary Sink
+// =============================================================================
+
+/**
+ * @brief Compact binary log (format in binary_log.h).
+ *
+ * Records are appended to a buffered stream under the sink's own mutex, so
+ * they never wait on text formatting. Component, format and thread names
+ * are written as definitions before their first use. Each session appends
+ * a new file header, after which the decoder starts with fresh tables.
+ */
+class APLogger::BinarySink {
+public:
+    BinarySink() {
+        components_.push_back("");
+        formats_.push_back({binary_log::NO_COMPONENT_ID, "{}"});
+    }
+
+    bool open(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        file_.open(path, std::ios::out | std::ios::binary | std::ios::app);
+        if (!file_.is_open()) {
+            return false;
+        }
+
+        buffer_.clear();
+        buffer_.append(binary_log::FILE_MAGIC, sizeof(binary_log::FILE_MAGIC));
+        binary_log::append_raw<uint16_t>(buffer_, binary_log::FILE_VERSION);
+        for (size_t id = 1; id < components_.size(); ++id) {
+            append_component_definition(static_cast<uint16_t>(id));
+        }
+        for (size_t id = 1; id < formats_.size(); ++id) {
+            append_format_definition(static_cast<uint32_t>(id));
+        }
+        threads_.clear();
+        write_buffer();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (file_.is_open()) {
+            file_.flush();
+            file_.close();
+        }
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (file_.is_open()) {
+            file_.flush();
+        }
+    }
+
+    uint32_t register_format(const std::string& component, const std::string& format) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        buffer_.clear();
+        uint16_t component_id = intern_component(component);
+
+        for (size_t id = 1; id < formats_.size(); ++id) {
+            if (formats_[id].component == component_id && formats_[id].text == format) {
+                return static_cast<uint32_t>(id);
+            }
+        }
+
+        formats_.push_back({component_id, format});
+        auto format_id = static_cast<uint32_t>(formats_.size() - 1);
+        append_format_definition(format_id);
+        write_buffer();
+        return format_id;
+    }
+
+    bool lookup(uint32_t format_id, std::string& component, std::string& format) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (format_id >= formats_.size()) {
+            return false;
+        }
+        component = components_[formats_[format_id].component];
+        format = formats_[format_id].text;
+        return true;
+    }
+
+    void write(LogLevel level, uint32_t format_id, const std::string& thread_tag,
+               std::chrono::system_clock::time_point time, const std::string& encoded_args) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!file_.is_open()) {
+            return;
+        }
+
+        buffer_.clear();
+        uint8_t thread_id = intern_thread(thread_tag);
+        uint16_t component_id = format_id < formats_.size() ? formats_[format_id].component
+                                                            : binary_log::NO_COMPONENT_ID;
+        size_t args_length = std::min(encoded_args.size(), binary_log::MAX_FIELD_LENGTH);
+
+        buffer_.push_back(static_cast<char>(binary_log::TAG_RECORD));
+        binary_log::append_raw<int64_t>(buffer_,
+            std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count());
+        binary_log::append_raw<uint8_t>(buffer_, static_cast<uint8_t>(level));
+        binary_log::append_raw<uint8_t>(buffer_, thread_id);
+        binary_log::append_raw<uint16_t>(buffer_, component_id);
+        binary_log::append_raw<uint32_t>(buffer_, format_id);
+        binary_log::append_raw<uint16_t>(buffer_, static_cast<uint16_t>(args_length));
+        buffer_.append(encoded_args.data(), args_length);
+        write_buffer();
+
+        if (level >= LogLevel::Error) {
+            file_.flush();
+        }
+    }
+
+private:
+    struct Format {
+        uint16_t component;
+        std::string text;
+    };
+
+    // The helpers below append to buffer_ and require mutex_
+
+    uint16_t intern_component(const std::string& name) {
+        for (size_t id = 0; id < components_.size(); ++id) {
+            if (components_[id] == name) {
+                return static_cast<uint16_t>(id);
+            }
+        }
+        components_.push_back(name);
+        auto id = static_cast<uint16_t>(components_.size() - 1);
+        append_component_definition(id);
+        return id;
+    }
+
+    uint8_t intern_thread(const std::string& tag) {
+        auto it = threads_.find(tag);
+        if (it != threads_.end()) {
+            return it->second;
+        }
+
+        // IDs are one byte; past 255 threads the last ID is shared
+        auto id = static_cast<uint8_t>(std::min<size_t>(threads_.size(), 0xFF));
+        threads_.emplace(tag, id);
+
+        std::string_view name(tag);
+        if (name.size() >= 2 && name.front() == '[' && name.back() == ']') {
+            name = name.substr(1, name.size() - 2);
+        }
+        buffer_.push_back(static_cast<char>(binary_log::TAG_THREAD));
+        binary_log::append_raw<uint8_t>(buffer_, id);
+        binary_log::append_string(buffer_, name);
+        return id;
+    }
+
+    void append_component_definition(uint16_t id) {
+        if (!file_.is_open()) {
+            return;
+        }
+        buffer_.push_back(static_cast<char>(binary_log::TAG_COMPONENT));
+        binary_log::append_raw<uint16_t>(buffer_, id);
+        binary_log::append_string(buffer_, components_[id]);
+    }
+
+    void append_format_definition(uint32_t id) {
+        if (!file_.is_open()) {
+            return;
+        }
+        buffer_.push_back(static_cast<char>(binary_log::TAG_FORMAT));
+        binary_log::append_raw<uint32_t>(buffer_, id);
+        binary_log::append_raw<uint16_t>(buffer_, formats_[id].component);
+        binary_log::append_string(buffer_, formats_[id].text);
+    }
+
+    void write_buffer() {
+        if (file_.is_open() && !buffer_.empty()) {
+            file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        }
+        buffer_.clear();
+    }
+
+    mutable std::mutex mutex_;
+    std::ofstream file_;
+    std::string buffer_;
+
+    std::vector<std::string> components_;                  // Index = component ID
+    std::vector<Format> formats_;                          // Index = format ID
+    std::unordered_map<std::string, uint8_t> threads_;     // Thread tag -> ID, per file
+};
+
+// =============================================================================
+// APLogger
+// =============================================================================
+
 APLogger& APLogger::instance() {
     static APLogger instance;
     return instance;
 }
 
+APLogger::APLogger()
+    : binary_(std::make_unique<BinarySink>()),
+      history_(std::make_unique<History>()) {
+    for (auto& level : component_levels_) {
+        level.store(INHERIT_LEVEL, std::memory_order_relaxed);
+    }
+}
+
 APLogger::~APLogger() {
     shutdown();
 }
 
-bool APLogger::init(LogLevel min_level, const std::string& log_file_path, bool console_output) {
+bool APLogger::init(LogLevel min_level, const std::string& log_file_path, bool console_output,
+                    const std::string& binary_log_path) {
     std::lock_guard<std::mutex> lock(mutex_);
 
     if (initialized_) {
         return true;
     }
 
-    min_level_ = min_level;
+    min_level_.store(min_level, std::memory_order_relaxed);
     console_output_ = console_output;
 
     if (!log_file_path.empty()) {
@@ -43,19 +831,48 @@ bool APLogger::init(LogLevel min_level, const std::string& log_file_path, bool c
             }
             return false;
         }
+
+        std::error_code ec;
+        auto existing = std::filesystem::file_size(log_file_path, ec);
+        log_file_path_ = log_file_path;
+        log_file_bytes_ = ec ? 0 : existing;
+        log_file_opened_ = std::chrono::steady_clock::now();
+    }
+
+    if (!binary_log_path.empty()) {
+        if (binary_->open(binary_log_path)) {
+            binary_enabled_.store(true);
+        } else if (console_output_) {
+            std::cerr << "[APLogger] Failed to open binary log: " << binary_log_path << std::endl;
+        }
     }
 
     initialized_ = true;
+    update_text_sinks();
 
     // Set main thread name
     if (g_thread_name_.empty()) {
         g_thread_name_ = "Main";
+        g_thread_tag_.clear();
     }
 
     return true;
 }
 
 void APLogger::shutdown() {
+    disable_async();
+
+    binary_enabled_.store(false);
+    binary_->close();
+
+    // The rotator logs from its own thread, so stop it before taking mutex_
+    std::unique_ptr<Rotator> rotator;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rotator = std::move(rotator_);
+    }
+    rotator.reset();
+
     std::lock_guard<std::mutex> lock(mutex_);
 
     if (log_file_.is_open()) {
@@ -65,6 +882,90 @@ void APLogger::shutdown() {
 
     log_callback_ = nullptr;
     initialized_ = false;
+    update_text_sinks();
+}
+
+void APLogger::enable_async(const LoggingConfig& config) {
+    std::lock_guard<std::mutex> async_lock(async_mutex_);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!initialized_ || writer_) {
+            return;
+        }
+    }
+
+    writer_ = std::make_unique<AsyncWriter>(*this, config);
+    async_enabled_.store(true);
+}
+
+void APLogger::disable_async() {
+    std::lock_guard<std::mutex> async_lock(async_mutex_);
+
+    if (!writer_) {
+        return;
+    }
+
+    // New calls go synchronous; wait out the ones already pushing
+    async_enabled_.store(false);
+    while (active_producers_.load() > 0) {
+        std::this_thread::yield();
+    }
+
+    writer_->stop();
+    writer_.reset();
+}
+
+void APLogger::configure_rotation(const LoggingConfig& config) {
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!initialized_ || log_file_path_.empty()) {
+            return;
+        }
+        path = log_file_path_;
+    }
+
+    uint64_t max_bytes = static_cast<uint64_t>(std::max(config.max_file_size_mb, 0)) * 1024 * 1024;
+    auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::hours(std::max(config.rotate_interval_hours, 0)));
+
+    // Built outside mutex_: the rotator may log as soon as its thread starts
+    std::unique_ptr<Rotator> rotator;
+    if (max_bytes > 0 || interval.count() > 0) {
+        rotator = std::make_unique<Rotator>(path, config.max_rotated_files, config.compress_rotated);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::swap(rotator, rotator_);
+        rotate_max_bytes_ = rotator_ ? max_bytes : 0;
+        rotate_interval_ = rotator_ ? interval : std::chrono::steady_clock::duration::zero();
+        rotate_if_needed();
+    }
+
+    // Previous rotator (if any) is stopped here, outside mutex_
+}
+
+bool APLogger::is_async() const {
+    return async_enabled_.load();
+}
+
+void APLogger::flush() {
+    active_producers_.fetch_add(1);
+    if (async_enabled_.load()) {
+        writer_->drain();
+        active_producers_.fetch_sub(1);
+        return;
+    }
+    active_producers_.fetch_sub(1);
+
+    binary_->flush();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (log_file_.is_open()) {
+        log_file_.flush();
+    }
 }
 
 void APLogger::trace(const std::string& message) {
@@ -92,7 +993,7 @@ void APLogger::fatal(const std::string& message) {
 }
 
 void APLogger::log(LogLevel level, const std::string& message) {
-    if (level < min_level_) {
+    if (!is_enabled(level)) {
         return;
     }
 
@@ -100,7 +1001,7 @@ void APLogger::log(LogLevel level, const std::string& message) {
 }
 
 void APLogger::log(LogLevel level, const std::string& component, const std::string& message) {
-    if (level < min_level_) {
+    if (!is_enabled(level, log_component_from_string(component))) {
         return;
     }
 
@@ -108,19 +1009,50 @@ void APLogger::log(LogLevel level, const std::string& component, const std::stri
     write_log_entry(level, formatted);
 }
 
+void APLogger::log(LogLevel level, LogComponent component, const std::string& message) {
+    if (!is_enabled(level, component)) {
+        return;
+    }
+
+    write_log_entry(level, message);
+}
+
+void APLogger::set_component_level(LogComponent component, LogLevel level) {
+    if (component < LogComponent::None) {
+        component_levels_[static_cast<size_t>(component)].store(static_cast<int>(level),
+                                                                 std::memory_order_relaxed);
+    }
+}
+
+void APLogger::clear_component_level(LogComponent component) {
+    if (component < LogComponent::None) {
+        component_levels_[static_cast<size_t>(component)].store(INHERIT_LEVEL, std::memory_order_relaxed);
+    }
+}
+
+std::optional<LogLevel> APLogger::get_component_level(LogComponent component) const {
+    if (component >= LogComponent::None) {
+        return std::nullopt;
+    }
+    int level = component_levels_[static_cast<size_t>(component)].load(std::memory_order_relaxed);
+    if (level == INHERIT_LEVEL) {
+        return std::nullopt;
+    }
+    return static_cast<LogLevel>(level);
+}
+
 void APLogger::set_min_level(LogLevel level) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    min_level_ = level;
+    min_level_.store(level, std::memory_order_relaxed);
 }
 
 LogLevel APLogger::get_min_level() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return min_level_;
+    return min_level_.load(std::memory_order_relaxed);
 }
 
 void APLogger::set_console_output(bool enabled) {
     std::lock_guard<std::mutex> lock(mutex_);
     console_output_ = enabled;
+    update_text_sinks();
 }
 
 bool APLogger::get_console_output() const {
@@ -131,15 +1063,18 @@ bool APLogger::get_console_output() const {
 void APLogger::set_log_callback(LogCallback callback) {
     std::lock_guard<std::mutex> lock(mutex_);
     log_callback_ = std::move(callback);
+    update_text_sinks();
 }
 
 void APLogger::clear_log_callback() {
     std::lock_guard<std::mutex> lock(mutex_);
     log_callback_ = nullptr;
+    update_text_sinks();
 }
 
 void APLogger::set_thread_name(const std::string& name) {
     g_thread_name_ = name;
+    g_thread_tag_.clear();
 
 #ifdef _WIN32
     // Set thread name for debugger (Windows 10+)
@@ -157,15 +1092,94 @@ std::string APLogger::get_thread_name() {
     return g_thread_name_;
 }
 
+uint32_t APLogger::register_format(LogComponent component, const std::string& format) {
+    return binary_->register_format(log_component_to_string(component), format);
+}
+
+bool APLogger::is_binary_enabled() const {
+    return binary_enabled_.load();
+}
+
+void APLogger::set_history_capacity(size_t capacity) {
+    history_->set_capacity(capacity);
+}
+
+LogPage APLogger::query_logs(const LogQuery& query) const {
+    return history_->query(query);
+}
+
+std::string& APLogger::format_scratch() {
+    return g_format_scratch_;
+}
+
+void APLogger::write_format_record(LogLevel level, uint32_t format_id, const std::string& encoded_args) {
+    if (binary_enabled_.load(std::memory_order_relaxed)) {
+        binary_->write(level, format_id, current_thread_tag(), std::chrono::system_clock::now(), encoded_args);
+
+        // Text is only formatted when something besides the binary log reads it
+        if (!text_sinks_enabled_.load(std::memory_order_relaxed) && !history_->enabled()) {
+            return;
+        }
+    }
+
+    std::string component;
+    std::string format;
+    if (!binary_->lookup(format_id, component, format)) {
+        return;
+    }
+
+    std::string message = binary_log::format_message(format, encoded_args.data(), encoded_args.size());
+    if (!component.empty()) {
+        message = "[" + component + "] " + message;
+    }
+    write_text_entry(level, message);
+}
+
 void APLogger::write_log_entry(LogLevel level, const std::string& message) {
+    // Plain messages go to both logs, so the binary log is complete
+    if (binary_enabled_.load(std::memory_order_relaxed)) {
+        g_plain_scratch_.clear();
+        binary_log::encode_arg(g_plain_scratch_, std::string_view(message));
+        binary_->write(level, binary_log::PLAIN_FORMAT_ID, current_thread_tag(),
+                       std::chrono::system_clock::now(), g_plain_scratch_);
+    }
+
+    write_text_entry(level, message);
+}
+
+void APLogger::write_text_entry(LogLevel level, const std::string& message) {
+    if (async_enabled_.load(std::memory_order_relaxed)) {
+        active_producers_.fetch_add(1);
+        if (async_enabled_.load()) {
+            writer_->push(level, message);
+            if (level == LogLevel::Fatal) {
+                writer_->drain();
+            }
+            active_producers_.fetch_sub(1);
+            return;
+        }
+        active_producers_.fetch_sub(1);
+    }
+
+    LogRecord record;
+    record.level = level;
+    record.time = std::chrono::system_clock::now();
+    record.thread_tag = current_thread_tag();
+    record.message = message;
+
+    history_->add(record);
+
     std::lock_guard<std::mutex> lock(mutex_);
 
-    std::string formatted = format_log_entry(level, message);
+    format_log_entry(line_buffer_, record);
+    const std::string& formatted = line_buffer_;
 
     // Write to file
     if (log_file_.is_open()) {
         log_file_ << formatted << std::endl;
         log_file_.flush();
+        log_file_bytes_ += formatted.size() + 1;
+        rotate_if_needed();
     }
 
     // Write to console
@@ -188,33 +1202,85 @@ void APLogger::write_log_entry(LogLevel level, const std::string& message) {
     }
 }
 
-std::string APLogger::get_timestamp() const {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+void APLogger::update_text_sinks() {
+    text_sinks_enabled_.store(log_file_.is_open() || console_output_ || log_callback_,
+                              std::memory_order_relaxed);
+}
+
+void APLogger::rotate_if_needed() {
+    if (!rotator_ || !log_file_.is_open()) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    bool too_big = rotate_max_bytes_ > 0 && log_file_bytes_ >= rotate_max_bytes_;
+    bool too_old = rotate_interval_.count() > 0 && now - log_file_opened_ >= rotate_interval_;
+    if (!too_big && !too_old) {
+        return;
+    }
+
+    // Runs under mutex_, so nothing here may log
+    auto rotated = rotator_->rotated_path(std::chrono::system_clock::now());
+    log_file_.close();
+
+    std::error_code ec;
+    std::filesystem::rename(log_file_path_, rotated, ec);
+    log_file_.open(log_file_path_, std::ios::out | std::ios::app);
 
-    std::tm tm_buf;
+    // Reset even on failure (e.g. the file is locked) so we retry on the
+    // next interval instead of on every line
+    log_file_bytes_ = 0;
+    log_file_opened_ = now;
+    if (ec) {
+        if (console_output_) {
+            std::cerr << "[APLogger] Failed to rotate log file: " << log_file_path_ << std::endl;
+        }
+        return;
+    }
+
+    rotator_->submit(std::move(rotated));
+}
+
+void APLogger::append_timestamp(std::string& out, std::chrono::system_clock::time_point time) const {
+    auto since_epoch = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch());
+    int64_t second = since_epoch.count() / 1000;
+    int ms = static_cast<int>(since_epoch.count() % 1000);
+    if (ms < 0) {
+        ms += 1000;
+        --second;
+    }
+
+    // localtime and the date formatting only run once per second
+    if (second != cached_second_) {
+        std::time_t time_t = static_cast<std::time_t>(second);
+        std::tm tm_buf;
 #ifdef _WIN32
-    localtime_s(&tm_buf, &time_t);
+        localtime_s(&tm_buf, &time_t);
 #else
-    localtime_r(&time_t, &tm_buf);
+        localtime_r(&time_t, &tm_buf);
 #endif
+        char buffer[32];
+        size_t length = std::strftime(buffer, sizeof(buffer), "[%Y-%m-%d %H:%M:%S.", &tm_buf);
+        cached_prefix_.assign(buffer, length);
+        cached_second_ = second;
+    }
 
-    std::ostringstream oss;
-    oss << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S");
-    oss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-
-    return oss.str();
+    out.append(cached_prefix_);
+    char millis[4] = {
+        static_cast<char>('0' + ms / 100),
+        static_cast<char>('0' + ms / 10 % 10),
+        static_cast<char>('0' + ms % 10),
+        ']'
+    };
+    out.append(millis, sizeof(millis));
 }
 
-std::string APLogger::format_log_entry(LogLevel level, const std::string& message) const {
-    std::ostringstream oss;
-    oss << "[" << get_timestamp() << "]";
-    oss << "[" << get_thread_name() << "]";
-    oss << "[" << log_level_to_string(level) << "] ";
-    oss << message;
-    return oss.str();
+void APLogger::format_log_entry(std::string& out, const LogRecord& record) const {
+    out.clear();
+    append_timestamp(out, record.time);
+    out.append(record.thread_tag);
+    out.append(level_tag(record.level));
+    out.append(record.message);
 }
 
 } // namespace ap
@@ -9,17 +9,161 @@
 #include "ap_capabilities.h"
 #include "ap_state_manager.h"
 #include "ap_message_router.h"
+#include "ap_metrics.h"
+#include "ap_trace.h"
 #include "ap_exports.h"
+#include "retry_util.h"
+#include "compression_util.h"
+#include "frame_budget.h"
+#include "thread_safe_queue.h"
+#include "timer_queue.h"
 
 #include <sol/sol.hpp>
+#include <algorithm>
+#include <cctype>
 #include <chrono>
-#include <mutex>
+#include <cstdio>
+#include <ctime>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <unordered_map>
 
 namespace ap {
 
 // Global singleton instance
 std::unique_ptr<APManager> g_ap_manager;
 
+namespace {
+
+// get_logs pages must fit the 64 KiB IPC read buffer once serialized
+constexpr size_t GET_LOGS_MAX_ENTRIES = 200;
+constexpr size_t GET_LOGS_MAX_BYTES = 24 * 1024;
+
+std::string format_utc_timestamp(std::chrono::system_clock::time_point time) {
+    auto since_epoch = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch());
+    std::time_t seconds = static_cast<std::time_t>(since_epoch.count() / 1000);
+    int ms = static_cast<int>(since_epoch.count() % 1000);
+
+    std::tm tm_buf;
+#ifdef _WIN32
+    gmtime_s(&tm_buf, &seconds);
+#else
+    gmtime_r(&seconds, &tm_buf);
+#endif
+
+    char buffer[32];
+    size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &tm_buf);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%03dZ", ms);
+    return buffer;
+}
+
+std::string level_name(LogLevel level) {
+    std::string name = log_level_to_string(level);
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return name;
+}
+
+bool parse_level(const std::string& name, LogLevel& level) {
+    for (int i = static_cast<int>(LogLevel::Trace); i <= static_cast<int>(LogLevel::Fatal); ++i) {
+        auto candidate = static_cast<LogLevel>(i);
+        if (name == level_name(candidate) || name == log_level_to_string(candidate)) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Accepts a JSON array of strings or one comma-separated string (Lua clients)
+std::vector<std::string> string_list(const nlohmann::json& args, const char* key) {
+    std::vector<std::string> values;
+    if (!args.contains(key)) {
+        return values;
+    }
+
+    const auto& field = args[key];
+    if (field.is_array()) {
+        for (const auto& value : field) {
+            if (value.is_string()) {
+                values.push_back(value.get<std::string>());
+            }
+        }
+    } else if (field.is_string()) {
+        std::string text = field.get<std::string>();
+        size_t start = 0;
+        while (start <= text.size()) {
+            size_t comma = text.find(',', start);
+            std::string value = text.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+            value.erase(0, value.find_first_not_of(' '));
+            value.erase(value.find_last_not_of(' ') + 1);
+            if (!value.empty()) {
+                values.push_back(value);
+            }
+            if (comma == std::string::npos) {
+                break;
+            }
+            start = comma + 1;
+        }
+    }
+    return values;
+}
+
+// Session state is saved this often while ACTIVE
+constexpr auto ACTIVE_SAVE_INTERVAL = std::chrono::seconds(30);
+
+/**
+ * @brief Events that drive the lifecycle transition table.
+ */
+enum class LifecycleTrigger {
+    Start,                  // init() called
+    ComponentsReady,        // Config, logging and IPC server are up
+    DiscoveryDone,
+    ValidationPassed,
+    ValidationFailed,
+    GenerationDone,
+    Registered,             // A mod registered, or a registration phase began
+    Timeout,                // The current state's deadline passed
+    SlotConnected,
+    SyncComplete,
+    ChecksumMismatch,
+    ConnectionLost,
+    ReconnectsExhausted,
+    Reconnect,              // cmd_reconnect
+    Resync,                 // cmd_resync
+    Restart,                // cmd_restart
+    Fatal                   // Unrecoverable error reported by the polling thread
+};
+
+const char* lifecycle_trigger_name(LifecycleTrigger trigger) {
+    switch (trigger) {
+        case LifecycleTrigger::Start: return "Start";
+        case LifecycleTrigger::ComponentsReady: return "ComponentsReady";
+        case LifecycleTrigger::DiscoveryDone: return "DiscoveryDone";
+        case LifecycleTrigger::ValidationPassed: return "ValidationPassed";
+        case LifecycleTrigger::ValidationFailed: return "ValidationFailed";
+        case LifecycleTrigger::GenerationDone: return "GenerationDone";
+        case LifecycleTrigger::Registered: return "Registered";
+        case LifecycleTrigger::Timeout: return "Timeout";
+        case LifecycleTrigger::SlotConnected: return "SlotConnected";
+        case LifecycleTrigger::SyncComplete: return "SyncComplete";
+        case LifecycleTrigger::ChecksumMismatch: return "ChecksumMismatch";
+        case LifecycleTrigger::ConnectionLost: return "ConnectionLost";
+        case LifecycleTrigger::ReconnectsExhausted: return "ReconnectsExhausted";
+        case LifecycleTrigger::Reconnect: return "Reconnect";
+        case LifecycleTrigger::Resync: return "Resync";
+        case LifecycleTrigger::Restart: return "Restart";
+        case LifecycleTrigger::Fatal: return "Fatal";
+    }
+    return "Unknown";
+}
+
+} // namespace
+
 class APManager::Impl {
 public:
     Impl() = default;
@@ -29,7 +173,8 @@ public:
     }
 
     int init(lua_State* L) {
-        std::lock_guard<std::mutex> lock(mutex_);
+        // The thread that loads the module runs every update and owns the lifecycle
+        game_thread_id_.store(std::this_thread::get_id());
 
         lua_state_ = L;
         sol::state_view lua(L);
@@ -38,24 +183,43 @@ public:
         APLogger::set_thread_name("Main");
 
         // Transition to INITIALIZATION
-        transition_to_unlocked(LifecycleState::INITIALIZATION, "Starting framework");
+        fire(LifecycleTrigger::Start, "Starting framework");
 
         // Load configuration
         if (!APConfig::instance().load_default()) {
-            APLogger::instance().log(LogLevel::Warn,
-                "Using default configuration");
+            AP_LOG_WARN("Using default configuration");
         }
         config_ = &APConfig::instance();
 
         // Initialize logger with config
+        std::filesystem::path log_path = APPathUtil::get_log_path();
+        std::string binary_log_path;
+        if (!config_->get_logging().binary_file.empty()) {
+            binary_log_path = (log_path.parent_path() / config_->get_logging().binary_file).string();
+        }
         APLogger::instance().init(
             config_->get_log_level(),
-            APPathUtil::get_log_path().string(),
-            config_->get_log_to_console()
+            log_path.string(),
+            config_->get_log_to_console(),
+            binary_log_path
         );
+        if (config_->get_logging().async) {
+            APLogger::instance().enable_async(config_->get_logging());
+        }
+        APLogger::instance().set_history_capacity(
+            static_cast<size_t>(std::max(config_->get_logging().memory_entries, 0)));
+        APLogger::instance().configure_rotation(config_->get_logging());
+        for (const auto& [name, level] : config_->get_logging().component_levels) {
+            LogComponent component = log_component_from_string(name);
+            if (component == LogComponent::None) {
+                AP_LOG_WARN("Unknown log component in config: ", name);
+                continue;
+            }
+            APLogger::instance().set_component_level(component, level);
+        }
+        APTracer::instance().set_enabled(config_->get_logging().trace_enabled);
 
-        APLogger::instance().log(LogLevel::Info,
-            "AP Framework initializing...");
+        AP_LOG_INFO("AP Framework initializing...");
 
         // Create components
         ipc_server_ = std::make_unique<APIPCServer>();
@@ -76,28 +240,18 @@ public:
             ipc_server_->broadcast(msg);
         });
         message_router_->set_ap_location_check_callback([this](const std::vector<int64_t>& ids) {
-            ap_client_->send_location_checks(ids);
+            send_or_queue_location_checks(ids);
         });
         message_router_->set_ap_location_scout_callback([this](const std::vector<int64_t>& ids, bool hints) {
             ap_client_->send_location_scouts(ids, hints);
         });
 
         // Start IPC server
-        std::string game_name = config_->get_game_name();
-        if (game_name.empty()) {
-            game_name = "APFramework";
-        }
-        ipc_server_->start(game_name);
-
-        // Set up IPC message handler
-        ipc_server_->set_message_handler([this](const std::string& client_id, const IPCMessage& msg) {
-            handle_ipc_message(client_id, msg);
-        });
+        ipc_server_->start(framework_game_name());
 
         // Set up connect handler to send current lifecycle state to new clients
         ipc_server_->set_connect_handler([this](const std::string& client_id) {
-            APLogger::instance().log(LogLevel::Trace,
-                "IPC client connected: " + client_id);
+            AP_LOG_TRACE("IPC client connected: ", client_id);
 
             // Send current lifecycle state to newly connected client
             IPCMessage state_msg;
@@ -111,74 +265,16 @@ public:
             ipc_server_->send_message(client_id, state_msg);
         });
 
-        // Transition to DISCOVERY
-        transition_to_unlocked(LifecycleState::DISCOVERY, "Scanning for mods");
-
-        // Discover manifests
-        auto mods_folder = APPathUtil::find_mods_folder();
-        if (mods_folder) {
-            mod_registry_->discover_manifests(*mods_folder);
-        }
-
-        // Add manifests to capabilities
-        for (const auto& manifest : mod_registry_->get_enabled_manifests()) {
-            capabilities_->add_manifest(manifest);
-        }
-
-        // Transition to VALIDATION
-        transition_to_unlocked(LifecycleState::VALIDATION, "Validating capabilities");
-
-        // Validate for conflicts
-        auto validation = capabilities_->validate();
-        if (!validation.valid) {
-            for (const auto& conflict : validation.conflicts) {
-                APLogger::instance().log(LogLevel::Error,
-                    "Conflict: " + conflict.description);
-            }
-            transition_to_unlocked(LifecycleState::ERROR_STATE, "Capability conflicts detected");
-
-            // Still return module to Lua
-            return create_lua_module(L);
-        }
-
-        // Transition to GENERATION
-        transition_to_unlocked(LifecycleState::GENERATION, "Generating capabilities");
-
-        // Assign IDs
-        capabilities_->assign_ids(config_->get_id_base());
-
-        // Compute and store checksum
-        std::string slot_name = config_->get_ap_server().slot_name;
-        std::string checksum = capabilities_->compute_checksum(game_name, slot_name);
-        state_manager_->set_checksum(checksum);
-        state_manager_->set_game_name(game_name);
-        state_manager_->set_slot_name(slot_name);
-
-        // Write capabilities config
-        if (!slot_name.empty()) {
-            capabilities_->write_capabilities_config_default(slot_name, game_name);
-        }
-
-        // Transition to PRIORITY_REGISTRATION
-        transition_to_unlocked(LifecycleState::PRIORITY_REGISTRATION, "Waiting for priority clients");
-        state_entered_at_ = std::chrono::steady_clock::now();
-
-        // Check if any priority clients exist
-        if (mod_registry_->get_priority_clients().empty()) {
-            // No priority clients, skip to REGISTRATION
-            transition_to_unlocked(LifecycleState::REGISTRATION, "No priority clients");
-            state_entered_at_ = std::chrono::steady_clock::now();
-        }
-
-        APLogger::instance().log(LogLevel::Info,
-            "AP Framework initialized successfully");
+        // Entering DISCOVERY starts the init worker: discovery and capability
+        // generation run there and update() applies each stage as it
+        // completes, so loading the module never waits on the modpack's size
+        fire(LifecycleTrigger::ComponentsReady, "Scanning for mods");
 
         return create_lua_module(L);
     }
 
     int update(lua_State* L) {
-        std::lock_guard<std::mutex> lock(mutex_);
-
+        AP_TRACE_SCOPE("APManager::update");
         lua_state_ = L;
 
         // Update cached Lua state for APPathUtil and other components
@@ -190,59 +286,39 @@ public:
             first_update_done_ = true;
         }
 
-        // Process IPC messages
-        ipc_server_->poll();
+        FrameBudget budget(std::chrono::microseconds(config_->get_threading().update_budget_us));
 
-        // Process AP client events
-        if (polling_thread_->is_running()) {
-            polling_thread_->process_events([this](const FrameworkEvent& event) {
-                handle_framework_event(event);
-            });
-        }
-
-        // Handle state-specific logic
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - state_entered_at_).count();
-
-        switch (current_state_.get()) {
-            case LifecycleState::PRIORITY_REGISTRATION:
-                handle_priority_registration(elapsed_ms);
-                break;
-
-            case LifecycleState::REGISTRATION:
-                handle_registration(elapsed_ms);
-                break;
-
-            case LifecycleState::CONNECTING:
-                handle_connecting(elapsed_ms);
-                break;
-
-            case LifecycleState::SYNCING:
-                handle_syncing(elapsed_ms);
-                break;
+        // Requests posted from other threads since the last update
+        run_posted_commands();
 
-            case LifecycleState::ACTIVE:
-                handle_active();
-                break;
-
-            case LifecycleState::RESYNCING:
-                handle_resyncing(elapsed_ms);
-                break;
+        // Control messages are handled now; bulk traffic waits for the budget
+        take_ipc_messages();
 
-            case LifecycleState::ERROR_STATE:
-                // Stay in error state until recovery command
-                break;
+        // Process AP client events
+        process_ap_events(budget);
+        process_deferred_ipc(budget);
+        track_frame_budget(budget);
+        dump_metrics_if_due();
 
-            default:
-                break;
-        }
+        // Lifecycle deadlines that are due, then the current state's checks
+        timers_.run_due();
+        poll_state();
 
         return 0;
     }
 
     void shutdown() {
-        APLogger::instance().log(LogLevel::Info, "AP Framework shutting down...");
+        AP_LOG_INFO("AP Framework shutting down...");
+
+        // The init worker checks between stages whether it was abandoned
+        ++init_generation_;
+        if (init_thread_.joinable()) {
+            init_thread_.join();
+        }
+
+        // No update() will run the requests still queued
+        command_queue_.shutdown();
+        command_queue_.clear();
 
         // Save state
         if (state_manager_) {
@@ -265,7 +341,10 @@ public:
             ipc_server_->stop();
         }
 
-        APLogger::instance().log(LogLevel::Info, "AP Framework shutdown complete");
+        AP_LOG_INFO("AP Framework shutdown complete");
+
+        // Join the log writer here rather than during static destruction
+        APLogger::instance().disable_async();
     }
 
     LifecycleState get_state() const {
@@ -273,8 +352,11 @@ public:
     }
 
     bool transition_to(LifecycleState new_state, const std::string& message) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return transition_to_unlocked(new_state, message);
+        if (!on_game_thread()) {
+            post_command([this, new_state, message]() { request_transition(new_state, message); });
+            return true;
+        }
+        return request_transition(new_state, message);
     }
 
     bool is_active() const {
@@ -287,72 +369,112 @@ public:
     }
 
     bool register_mod(const std::string& mod_id, const std::string& version) {
-        std::lock_guard<std::mutex> lock(mutex_);
+        if (!on_game_thread()) {
+            post_command([this, mod_id, version]() { register_mod(mod_id, version); });
+            return true;
+        }
+
+        if (init_running_) {
+            // The registry is still being built; answer once discovery is done
+            AP_LOG_DEBUG("Holding registration until discovery completes: ", mod_id);
+            early_registrations_.push_back({mod_id, version, false});
+            return true;
+        }
 
         auto state = current_state_.get();
         if (state != LifecycleState::PRIORITY_REGISTRATION &&
             state != LifecycleState::REGISTRATION) {
-            APLogger::instance().log(LogLevel::Warn,
-                "Registration rejected - not in registration phase: " + mod_id);
+            AP_LOG_WARN("Registration rejected - not in registration phase: ", mod_id);
+            send_registration_response(mod_id, false,
+                "Registration rejected: framework in " + lifecycle_state_to_string(state) + " state");
             return false;
         }
 
         if (!mod_registry_->mark_registered(mod_id)) {
-            APLogger::instance().log(LogLevel::Warn,
-                "Unknown mod registration attempt: " + mod_id);
+            AP_LOG_WARN("Unknown mod registration attempt: ", mod_id);
+            send_registration_response(mod_id, false, "Registration rejected: unknown mod_id");
             return false;
         }
 
-        APLogger::instance().log(LogLevel::Info,
-            "Mod registered: " + mod_id + " v" + version);
-
-        // Send registration response
-        IPCMessage response;
-        response.type = IPCMessageType::REGISTRATION_RESPONSE;
-        response.source = IPCTarget::FRAMEWORK;
-        response.target = mod_id;
-        response.payload = {
-            {"success", true},
-            {"mod_id", mod_id}
-        };
-        ipc_server_->send_message(mod_id, response);
+        AP_LOG_INFO("Mod registered: ", mod_id, " v", version);
+        send_registration_response(mod_id, true);
 
+        fire(LifecycleTrigger::Registered);
         return true;
     }
 
     bool register_priority_client(const std::string& mod_id, const std::string& version) {
+        if (!on_game_thread()) {
+            post_command([this, mod_id, version]() { register_priority_client(mod_id, version); });
+            return true;
+        }
+
+        if (init_running_) {
+            AP_LOG_DEBUG("Holding priority registration until discovery completes: ", mod_id);
+            early_registrations_.push_back({mod_id, version, true});
+            return true;
+        }
+
         if (!mod_registry_->is_priority_client(mod_id)) {
-            APLogger::instance().log(LogLevel::Warn,
-                "Non-priority mod tried to register as priority: " + mod_id);
+            AP_LOG_WARN("Non-priority mod tried to register as priority: ", mod_id);
+            send_registration_response(mod_id, false, "Registration rejected: not a priority client");
             return false;
         }
 
         return register_mod(mod_id, version);
     }
 
+    /**
+     * @brief Tell a mod how its registration went.
+     *
+     * Registrations made off the game thread return true once queued, so
+     * this message is the only place a rejection shows up.
+     */
+    void send_registration_response(const std::string& mod_id, bool success, const std::string& reason = "") {
+        IPCMessage response;
+        response.type = IPCMessageType::REGISTRATION_RESPONSE;
+        response.source = IPCTarget::FRAMEWORK;
+        response.target = mod_id;
+        response.payload = {
+            {"success", success},
+            {"mod_id", mod_id}
+        };
+        if (!success) {
+            response.payload["reason"] = reason;
+        }
+        ipc_server_->send_message(mod_id, response);
+    }
+
     void cmd_restart() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        APLogger::instance().log(LogLevel::Info, "Restart command received");
+        if (!on_game_thread()) {
+            post_command([this]() { cmd_restart(); });
+            return;
+        }
+        AP_LOG_INFO("Restart command received");
 
         // Reset state and restart
-        mod_registry_->reset_registrations();
-        transition_to_unlocked(LifecycleState::DISCOVERY, "Restarting");
+        fire(LifecycleTrigger::Restart, "Restarting");
     }
 
     void cmd_resync() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        APLogger::instance().log(LogLevel::Info, "Resync command received");
+        if (!on_game_thread()) {
+            post_command([this]() { cmd_resync(); });
+            return;
+        }
+        AP_LOG_INFO("Resync command received");
 
-        transition_to_unlocked(LifecycleState::RESYNCING, "Manual resync requested");
+        fire(LifecycleTrigger::Resync, "Manual resync requested");
     }
 
     void cmd_reconnect() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        APLogger::instance().log(LogLevel::Info, "Reconnect command received");
+        if (!on_game_thread()) {
+            post_command([this]() { cmd_reconnect(); });
+            return;
+        }
+        AP_LOG_INFO("Reconnect command received");
 
-        ap_client_->disconnect();
-        transition_to_unlocked(LifecycleState::CONNECTING, "Reconnecting to AP server");
-        state_entered_at_ = std::chrono::steady_clock::now();
+        drop_ap_connection();
+        fire(LifecycleTrigger::Reconnect, "Reconnecting to AP server");
     }
 
     APConfig* get_config() { return config_; }
@@ -364,22 +486,29 @@ public:
     APClient* get_ap_client() { return ap_client_.get(); }
 
 private:
-    bool transition_to_unlocked(LifecycleState new_state, const std::string& message) {
-        LifecycleState old_state = current_state_.get();
-        current_state_.set(new_state);
-        state_entered_at_ = std::chrono::steady_clock::now();
-
-        APLogger::instance().log(LogLevel::Info,
-            "State: " + lifecycle_state_to_string(old_state) +
-            " -> " + lifecycle_state_to_string(new_state) +
-            (message.empty() ? "" : " (" + message + ")"));
+    // =========================================================================
+    // Game Thread Ownership
+    // =========================================================================
+
+    bool on_game_thread() const {
+        // Before init() nothing runs on the game thread yet, so act directly
+        std::thread::id owner = game_thread_id_.load();
+        return owner == std::thread::id() || owner == std::this_thread::get_id();
+    }
 
-        // Broadcast lifecycle change
-        if (message_router_) {
-            message_router_->broadcast_lifecycle(new_state, message);
+    void post_command(std::function<void()> command) {
+        if (!command_queue_.push(std::move(command))) {
+            AP_LOG_WARN("Dropped a request posted to the game thread (queue shut down)");
         }
+    }
 
-        return true;
+    void run_posted_commands() {
+        AP_TRACE_SCOPE("posted commands");
+        command_queue_.pop_all(command_buffer_);
+        for (auto& command : command_buffer_) {
+            command();
+        }
+        command_buffer_.clear();
     }
 
     int create_lua_module(lua_State* L) {
@@ -404,9 +533,547 @@ private:
         return sol::stack::push(L, module);
     }
 
+    // =========================================================================
+    // Lifecycle State Machine
+    // =========================================================================
+
+    using Action = void (Impl::*)();
+    using Guard = bool (Impl::*)() const;
+
+    /**
+     * @brief One row of the lifecycle transition table.
+     *
+     * The first row whose source state, trigger and guard match wins. An
+     * internal row runs its action without leaving the current state.
+     */
+    struct Transition {
+        std::optional<LifecycleState> from;     // std::nullopt matches any state
+        LifecycleTrigger trigger;
+        Guard guard;
+        LifecycleState to;
+        Action action = nullptr;                // Runs after the new state is entered
+        const char* note = nullptr;             // Added to the trigger's message
+        bool internal = false;
+    };
+
+    /**
+     * @brief What a state does on entry and while it lasts.
+     */
+    struct StateSpec {
+        LifecycleState state;
+        int TimeoutConfig::* timeout_ms;        // Deadline that fires Timeout; nullptr for none
+        const char* timeout_message;
+        Action on_enter;
+        Action on_update;                       // Checked every update; nullptr for none
+    };
+
+    static const std::vector<Transition>& transitions() {
+        using S = LifecycleState;
+        using T = LifecycleTrigger;
+        constexpr auto ANY = std::nullopt;
+
+        static const std::vector<Transition> table = {
+            {S::UNINITIALIZED, T::Start, nullptr, S::INITIALIZATION},
+            {S::INITIALIZATION, T::ComponentsReady, nullptr, S::DISCOVERY},
+            {S::DISCOVERY, T::DiscoveryDone, nullptr, S::VALIDATION},
+            {S::VALIDATION, T::ValidationPassed, nullptr, S::GENERATION},
+            {S::VALIDATION, T::ValidationFailed, nullptr, S::ERROR_STATE},
+            {S::GENERATION, T::GenerationDone, nullptr, S::PRIORITY_REGISTRATION},
+
+            {S::PRIORITY_REGISTRATION, T::Registered, &Impl::no_priority_clients, S::REGISTRATION,
+                nullptr, "No priority clients"},
+            {S::PRIORITY_REGISTRATION, T::Registered, &Impl::priority_clients_registered, S::REGISTRATION,
+                nullptr, "All priority clients registered"},
+            {S::PRIORITY_REGISTRATION, T::Timeout, nullptr, S::REGISTRATION,
+                &Impl::warn_priority_timeout},
+            {S::REGISTRATION, T::Registered, &Impl::all_mods_registered, S::CONNECTING,
+                nullptr, "All mods registered"},
+            {S::REGISTRATION, T::Timeout, nullptr, S::CONNECTING,
+                &Impl::warn_registration_timeout},
+
+            {S::CONNECTING, T::SlotConnected, nullptr, S::SYNCING,
+                &Impl::note_slot_connected, "Connected to AP server"},
+            {S::CONNECTING, T::Timeout, nullptr, S::ERROR_STATE,
+                &Impl::report_connection_timeout},
+            {S::SYNCING, T::SyncComplete, nullptr, S::ACTIVE,
+                &Impl::start_playing, "Sync complete"},
+            {S::SYNCING, T::ChecksumMismatch, nullptr, S::ERROR_STATE,
+                &Impl::report_checksum_mismatch, "Checksum mismatch"},
+
+            {S::SYNCING, T::ConnectionLost, &Impl::auto_reconnect_enabled, S::RESYNCING,
+                &Impl::prepare_reconnect, "reconnecting"},
+            {S::ACTIVE, T::ConnectionLost, &Impl::auto_reconnect_enabled, S::RESYNCING,
+                &Impl::prepare_reconnect, "reconnecting"},
+            {S::RESYNCING, T::ConnectionLost, nullptr, S::RESYNCING,
+                &Impl::reconnect_attempt_dropped, nullptr, true},
+            {S::RESYNCING, T::SlotConnected, nullptr, S::ACTIVE,
+                &Impl::note_reconnected, "Reconnected"},
+            {S::RESYNCING, T::ReconnectsExhausted, nullptr, S::ERROR_STATE,
+                &Impl::report_reconnects_exhausted},
+
+            // A resync needs a slot to resync against
+            {S::CONNECTING, T::Resync, nullptr, S::RESYNCING, &Impl::prepare_reconnect},
+            {S::SYNCING, T::Resync, nullptr, S::RESYNCING, &Impl::prepare_reconnect},
+            {S::ACTIVE, T::Resync, nullptr, S::RESYNCING, &Impl::prepare_reconnect},
+            {S::RESYNCING, T::Resync, nullptr, S::RESYNCING, &Impl::prepare_reconnect},
+
+            {ANY, T::ConnectionLost, nullptr, S::ERROR_STATE},
+            {ANY, T::Reconnect, nullptr, S::RESYNCING, &Impl::prepare_reconnect},
+            {ANY, T::Restart, nullptr, S::DISCOVERY, &Impl::reset_registrations},
+            {ANY, T::Fatal, nullptr, S::ERROR_STATE},
+        };
+        return table;
+    }
+
+    static const StateSpec* state_spec(LifecycleState state) {
+        using S = LifecycleState;
+
+        static const StateSpec specs[] = {
+            {S::DISCOVERY, nullptr, nullptr, &Impl::start_init_worker, nullptr},
+            {S::PRIORITY_REGISTRATION, &TimeoutConfig::priority_registration_ms, "Priority timeout",
+                &Impl::recheck_registrations, nullptr},
+            {S::REGISTRATION, &TimeoutConfig::registration_ms, "Registration timeout",
+                &Impl::recheck_registrations, nullptr},
+            {S::CONNECTING, &TimeoutConfig::connection_ms, "Connection timeout",
+                &Impl::start_ap_connection, &Impl::poll_slot_connected},
+            {S::SYNCING, nullptr, nullptr, &Impl::sync_session, nullptr},
+            {S::ACTIVE, nullptr, nullptr, &Impl::schedule_state_save, nullptr},
+            {S::RESYNCING, nullptr, nullptr, &Impl::begin_resync, &Impl::poll_slot_connected},
+        };
+        for (const auto& spec : specs) {
+            if (spec.state == state) {
+                return &spec;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Feed a trigger to the transition table.
+     *
+     * Triggers fired while a transition is running (from an action or an
+     * on_enter) are queued and handled once it has finished.
+     */
+    void fire(LifecycleTrigger trigger, const std::string& message = "") {
+        pending_triggers_.emplace_back(trigger, message);
+        drain_triggers();
+    }
+
+    void drain_triggers() {
+        if (dispatching_) {
+            return;
+        }
+
+        dispatching_ = true;
+        while (!pending_triggers_.empty()) {
+            auto [next, next_message] = std::move(pending_triggers_.front());
+            pending_triggers_.pop_front();
+            dispatch(next, next_message);
+        }
+        dispatching_ = false;
+    }
+
+    void dispatch(LifecycleTrigger trigger, const std::string& message) {
+        LifecycleState state = current_state_.get();
+
+        for (const auto& row : transitions()) {
+            if (row.trigger != trigger || (row.from && *row.from != state)) {
+                continue;
+            }
+            if (row.guard && !(this->*row.guard)()) {
+                continue;
+            }
+
+            take(row, message, lifecycle_trigger_name(trigger));
+            return;
+        }
+
+        AP_LOG_DEBUG("Lifecycle: no transition for ", lifecycle_trigger_name(trigger),
+                     " in ", lifecycle_state_to_string(state));
+    }
+
+    void take(const Transition& row, const std::string& message, const char* cause) {
+        ScopedTrace trace(cause);
+        if (!row.internal) {
+            enter_state(row.to, describe(message, row.note), cause);
+        }
+        if (row.action) {
+            (this->*row.action)();
+        }
+        if (!row.internal) {
+            start_state(row.to);
+        }
+    }
+
+    static std::string describe(const std::string& message, const char* note) {
+        if (!note) {
+            return message;
+        }
+        return message.empty() ? std::string(note) : message + ", " + note;
+    }
+
+    /**
+     * @brief The single place the lifecycle state changes.
+     */
+    void enter_state(LifecycleState new_state, const std::string& message, const char* cause) {
+        LifecycleState old_state = current_state_.get();
+
+        // Every timer belongs to the state being left
+        timers_.clear();
+        current_state_.set(new_state);
+        state_entered_at_ = std::chrono::steady_clock::now();
+
+        if (polling_thread_) {
+            polling_thread_->set_lifecycle_state(new_state);
+        }
+
+        AP_LOG_INFO("State: ", lifecycle_state_to_string(old_state), " -> ",
+                    lifecycle_state_to_string(new_state), " on ", cause,
+                    (message.empty() ? "" : " (" + message + ")"));
+
+        // Broadcast lifecycle change
+        if (message_router_) {
+            message_router_->broadcast_lifecycle(new_state, message);
+        }
+    }
+
+    /**
+     * @brief Arm the new state's deadline and run its entry work.
+     */
+    void start_state(LifecycleState state) {
+        const StateSpec* spec = state_spec(state);
+        if (!spec) {
+            return;
+        }
+
+        if (spec->timeout_ms) {
+            auto timeout = std::chrono::milliseconds(config_->get_timeouts().*spec->timeout_ms);
+            const char* timeout_message = spec->timeout_message;
+            timers_.schedule_after(timeout, [this, timeout_message]() {
+                fire(LifecycleTrigger::Timeout, timeout_message);
+            });
+        }
+        if (spec->on_enter) {
+            (this->*spec->on_enter)();
+        }
+    }
+
+    void poll_state() {
+        AP_TRACE_SCOPE("lifecycle");
+        const StateSpec* spec = state_spec(current_state_.get());
+        if (spec && spec->on_update) {
+            (this->*spec->on_update)();
+        }
+    }
+
+    /**
+     * @brief transition_to(): takes the first table row that leads there,
+     *        action included, as if its trigger had fired.
+     */
+    bool request_transition(LifecycleState new_state, const std::string& message) {
+        LifecycleState state = current_state_.get();
+        const auto& table = transitions();
+        auto row = std::find_if(table.begin(), table.end(), [&](const Transition& candidate) {
+            return !candidate.internal && candidate.to == new_state &&
+                   (!candidate.from || *candidate.from == state) &&
+                   (!candidate.guard || (this->*candidate.guard)());
+        });
+        if (row == table.end()) {
+            AP_LOG_WARN("Rejected transition ", lifecycle_state_to_string(state), " -> ",
+                        lifecycle_state_to_string(new_state));
+            return false;
+        }
+
+        AP_LOG_DEBUG("Lifecycle: transition to ", lifecycle_state_to_string(new_state),
+                     " requested, taking the ", lifecycle_trigger_name(row->trigger), " row");
+
+        // Triggers fired by the row's action or on_enter queue up as usual
+        bool nested = dispatching_;
+        dispatching_ = true;
+        take(*row, message, "transition_to");
+        dispatching_ = nested;
+        drain_triggers();
+        return true;
+    }
+
+    // =========================================================================
+    // Asynchronous Initialization
+    // =========================================================================
+
+    /**
+     * @brief Inputs the init worker needs, resolved on the game thread.
+     *
+     * APPathUtil's cache and APConfig belong to the game thread, so the worker
+     * only sees this snapshot.
+     */
+    struct InitJob {
+        std::optional<std::filesystem::path> mods_folder;
+        std::optional<std::filesystem::path> output_folder;
+        std::string game_name;
+        std::string slot_name;
+        int64_t id_base = 0;
+        uint64_t generation = 0;                // Stale once init_generation_ moves on
+        std::chrono::steady_clock::time_point started;
+    };
+
+    /**
+     * @brief Registry and capabilities built by the init worker.
+     */
+    struct InitResult {
+        std::unique_ptr<APModRegistry> mod_registry = std::make_unique<APModRegistry>();
+        std::unique_ptr<APCapabilities> capabilities = std::make_unique<APCapabilities>();
+        std::string checksum;
+        bool valid = true;
+    };
+
+    struct EarlyRegistration {
+        std::string mod_id;
+        std::string version;
+        bool priority = false;
+    };
+
+    std::string framework_game_name() const {
+        std::string game_name = config_->get_game_name();
+        return game_name.empty() ? "APFramework" : game_name;
+    }
+
+    /**
+     * @brief DISCOVERY's on_enter, at startup and after a Restart.
+     */
+    void start_init_worker() {
+        if (init_running_) {
+            // Restarted mid-init: the worker in flight is abandoned at its next
+            // stage, and a fresh one starts once it has exited
+            ++init_generation_;
+            init_restart_pending_ = true;
+            return;
+        }
+
+        InitJob job;
+        job.mods_folder = APPathUtil::find_mods_folder();
+        job.output_folder = APPathUtil::find_output_folder();
+        job.game_name = framework_game_name();
+        job.slot_name = config_->get_ap_server().slot_name;
+        job.id_base = config_->get_id_base();
+        job.generation = ++init_generation_;
+        job.started = std::chrono::steady_clock::now();
+
+        init_running_ = true;
+        init_restart_pending_ = false;
+        init_thread_ = std::thread([this, job = std::move(job)]() { run_init(job); });
+    }
+
+    /**
+     * @brief DISCOVERY through GENERATION, on the init worker.
+     *
+     * Touches no manager state: each finished stage is posted to the game
+     * thread, and the last post, on every path, hands over the result.
+     */
+    void run_init(const InitJob& job) {
+        APLogger::set_thread_name("Init");
+        AP_TRACE_SCOPE("framework init");
+        auto result = std::make_shared<InitResult>();
+        auto finish = [this, &job, &result](bool abandoned) {
+            post_command([this, job, result = abandoned ? nullptr : result]() {
+                finish_init_worker(job, result);
+            });
+        };
+
+        // DISCOVERY
+        if (job.mods_folder) {
+            result->mod_registry->discover_manifests(*job.mods_folder);
+        }
+        for (const auto& manifest : result->mod_registry->get_enabled_manifests()) {
+            result->capabilities->add_manifest(manifest);
+        }
+
+        if (init_abandoned(job)) {
+            finish(true);
+            return;
+        }
+        post_init_stage(job, [this]() {
+            fire(LifecycleTrigger::DiscoveryDone, "Validating capabilities");
+        });
+
+        // VALIDATION
+        auto validation = result->capabilities->validate();
+        if (!validation.valid) {
+            for (const auto& conflict : validation.conflicts) {
+                AP_LOG_ERROR("Conflict: ", conflict.description);
+            }
+            result->valid = false;
+            finish(false);
+            return;
+        }
+
+        if (init_abandoned(job)) {
+            finish(true);
+            return;
+        }
+        post_init_stage(job, [this]() {
+            fire(LifecycleTrigger::ValidationPassed, "Generating capabilities");
+        });
+
+        // GENERATION
+        result->capabilities->assign_ids(job.id_base);
+        result->checksum = result->capabilities->compute_checksum(job.game_name, job.slot_name);
+
+        if (job.output_folder && !job.slot_name.empty()) {
+            auto output_path = *job.output_folder / ("AP_Capabilities_" + job.slot_name + ".json");
+            if (result->capabilities->write_capabilities_config(output_path, job.slot_name, job.game_name)) {
+                AP_LOG_INFO_C(LogComponent::Capabilities,
+                    "Wrote capabilities config: ", output_path.string());
+            }
+        } else if (!job.slot_name.empty()) {
+            AP_LOG_ERROR_C(LogComponent::Capabilities,
+                "Could not find output folder for capabilities config");
+        }
+
+        finish(false);
+    }
+
+    bool init_abandoned(const InitJob& job) const {
+        return init_generation_.load() != job.generation;
+    }
+
+    // Stages of an abandoned worker are dropped when they reach the game thread
+    void post_init_stage(const InitJob& job, std::function<void()> stage) {
+        post_command([this, generation = job.generation, stage = std::move(stage)]() {
+            if (generation == init_generation_.load()) {
+                stage();
+            }
+        });
+    }
+
+    void finish_init_worker(const InitJob& job, const std::shared_ptr<InitResult>& result) {
+        // The worker's last act was posting this command
+        if (init_thread_.joinable()) {
+            init_thread_.join();
+        }
+        init_running_ = false;
+
+        if (!result || init_abandoned(job)) {
+            AP_LOG_DEBUG("Discovery from before the restart abandoned");
+            if (init_restart_pending_ && current_state_.get() == LifecycleState::DISCOVERY) {
+                start_init_worker();
+            }
+            return;
+        }
+
+        adopt_init_result(*result);
+        if (!result->valid) {
+            early_registrations_.clear();
+            fire(LifecycleTrigger::ValidationFailed, "Capability conflicts detected");
+            return;
+        }
+        complete_init(*result, job);
+    }
+
+    void adopt_init_result(InitResult& result) {
+        mod_registry_ = std::move(result.mod_registry);
+        capabilities_ = std::move(result.capabilities);
+        message_router_->set_capabilities(capabilities_.get());
+    }
+
+    void complete_init(InitResult& result, const InitJob& job) {
+        state_manager_->set_checksum(result.checksum);
+        state_manager_->set_game_name(job.game_name);
+        state_manager_->set_slot_name(job.slot_name);
+
+        // Without priority clients this continues straight to REGISTRATION
+        fire(LifecycleTrigger::GenerationDone, "Waiting for priority clients");
+
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - job.started).count();
+        AP_LOG_INFO("AP Framework initialized successfully (", mod_registry_->count(), " mods in ",
+                    elapsed_ms, "ms)");
+
+        // Mods that registered while discovery was running
+        std::vector<EarlyRegistration> early;
+        early.swap(early_registrations_);
+        for (const auto& registration : early) {
+            if (registration.priority) {
+                register_priority_client(registration.mod_id, registration.version);
+            } else {
+                register_mod(registration.mod_id, registration.version);
+            }
+        }
+    }
+
+    // =========================================================================
+    // Frame Budget
+    // =========================================================================
+
+    static bool is_bulk_message(const std::string& type) {
+        return type == IPCMessageType::LOCATION_CHECK || type == IPCMessageType::LOCATION_SCOUT ||
+               type == IPCMessageType::ACTION_RESULT || type == IPCMessageType::LOG;
+    }
+
+    void take_ipc_messages() {
+        AP_TRACE_SCOPE("IPC intake");
+        ipc_server_->get_pending_messages(ipc_intake_);
+        for (auto& msg : ipc_intake_) {
+            if (is_bulk_message(msg.type)) {
+                deferred_messages_.push_back(std::move(msg));
+            } else {
+                handle_ipc_message(msg.source, msg);
+            }
+        }
+        ipc_intake_.clear();
+    }
+
+    void process_deferred_ipc(FrameBudget& budget) {
+        AP_TRACE_SCOPE("deferred IPC");
+        // At least one message per update so a tiny budget still drains
+        bool first = true;
+        while (!deferred_messages_.empty() && (first || budget.has_time())) {
+            IPCMessage msg = std::move(deferred_messages_.front());
+            deferred_messages_.pop_front();
+            handle_ipc_message(msg.source, msg);
+            first = false;
+        }
+    }
+
+    void process_ap_events(FrameBudget& budget) {
+        AP_TRACE_SCOPE("AP events");
+        if (!polling_thread_->is_running()) {
+            return;
+        }
+
+        // A batch routed in part stays at the front of the queue, so the
+        // events behind it wait until all of its items are out
+        size_t processed = 0;
+        polling_thread_->process_events(
+            [this, &budget, &processed](const FrameworkEvent& event) {
+                ++processed;
+                return handle_framework_event(event, &budget);
+            },
+            [&]() { return processed == 0 || budget.has_time(); });
+    }
+
+    void track_frame_budget(const FrameBudget& budget) {
+        if (budget.spent()) {
+            ++updates_over_budget_;
+        }
+
+        size_t backlog = deferred_messages_.size() + batch_items_left_;
+        if (budget.spent() && polling_thread_->is_running()) {
+            backlog += polling_thread_->get_event_queue().size();
+        }
+
+        if (backlog > 0) {
+            if (deferred_updates_++ == 0) {
+                AP_LOG_DEBUG("Update budget spent after ", budget.elapsed().count(), "us, deferring ",
+                             backlog, " queued messages/items/events");
+            }
+        } else if (deferred_updates_ > 0) {
+            AP_LOG_INFO("Deferred update work drained after ", deferred_updates_, " updates");
+            deferred_updates_ = 0;
+        }
+    }
+
     void handle_ipc_message(const std::string& client_id, const IPCMessage& msg) {
-        APLogger::instance().log(LogLevel::Debug,
-            "IPC message from " + client_id + ": " + msg.type);
+        AP_LOG_FMT(LogLevel::Debug, LogComponent::IPC, "Message from {}: {}", client_id, msg.type);
 
         if (msg.type == IPCMessageType::REGISTER) {
             std::string mod_id = msg.payload.value("mod_id", "");
@@ -428,22 +1095,25 @@ private:
             message_router_->route_location_scouts(client_id, locations, false);
         }
         else if (msg.type == IPCMessageType::ACTION_RESULT) {
-            ActionResult result;
-            result.mod_id = client_id;
-            result.item_id = msg.payload.value("item_id", 0LL);
-            result.item_name = msg.payload.value("item_name", "");
-            result.success = msg.payload.value("success", false);
-            result.error = msg.payload.value("error", "");
-            message_router_->handle_action_result(client_id, result);
+            // Replies to EXECUTE_ACTIONS carry a "results" array
+            if (msg.payload.contains("results") && msg.payload["results"].is_array()) {
+                std::vector<ActionResult> results;
+                results.reserve(msg.payload["results"].size());
+                for (const auto& entry : msg.payload["results"]) {
+                    results.push_back(parse_action_result(client_id, entry));
+                }
+                message_router_->handle_action_results(client_id, results);
+            } else {
+                message_router_->handle_action_result(client_id, parse_action_result(client_id, msg.payload));
+            }
         }
         else if (msg.type == IPCMessageType::LOG) {
             std::string level_str = msg.payload.value("level", "info");
-            std::string message = msg.payload.value("message", "");
             LogLevel level = LogLevel::Info;
             if (level_str == "debug") level = LogLevel::Debug;
             else if (level_str == "warn") level = LogLevel::Warn;
             else if (level_str == "error") level = LogLevel::Error;
-            APLogger::instance().log(level, "[" + client_id + "] " + message);
+            AP_LOG_C(level, LogComponent::LuaClient, "[", client_id, "] ", msg.payload.value("message", ""));
         }
         // Priority client commands
         else if (msg.type == IPCMessageType::CMD_RESTART) {
@@ -462,21 +1132,45 @@ private:
             }
         }
         // Generic command system
+        else if (msg.type == IPCMessageType::GET_LOGS) {
+            if (mod_registry_->is_priority_client(client_id)) {
+                IPCMessage response;
+                response.type = IPCMessageType::GET_LOGS_RESPONSE;
+                response.source = IPCTarget::FRAMEWORK;
+                response.target = client_id;
+                response.payload = get_logs(msg.payload);
+                ipc_server_->send_message(client_id, response);
+            }
+        }
         else if (msg.type == IPCMessageType::COMMAND) {
             handle_command(client_id, msg);
         }
     }
 
+    static ActionResult parse_action_result(const std::string& client_id, const nlohmann::json& payload) {
+        ActionResult result;
+        result.mod_id = client_id;
+        result.item_id = payload.value("item_id", 0LL);
+        result.item_name = payload.value("item_name", "");
+        result.success = payload.value("success", false);
+        result.error = payload.value("error", "");
+
+        // Client mods time each action on the same steady clock
+        if (payload.contains("duration_us")) {
+            APTracer::instance().record_external("mod:" + client_id, result.item_name,
+                payload.value("started_us", int64_t(0)), payload.value("duration_us", int64_t(0)));
+        }
+        return result;
+    }
+
     void handle_command(const std::string& client_id, const IPCMessage& msg) {
         std::string command = msg.payload.value("command", "");
 
-        APLogger::instance().log(LogLevel::Debug,
-            "Command received from " + client_id + ": " + command);
+        AP_LOG_DEBUG("Command received from ", client_id, ": ", command);
 
         // Verify priority client status
         if (!mod_registry_->is_priority_client(client_id)) {
-            APLogger::instance().log(LogLevel::Warn,
-                "Command rejected - not a priority client: " + client_id);
+            AP_LOG_WARN("Command rejected - not a priority client: ", client_id);
 
             IPCMessage response;
             response.type = IPCMessageType::COMMAND_RESPONSE;
@@ -515,10 +1209,18 @@ private:
                 {"success", true},
                 {"data", {
                     {"state", lifecycle_state_to_string(current_state_.get())},
+                    {"state_ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - state_entered_at_).count()},
+                    {"lifecycle_timers", timers_.size()},
                     {"connected_clients", ipc_server_->get_client_count()},
                     {"ap_connected", ap_client_ ? ap_client_->is_slot_connected() : false},
+                    {"pending_location_checks", state_manager_->get_pending_location_check_count()},
                     {"registered_mods", registered},
-                    {"total_mods", total}
+                    {"total_mods", total},
+                    {"deferred_ipc_messages", deferred_messages_.size()},
+                    {"deferred_items", batch_items_left_},
+                    {"deferred_events", polling_thread_->get_event_queue().size()},
+                    {"updates_over_budget", updates_over_budget_}
                 }}
             };
         }
@@ -538,6 +1240,30 @@ private:
                 {"data", {{"mods", mods_arr}}}
             };
         }
+        else if (command == "get_logs") {
+            result = {
+                {"success", true},
+                {"data", get_logs(msg.payload.value("payload", nlohmann::json::object()))}
+            };
+        }
+        else if (command == "set_log_level") {
+            result = set_log_level(msg.payload.value("payload", nlohmann::json::object()));
+        }
+        else if (command == "get_log_levels") {
+            result = {
+                {"success", true},
+                {"data", log_levels()}
+            };
+        }
+        else if (command == "metrics") {
+            result = {
+                {"success", true},
+                {"data", metrics_snapshot()}
+            };
+        }
+        else if (command == "trace") {
+            result = trace_command(msg.payload.value("payload", nlohmann::json::object()));
+        }
         else {
             result = {
                 {"success", false},
@@ -555,22 +1281,215 @@ private:
         ipc_server_->send_message(client_id, response);
     }
 
-    void handle_framework_event(const FrameworkEvent& event) {
-        std::visit([this](auto&& arg) {
+    /**
+     * @brief One page of the in-memory log history.
+     *
+     * Arguments (all optional): after (sequence cursor), newest, limit,
+     * min_level, levels, components (or mod_ids), compress. Pass the returned
+     * "next" as "after" to continue; "more" says whether another page exists.
+     * With compress, "logs" is the zlib-compressed JSON array in base64.
+     */
+    nlohmann::json get_logs(const nlohmann::json& args) {
+        LogQuery query;
+        query.after = args.value("after", uint64_t{0});
+        query.newest = args.value("newest", false);
+        query.limit = std::clamp<size_t>(args.value("limit", size_t{100}), 1, GET_LOGS_MAX_ENTRIES);
+        query.max_bytes = GET_LOGS_MAX_BYTES;
+        query.min_level = log_level_from_string(args.value("min_level", "trace"), LogLevel::Trace);
+        for (const auto& level : string_list(args, "levels")) {
+            query.levels.insert(log_level_from_string(level, LogLevel::Info));
+        }
+        for (const auto& component : string_list(args, "components")) {
+            query.components.insert(component);
+        }
+        for (const auto& mod_id : string_list(args, "mod_ids")) {
+            query.components.insert(mod_id);
+        }
+
+        LogPage page = APLogger::instance().query_logs(query);
+
+        nlohmann::json logs = nlohmann::json::array();
+        for (const auto& entry : page.entries) {
+            logs.push_back({
+                {"seq", entry.sequence},
+                {"timestamp", format_utc_timestamp(entry.time)},
+                {"level", level_name(entry.level)},
+                {"thread", entry.thread},
+                {"source", entry.component.empty() ? IPCTarget::FRAMEWORK : entry.component},
+                {"message", entry.message}
+            });
+        }
+
+        nlohmann::json data = {
+            {"returned", page.entries.size()},
+            {"total", page.first_sequence > 0 ? page.last_sequence - page.first_sequence + 1 : 0},
+            {"first", page.first_sequence},
+            {"latest", page.last_sequence},
+            {"next", page.entries.empty() ? std::max(query.after, page.last_sequence)
+                                          : page.entries.back().sequence},
+            {"more", page.more}
+        };
+
+        std::string packed;
+        if (args.value("compress", false) &&
+            CompressionUtil::zlib_compress(logs.dump(), packed)) {
+            data["encoding"] = "zlib+base64";
+            data["logs"] = CompressionUtil::base64_encode(packed);
+        } else {
+            data["logs"] = std::move(logs);
+        }
+        return data;
+    }
+
+    /**
+     * @brief Change the global level or one component's level at runtime.
+     *
+     * Arguments: level (trace..fatal, or "inherit" to make the component
+     * follow the global level again) and optional component (IPC, Router,
+     * Capabilities, Polling, LuaClient). Without a component the global level
+     * changes. Replies with the resulting levels.
+     */
+    nlohmann::json set_log_level(const nlohmann::json& args) {
+        std::string name = args.value("component", "");
+        std::string level_str = args.value("level", "");
+        auto& logger = APLogger::instance();
+
+        LogComponent component = log_component_from_string(name);
+        if (!name.empty() && component == LogComponent::None) {
+            return {{"success", false}, {"error", "Unknown log component: " + name}};
+        }
+
+        LogLevel level = LogLevel::Info;
+        if (level_str == "inherit" && !name.empty()) {
+            logger.clear_component_level(component);
+        } else if (!parse_level(level_str, level)) {
+            return {{"success", false}, {"error", "Invalid log level: " + level_str}};
+        } else if (name.empty()) {
+            logger.set_min_level(level);
+        } else {
+            logger.set_component_level(component, level);
+        }
+
+        AP_LOG_INFO("Log level ", name.empty() ? "global" : name, " set to ", level_str);
+        return {{"success", true}, {"data", log_levels()}};
+    }
+
+    nlohmann::json log_levels() const {
+        auto& logger = APLogger::instance();
+        nlohmann::json components = nlohmann::json::object();
+        for (size_t i = 0; i < LOG_COMPONENT_COUNT; ++i) {
+            auto component = static_cast<LogComponent>(i);
+            auto level = logger.get_component_level(component);
+            components[log_component_to_string(component)] = level ? level_name(*level) : "inherit";
+        }
+        return {
+            {"global", level_name(logger.get_min_level())},
+            {"components", std::move(components)}
+        };
+    }
+
+    // =========================================================================
+    // Metrics
+    // =========================================================================
+
+    /**
+     * @brief Refresh the queue depth gauges and merge all metric shards.
+     *
+     * Gauges are sampled here rather than every update, so reading them costs
+     * nothing on frames nobody looks at.
+     */
+    nlohmann::json metrics_snapshot() {
+        queue_events_.set(static_cast<int64_t>(polling_thread_->get_event_queue().size()));
+        queue_ipc_deferred_.set(static_cast<int64_t>(deferred_messages_.size()));
+        queue_items_pending_.set(static_cast<int64_t>(batch_items_left_));
+        queue_location_checks_offline_.set(
+            static_cast<int64_t>(state_manager_->get_pending_location_check_count()));
+
+        return APMetrics::instance().snapshot();
+    }
+
+    /**
+     * @brief Control the scoped-timer tracer.
+     *
+     * {"action": "start"} clears and enables it, "stop" disables it, and
+     * "export" writes a Chrome trace next to the log file.
+     */
+    nlohmann::json trace_command(const nlohmann::json& args) {
+        std::string action = args.value("action", "");
+        auto& tracer = APTracer::instance();
+
+        if (action == "start") {
+            tracer.clear();
+            tracer.set_enabled(true);
+            AP_LOG_INFO("Tracing started");
+        } else if (action == "stop") {
+            tracer.set_enabled(false);
+            AP_LOG_INFO("Tracing stopped");
+        } else if (action == "export") {
+            std::filesystem::path path = APPathUtil::get_log_path().parent_path() /
+                ("ap_trace_" + std::to_string(std::time(nullptr)) + ".json");
+
+            long events = tracer.write_chrome_trace(path);
+            if (events < 0) {
+                return {{"success", false}, {"error", "Could not write " + path.string()}};
+            }
+            AP_LOG_INFO("Wrote ", events, " trace events to ", path.string());
+            return {{"success", true}, {"data", {{"path", path.string()}, {"events", events}}}};
+        } else {
+            return {{"success", false}, {"error", "action must be start, stop or export"}};
+        }
+
+        return {{"success", true}, {"data", {{"enabled", tracer.is_enabled()}}}};
+    }
+
+    void dump_metrics_if_due() {
+        int interval_s = config_->get_logging().metrics_interval_s;
+        if (interval_s <= 0) {
+            return;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_metrics_dump_ < std::chrono::seconds(interval_s)) {
+            return;
+        }
+        last_metrics_dump_ = now;
+        AP_LOG_INFO("Metrics: ", metrics_snapshot().dump());
+    }
+
+    /**
+     * @brief Handle one AP event in place in its queue slot.
+     * @param budget Spreads an item batch over updates; nullptr routes it in full.
+     * @return false if an item batch is only partly routed and stays queued.
+     */
+    bool handle_framework_event(const FrameworkEvent& event, FrameBudget* budget) {
+        return std::visit([this, budget](auto&& arg) {
             using T = std::decay_t<decltype(arg)>;
 
             if constexpr (std::is_same_v<T, ItemReceivedEvent>) {
-                message_router_->route_item_receipt(arg.item_id, arg.item_name, arg.sender);
-                state_manager_->increment_received_item_index();
-                state_manager_->save_state();
+                route_items(&arg, 1);
+                finish_item_batch(1);
+            }
+            else if constexpr (std::is_same_v<T, ItemBatchReceivedEvent>) {
+                return route_item_batch(arg, budget);
             }
             else if constexpr (std::is_same_v<T, LocationScoutEvent>) {
                 // Scout results handled in message router
             }
             else if constexpr (std::is_same_v<T, LifecycleEvent>) {
                 // State changes from polling thread
-                if (arg.new_state == LifecycleState::ERROR_STATE) {
-                    transition_to_unlocked(LifecycleState::ERROR_STATE, arg.message);
+                if (arg.new_state == LifecycleState::CONNECTING) {
+                    // Marker queued after a connection reset (see drop_ap_connection())
+                    connection_resets_pending_ = std::max(connection_resets_pending_ - 1, 0);
+                }
+                else if (arg.new_state == LifecycleState::RESYNCING) {
+                    if (connection_resets_pending_ > 0) {
+                        AP_LOG_DEBUG("Ignoring disconnect from a replaced connection");
+                    } else {
+                        fire(LifecycleTrigger::ConnectionLost, arg.message);
+                    }
+                }
+                else if (arg.new_state == LifecycleState::ERROR_STATE) {
+                    fire(LifecycleTrigger::Fatal, arg.message);
                 }
             }
             else if constexpr (std::is_same_v<T, ErrorEvent>) {
@@ -579,80 +1498,211 @@ private:
             else if constexpr (std::is_same_v<T, APMessageEvent>) {
                 message_router_->broadcast_ap_message(arg.type, arg.message);
             }
+            return true;
         }, event);
     }
 
-    void handle_priority_registration(int64_t elapsed_ms) {
-        // Check if all priority clients registered
-        auto priority_clients = mod_registry_->get_priority_clients();
-        bool all_priority_registered = true;
-        for (const auto& mod_id : priority_clients) {
-            if (!mod_registry_->is_registered(mod_id)) {
-                all_priority_registered = false;
-                break;
-            }
+    /**
+     * @brief Route an item batch straight from its queue slot, in chunks of
+     *        update_item_chunk while the budget lasts.
+     * @param budget nullptr routes the whole batch at once.
+     * @return true once every item is routed. false leaves the batch at the
+     *         front of the queue; routing resumes at batch_items_routed_.
+     */
+    bool route_item_batch(const ItemBatchReceivedEvent& batch, FrameBudget* budget) {
+        size_t total = batch.items.size();
+        size_t chunk = budget
+            ? static_cast<size_t>(std::max(config_->get_threading().update_item_chunk, 1))
+            : total;
+
+        do {
+            size_t begin = batch_items_routed_;
+            size_t end = std::min(total, begin + chunk);
+            route_items(batch.items.data() + begin, end - begin);
+            batch_items_routed_ = end;
+        } while (batch_items_routed_ < total && (!budget || budget->has_time()));
+
+        if (batch_items_routed_ < total) {
+            batch_items_left_ = total - batch_items_routed_;
+            return false;
         }
+        finish_item_batch(total);
+        return true;
+    }
 
-        if (all_priority_registered) {
-            transition_to_unlocked(LifecycleState::REGISTRATION, "All priority clients registered");
-            state_entered_at_ = std::chrono::steady_clock::now();
-            return;
+    /**
+     * @brief Every item of the batch is routed: save the received index once
+     *        for the whole batch and reset for the next one.
+     */
+    void finish_item_batch(size_t total) {
+        if (total > 1) {
+            AP_LOG_INFO("Received item batch: ", batch_new_items_, " new, ",
+                        total - batch_new_items_, " already applied");
         }
-
-        // Check timeout
-        if (elapsed_ms >= config_->get_timeouts().priority_registration_ms) {
-            APLogger::instance().log(LogLevel::Warn,
-                "Priority registration timeout, continuing anyway");
-            transition_to_unlocked(LifecycleState::REGISTRATION, "Priority timeout");
-            state_entered_at_ = std::chrono::steady_clock::now();
+        if (items_unsaved_) {
+            state_manager_->save_state();
+            items_unsaved_ = false;
         }
+        batch_items_routed_ = 0;
+        batch_items_left_ = 0;
+        batch_new_items_ = 0;
+        item_progression_counts_.clear();
     }
 
-    void handle_registration(int64_t elapsed_ms) {
-        // Check if all mods registered
-        if (mod_registry_->all_registered()) {
-            transition_to_unlocked(LifecycleState::CONNECTING, "All mods registered");
-            state_entered_at_ = std::chrono::steady_clock::now();
-            start_ap_connection();
+    void route_items(const ItemReceivedEvent* items, size_t count) {
+        AP_TRACE_SCOPE("route items");
+        ensure_state_loaded();
+
+        // After a failed send nothing past the missed item is routed or saved;
+        // the next connection replays the history from there
+        if (undelivered_item_index_ >= 0) {
+            AP_LOG_DEBUG("Holding back ", count, " items until item ", undelivered_item_index_,
+                         " is replayed");
             return;
         }
 
-        // Check timeout
-        if (elapsed_ms >= config_->get_timeouts().registration_ms) {
-            auto pending = mod_registry_->get_pending_registrations();
-            APLogger::instance().log(LogLevel::Warn,
-                "Registration timeout. Pending: " + std::to_string(pending.size()) + " mods");
-            transition_to_unlocked(LifecycleState::CONNECTING, "Registration timeout");
-            state_entered_at_ = std::chrono::steady_clock::now();
-            start_ap_connection();
+        // received_item_index is the number of items already applied, so
+        // every item below it was handled before this (re)connect
+        int applied = state_manager_->get_received_item_index();
+        auto already_applied = [applied](const ItemReceivedEvent& item) {
+            return item.index >= 0 && item.index < applied;
+        };
+
+        // New items are routed in place, one run between skipped items at a
+        // time. A batch split across updates keeps one progression count per item
+        size_t sent_end = count;
+        size_t run_begin = 0;
+        auto route_run = [&](size_t run_end) {
+            if (run_end == run_begin) {
+                return true;
+            }
+            // Always through the batch path, even for one item: a batch routed
+            // one item per chunk must still record its progression counts
+            size_t delivered = 0;
+            message_router_->route_item_receipts(items + run_begin, run_end - run_begin,
+                                                 &item_progression_counts_, &delivered);
+            if (delivered < run_end - run_begin) {
+                sent_end = run_begin + delivered;
+                return false;
+            }
+            return true;
+        };
+
+        bool all_sent = true;
+        for (size_t i = 0; i < count && all_sent; ++i) {
+            if (already_applied(items[i])) {
+                all_sent = route_run(i);
+                run_begin = i + 1;
+            }
+        }
+        if (all_sent) {
+            route_run(count);
         }
-    }
 
-    void handle_connecting(int64_t elapsed_ms) {
-        // Check if connected
-        if (ap_client_->is_slot_connected()) {
-            transition_to_unlocked(LifecycleState::SYNCING, "Connected to AP server");
-            state_entered_at_ = std::chrono::steady_clock::now();
-            return;
+        // Only items whose message was sent count as applied
+        int next_index = applied;
+        size_t fresh = 0;
+        auto routed_at = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < sent_end; ++i) {
+            if (already_applied(items[i])) {
+                continue;
+            }
+            next_index = items[i].index >= 0 ? std::max(next_index, items[i].index + 1) : next_index + 1;
+            ++fresh;
+            if (items[i].received_at != std::chrono::steady_clock::time_point{}) {
+                item_route_latency_.record_duration(routed_at - items[i].received_at);
+            }
         }
 
-        // Check timeout
-        if (elapsed_ms >= config_->get_timeouts().connection_ms) {
-            transition_to_unlocked(LifecycleState::ERROR_STATE, "Connection timeout");
-            message_router_->broadcast_error(
-                ErrorCode::CONNECTION_FAILED,
-                "Failed to connect to AP server",
-                "Connection timed out"
-            );
+        if (fresh > 0) {
+            items_routed_.add(fresh);
+
+            // Saved once the whole batch is routed, not per chunk
+            state_manager_->set_received_item_index(next_index);
+            items_unsaved_ = true;
+        }
+        batch_new_items_ += fresh;
+
+        if (sent_end < count) {
+            undelivered_item_index_ = next_index;
+            AP_LOG_WARN("Could not send item ", next_index, " to its mod; it and later items are "
+                        "routed again on the next connection");
         }
     }
 
-    void handle_syncing(int64_t elapsed_ms) {
-        // Load existing state if available
+    void ensure_state_loaded() {
+        // Items replayed right after Connected can arrive before SYNCING runs
         if (!state_loaded_) {
             state_manager_->load_state();
             state_loaded_ = true;
         }
+    }
+
+    // =========================================================================
+    // Lifecycle Guards and Actions (see transitions())
+    // =========================================================================
+
+    bool no_priority_clients() const {
+        return mod_registry_->get_priority_clients().empty();
+    }
+
+    bool priority_clients_registered() const {
+        for (const auto& mod_id : mod_registry_->get_priority_clients()) {
+            if (!mod_registry_->is_registered(mod_id)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool all_mods_registered() const {
+        return mod_registry_->all_registered();
+    }
+
+    bool auto_reconnect_enabled() const {
+        return config_->get_ap_server().auto_reconnect;
+    }
+
+    void recheck_registrations() {
+        // Mods may all have registered before this phase began
+        fire(LifecycleTrigger::Registered);
+    }
+
+    void reset_registrations() {
+        mod_registry_->reset_registrations();
+    }
+
+    void warn_priority_timeout() {
+        AP_LOG_WARN("Priority registration timeout, continuing anyway");
+    }
+
+    void warn_registration_timeout() {
+        auto pending = mod_registry_->get_pending_registrations();
+        AP_LOG_WARN("Registration timeout. Pending: ", pending.size(), " mods");
+    }
+
+    void poll_slot_connected() {
+        // Until a reset is done, a connected slot may still be the old one
+        if (connection_resets_pending_ == 0 && ap_client_->is_slot_connected()) {
+            fire(LifecycleTrigger::SlotConnected);
+        }
+    }
+
+    void note_slot_connected() {
+        slot_connected_at_ = std::chrono::steady_clock::now();
+    }
+
+    void report_connection_timeout() {
+        message_router_->broadcast_error(
+            ErrorCode::CONNECTION_FAILED,
+            "Failed to connect to AP server",
+            "Connection timed out"
+        );
+    }
+
+    void sync_session() {
+        // Load existing state if available
+        ensure_state_loaded();
 
         // Validate checksum
         std::string current_checksum = capabilities_->compute_checksum(
@@ -661,12 +1711,7 @@ private:
         );
 
         if (!state_manager_->validate_checksum(current_checksum)) {
-            transition_to_unlocked(LifecycleState::ERROR_STATE, "Checksum mismatch");
-            message_router_->broadcast_error(
-                ErrorCode::CHECKSUM_MISMATCH,
-                "Mod ecosystem changed since generation",
-                "Please regenerate the AP World"
-            );
+            fire(LifecycleTrigger::ChecksumMismatch);
             return;
         }
 
@@ -675,53 +1720,199 @@ private:
             state_manager_->set_checksum(current_checksum);
         }
 
-        // Sync complete
-        transition_to_unlocked(LifecycleState::ACTIVE, "Sync complete");
+        fire(LifecycleTrigger::SyncComplete);
+    }
+
+    void report_checksum_mismatch() {
+        message_router_->broadcast_error(
+            ErrorCode::CHECKSUM_MISMATCH,
+            "Mod ecosystem changed since generation",
+            "Please regenerate the AP World"
+        );
+    }
+
+    void start_playing() {
         ap_client_->send_status_update(ClientStatus::Playing);
+        flush_offline_location_checks();
     }
 
-    void handle_active() {
-        // Normal operation - events are processed in update()
-        // Periodically save state
-        static auto last_save = std::chrono::steady_clock::now();
-        auto now = std::chrono::steady_clock::now();
-        if (std::chrono::duration_cast<std::chrono::seconds>(now - last_save).count() >= 30) {
+    void schedule_state_save() {
+        timers_.schedule_after(ACTIVE_SAVE_INTERVAL, [this]() {
             state_manager_->touch();
             state_manager_->save_state();
-            last_save = now;
+            schedule_state_save();
+        });
+    }
+
+    void prepare_reconnect() {
+        // Persist progress so the replayed item history resumes at received_item_index
+        if (state_loaded_) {
+            state_manager_->touch();
+            state_manager_->save_state();
+        }
+
+        RetryPolicy policy = RetryPolicy::from_config(config_->get_retry());
+        policy.max_retries = config_->get_ap_server().reconnect_max_attempts;
+        reconnect_backoff_ = BackoffSchedule(policy);
+    }
+
+    void begin_resync() {
+        reconnect_attempt_timer_ = 0;
+
+        // A manual resync while still connected has nothing to reconnect
+        if (connection_resets_pending_ == 0 && ap_client_->is_slot_connected()) {
+            fire(LifecycleTrigger::SlotConnected);
+            return;
+        }
+        schedule_reconnect_attempt();
+    }
+
+    void schedule_reconnect_attempt() {
+        reconnect_attempt_timer_ = 0;
+
+        // Drop the dead client so apclientpp stops retrying on its own schedule
+        drop_ap_connection();
+
+        auto delay = reconnect_backoff_.schedule();
+        if (!delay) {
+            fire(LifecycleTrigger::ReconnectsExhausted,
+                "Reconnection failed after " + std::to_string(reconnect_backoff_.attempts()) + " attempts");
+            return;
+        }
+
+        AP_LOG_INFO("Reconnecting in ", delay->count(), "ms (attempt ",
+                    reconnect_backoff_.attempts() + 1, ")");
+        timers_.schedule_after(*delay, [this]() { start_reconnect_attempt(); });
+    }
+
+    void start_reconnect_attempt() {
+        reconnect_backoff_.begin_attempt();
+        start_ap_connection();
+
+        // Give the attempt the normal connection timeout
+        auto timeout = std::chrono::milliseconds(config_->get_timeouts().connection_ms);
+        reconnect_attempt_timer_ = timers_.schedule_after(timeout, [this]() {
+            AP_LOG_WARN("Reconnect attempt ", reconnect_backoff_.attempts(), " timed out");
+            schedule_reconnect_attempt();
+        });
+    }
+
+    void reconnect_attempt_dropped() {
+        // The attempt in flight dropped; back off before the next one
+        if (reconnect_attempt_timer_ == 0) {
+            return;
+        }
+        timers_.cancel(reconnect_attempt_timer_);
+        schedule_reconnect_attempt();
+    }
+
+    void note_reconnected() {
+        if (reconnect_backoff_.attempts() > 0) {
+            AP_LOG_INFO("Reconnected after ", reconnect_backoff_.attempts(), " attempt(s)");
+        }
+        reconnect_backoff_.reset();
+        slot_connected_at_ = std::chrono::steady_clock::now();
+        flush_offline_location_checks();
+    }
+
+    void report_reconnects_exhausted() {
+        message_router_->broadcast_error(
+            ErrorCode::CONNECTION_FAILED,
+            "Lost connection to AP server",
+            "Reconnect attempts exhausted"
+        );
+    }
+
+    // =========================================================================
+    // AP Connection
+    // =========================================================================
+
+    void send_or_queue_location_checks(const std::vector<int64_t>& ids) {
+        if (ap_client_->send_location_checks(ids)) {
+            return;
         }
+
+        // Offline: keep the checks with the session state until the slot is back
+        ensure_state_loaded();
+        state_manager_->add_pending_location_checks(ids);
+        state_manager_->save_state();
+
+        AP_LOG_INFO("Queued ", ids.size(), " location check(s) while offline (",
+            state_manager_->get_pending_location_check_count(), " pending)");
     }
 
-    void handle_resyncing(int64_t elapsed_ms) {
-        // Similar to CONNECTING but for reconnection
-        if (ap_client_->is_slot_connected()) {
-            transition_to_unlocked(LifecycleState::ACTIVE, "Reconnected");
+    void flush_offline_location_checks() {
+        auto pending = state_manager_->get_pending_location_checks();
+        if (pending.empty()) {
             return;
         }
 
-        // Try to reconnect
-        if (!reconnect_attempted_) {
-            start_ap_connection();
-            reconnect_attempted_ = true;
+        auto queued_at = state_manager_->get_pending_since();
+
+        // One deduplicated LocationChecks packet for the whole outage
+        if (!ap_client_->send_location_checks(pending)) {
+            return;
         }
+        state_manager_->clear_pending_location_checks();
+        state_manager_->save_state();
+        location_check_flush_size_.record(pending.size());
+
+        auto since_connect_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - slot_connected_at_).count();
+        auto oldest_wait_s = queued_at
+            ? std::chrono::duration_cast<std::chrono::seconds>(
+                  std::chrono::system_clock::now() - *queued_at).count()
+            : 0;
+
+        AP_LOG_INFO("Flushed ", pending.size(), " offline location check(s) ", since_connect_ms,
+                    "ms after connecting (oldest queued ", oldest_wait_s, "s ago)");
+    }
 
-        // Check timeout
-        if (elapsed_ms >= config_->get_timeouts().connection_ms * 2) {
-            transition_to_unlocked(LifecycleState::ERROR_STATE, "Reconnection failed");
+    /**
+     * @brief Drop the AP connection without blocking the game thread.
+     *
+     * The polling thread keeps running and resets the client between two
+     * polls. Until its reset marker arrives, disconnect events and a
+     * connected slot belong to the old connection and are ignored.
+     */
+    void drop_ap_connection() {
+        if (!polling_thread_->is_running()) {
+            ap_client_->disconnect();
+            return;
         }
+        ++connection_resets_pending_;
+        polling_thread_->reset_connection();
     }
 
     void start_ap_connection() {
         const auto& ap_config = config_->get_ap_server();
 
+        // A new connection replays the received items, including any not sent
+        undelivered_item_index_ = -1;
+
         // Generate UUID for this client
         std::string uuid = "APFramework_" + std::to_string(
             std::chrono::system_clock::now().time_since_epoch().count()
         );
 
+        // Everything the polling thread needs is copied here, on the game thread
+        auto connect = [server = ap_config.server, port = ap_config.port, game = config_->get_game_name(),
+                        uuid, cache = APPathUtil::get_data_package_cache_path()](APClient& client) {
+            // Cached data package games are loaded first
+            client.set_data_package_cache_folder(cache);
+            client.connect(server, port, game, uuid);
+        };
+
+        // Reconnect: swap the connection on the running polling thread
+        if (polling_thread_->is_running()) {
+            ++connection_resets_pending_;
+            polling_thread_->reset_connection(std::move(connect));
+            return;
+        }
+
         // Set up AP client callbacks
         ap_client_->set_room_info_callback([this](const RoomInfo& info) {
-            APLogger::instance().log(LogLevel::Debug, "Room info received");
+            AP_LOG_DEBUG("Room info received");
 
             // Connect to slot after room info
             const auto& ap = config_->get_ap_server();
@@ -729,8 +1920,7 @@ private:
         });
 
         ap_client_->set_slot_connected_callback([this](const SlotInfo& info) {
-            APLogger::instance().log(LogLevel::Info,
-                "Slot connected: " + info.slot_name);
+            AP_LOG_INFO("Slot connected: ", info.slot_name);
 
             // Sync checked locations from server
             std::set<int64_t> server_checked(
@@ -742,26 +1932,32 @@ private:
 
         ap_client_->set_slot_refused_callback([this](const std::vector<std::string>& errors) {
             std::string error_msg = errors.empty() ? "Unknown error" : errors[0];
-            APLogger::instance().log(LogLevel::Error, "Slot refused: " + error_msg);
+            AP_LOG_ERROR("Slot refused: ", error_msg);
         });
 
-        // Connect
-        ap_client_->connect(
-            ap_config.server,
-            ap_config.port,
-            config_->get_game_name(),
-            uuid
-        );
+        connect(*ap_client_);
 
         // Start polling thread
+        connection_resets_pending_ = 0;
+        polling_thread_->set_policy(make_polling_policy(config_->get_threading()));
+        polling_thread_->set_lifecycle_state(current_state_.get());
         polling_thread_->start(ap_client_.get(), config_->get_threading().polling_interval_ms);
     }
 
-    std::mutex mutex_;
+    // The game thread owns all members below; other threads post commands
+    std::atomic<std::thread::id> game_thread_id_{};
+    ThreadSafeQueue<std::function<void()>> command_queue_;
+    std::vector<std::function<void()>> command_buffer_;
+
     lua_State* lua_state_ = nullptr;
     AtomicState current_state_;
     std::chrono::steady_clock::time_point state_entered_at_;
 
+    // Lifecycle state machine (see fire()); timers are cleared on every state change
+    TimerQueue timers_;
+    std::deque<std::pair<LifecycleTrigger, std::string>> pending_triggers_;
+    bool dispatching_ = false;
+
     APConfig* config_ = nullptr;
     std::unique_ptr<APIPCServer> ipc_server_;
     std::unique_ptr<APClient> ap_client_;
@@ -771,9 +1967,50 @@ private:
     std::unique_ptr<APStateManager> state_manager_;
     std::unique_ptr<APMessageRouter> message_router_;
 
+    // Item batch at the front of the event queue, routed in chunks straight
+    // from its slot (see route_item_batch())
+    size_t batch_items_routed_ = 0;
+    size_t batch_items_left_ = 0;
+    size_t batch_new_items_ = 0;
+    bool items_unsaved_ = false;  // received_item_index advanced since the last save
+    std::unordered_map<int64_t, int> item_progression_counts_;
+    int undelivered_item_index_ = -1;  // First item whose message failed to send; -1 if none
+
+    // Frame budget (see update())
+    std::vector<IPCMessage> ipc_intake_;
+    std::deque<IPCMessage> deferred_messages_;
+    uint64_t deferred_updates_ = 0;
+    uint64_t updates_over_budget_ = 0;
+
+    // Metrics (see metrics_snapshot())
+    MetricHistogram item_route_latency_ = APMetrics::instance().histogram("items.route_latency_us");
+    MetricCounter items_routed_ = APMetrics::instance().counter("items.routed");
+    MetricHistogram location_check_flush_size_ =
+        APMetrics::instance().histogram("location_checks.flush_size");
+    MetricGauge queue_events_ = APMetrics::instance().gauge("queue.events");
+    MetricGauge queue_ipc_deferred_ = APMetrics::instance().gauge("queue.ipc_deferred");
+    MetricGauge queue_items_pending_ = APMetrics::instance().gauge("queue.items_pending");
+    MetricGauge queue_location_checks_offline_ =
+        APMetrics::instance().gauge("queue.location_checks_offline");
+    std::chrono::steady_clock::time_point last_metrics_dump_ = std::chrono::steady_clock::now();
+
     bool state_loaded_ = false;
-    bool reconnect_attempted_ = false;
+
+    std::chrono::steady_clock::time_point slot_connected_at_;
+
+    // Auto-reconnect (RESYNCING)
+    BackoffSchedule reconnect_backoff_;
+    TimerQueue::TimerId reconnect_attempt_timer_ = 0;
+    int connection_resets_pending_ = 0;     // reset_connection() calls whose marker has not arrived
+
     bool first_update_done_ = false;
+
+    // Asynchronous initialization (see start_init_worker())
+    std::thread init_thread_;
+    std::atomic<uint64_t> init_generation_{0};  // Read by the worker to notice it was abandoned
+    bool init_running_ = false;
+    bool init_restart_pending_ = false;
+    std::vector<EarlyRegistration> early_registrations_;
 };
 
 // =============================================================================
@@ -1,9 +1,13 @@
 #include "ap_message_router.h"
 #include "ap_logger.h"
+#include "ap_metrics.h"
 
 #include <nlohmann/json.hpp>
 #include <mutex>
 #include <chrono>
+#include <deque>
+#include <map>
+#include <unordered_map>
 
 namespace ap {
 
@@ -37,16 +41,14 @@ public:
                                                     const std::string& item_name,
                                                     const std::string& sender_name) {
         if (!capabilities_) {
-            APLogger::instance().log(LogLevel::Error,
-                "Cannot route item - capabilities not set");
+            AP_LOG_ERROR_C(LogComponent::Router, "Cannot route item - capabilities not set");
             return std::nullopt;
         }
 
         // Look up item ownership
         auto item_opt = capabilities_->get_item_by_id(item_id);
         if (!item_opt) {
-            APLogger::instance().log(LogLevel::Warn,
-                "Unknown item ID: " + std::to_string(item_id));
+            AP_LOG_WARN_C(LogComponent::Router, "Unknown item ID: ", item_id);
             return std::nullopt;
         }
 
@@ -54,22 +56,13 @@ public:
 
         // Check if item has an action to execute
         if (item.action.empty()) {
-            APLogger::instance().log(LogLevel::Debug,
-                "Item has no action: " + item_name);
+            AP_LOG_DEBUG_C(LogComponent::Router, "Item has no action: ", item_name);
             return std::nullopt;
         }
 
-        // Resolve arguments
-        auto resolved_args = resolve_arguments(item);
-
         // Create pending action
-        PendingAction pending;
-        pending.mod_id = item.mod_id;
-        pending.item_id = item_id;
-        pending.item_name = item_name;
-        pending.action = item.action;
-        pending.resolved_args = resolved_args;
-        pending.started_at = std::chrono::steady_clock::now();
+        PendingAction pending = make_pending_action(item, item_name,
+                                                    current_progression_count(item.item_id));
 
         // Send EXECUTE_ACTION message to owning mod
         if (ipc_send_) {
@@ -77,35 +70,146 @@ public:
             msg.type = IPCMessageType::EXECUTE_ACTION;
             msg.source = IPCTarget::FRAMEWORK;
             msg.target = item.mod_id;
+            msg.payload = action_to_json(pending, sender_name);
 
-            nlohmann::json args_json = nlohmann::json::array();
-            for (const auto& arg : resolved_args) {
-                args_json.push_back({
-                    {"name", arg.name},
-                    {"type", arg_type_to_string(arg.type)},
-                    {"value", arg.value}
-                });
+            ipc_send_(item.mod_id, msg);
+            note_action_sent(pending);
+        }
+
+        AP_LOG_FMT(LogLevel::Debug, LogComponent::Router, "Routed item to {}: {} (action: {})",
+                   item.mod_id, item_name, item.action);
+
+        return pending;
+    }
+
+    std::vector<PendingAction> route_item_receipts(const ItemReceivedEvent* items, size_t count,
+                                                   std::unordered_map<int64_t, int>* progression_counts,
+                                                   size_t* delivered) {
+        std::vector<PendingAction> pending_actions;
+        if (delivered) {
+            *delivered = count;
+        }
+
+        if (!capabilities_) {
+            AP_LOG_ERROR_C(LogComponent::Router, "Cannot route items - capabilities not set");
+            return pending_actions;
+        }
+
+        // Group actions per owning mod, keeping first-seen mod order. A mod's
+        // batch is sent as soon as it reaches EXECUTE_ACTIONS_MAX_BYTES, so a
+        // long replay becomes several messages instead of overflowing the pipe
+        std::vector<ActionBatch> batches;
+        std::unordered_map<std::string, size_t> open_batch;
+        size_t messages = 0;
+
+        // Position of the first item whose message could not be sent
+        size_t undelivered = count;
+
+        // Actions past a failed send are dropped; they are routed again when
+        // the history is replayed (see `delivered`)
+        auto send_batch = [&](ActionBatch& batch) {
+            size_t keep = 0;
+            while (keep < batch.items.size() && batch.items[keep] < undelivered) {
+                ++keep;
+            }
+            if (!ipc_send_ || keep == 0) {
+                return;
             }
+            batch.actions.erase(batch.actions.begin() + keep, batch.actions.end());
 
-            msg.payload = {
-                {"item_id", item_id},
-                {"item_name", item_name},
-                {"action", item.action},
-                {"args", args_json},
-                {"sender", sender_name}
-            };
+            IPCMessage msg;
+            msg.type = IPCMessageType::EXECUTE_ACTIONS;
+            msg.source = IPCTarget::FRAMEWORK;
+            msg.target = batch.mod_id;
+            msg.payload = {{"actions", std::move(batch.actions)}};
 
-            ipc_send_(item.mod_id, msg);
+            if (ipc_send_(batch.mod_id, msg)) {
+                ++messages;
+                for (size_t i = 0; i < keep; ++i) {
+                    note_action_sent(pending_actions[batch.pending[i]]);
+                }
+            } else {
+                AP_LOG_WARN_C(LogComponent::Router, "Could not send ", keep, " actions to ", batch.mod_id);
+                undelivered = batch.items.front();
+            }
+            batch.items.clear();
+            batch.pending.clear();
+        };
+
+        // Copies of the same item earlier in this batch have not been
+        // acknowledged yet, so progression counts continue from the count
+        // seen by the first copy (carried over between chunks if given)
+        std::unordered_map<int64_t, int> local_counts;
+        auto& next_counts = progression_counts ? *progression_counts : local_counts;
+
+        size_t unknown = 0;
+        size_t no_action = 0;
+
+        for (size_t i = 0; i < count && i < undelivered; ++i) {
+            const auto& received = items[i];
+            auto item_opt = capabilities_->get_item_by_id(received.item_id);
+            if (!item_opt) {
+                ++unknown;
+                continue;
+            }
+
+            const auto& item = *item_opt;
+            if (item.action.empty()) {
+                ++no_action;
+                continue;
+            }
+
+            auto [count_it, first_copy] = next_counts.try_emplace(received.item_id, 0);
+            if (first_copy) {
+                count_it->second = current_progression_count(received.item_id);
+            }
+            PendingAction pending = make_pending_action(item, received.item_name, count_it->second++);
+
+            nlohmann::json action = action_to_json(pending, received.sender);
+            size_t action_bytes = action.dump().size() + 1;  // Plus the separating comma
+
+            auto [it, inserted] = open_batch.try_emplace(item.mod_id, batches.size());
+            if (!inserted && batches[it->second].bytes + action_bytes > EXECUTE_ACTIONS_MAX_BYTES) {
+                send_batch(batches[it->second]);
+                it->second = batches.size();
+                inserted = true;
+            }
+            if (inserted) {
+                batches.push_back({item.mod_id, nlohmann::json::array(), {}, {}, 0});
+            }
+            ActionBatch& batch = batches[it->second];
+            batch.actions.push_back(std::move(action));
+            batch.items.push_back(i);
+            batch.pending.push_back(pending_actions.size());
+            batch.bytes += action_bytes;
+
+            pending_actions.push_back(std::move(pending));
         }
 
-        APLogger::instance().log(LogLevel::Debug,
-            "Routed item to " + item.mod_id + ": " + item_name +
-            " (action: " + item.action + ")");
+        // In order of their first item; batches sent early above are left empty
+        for (auto& batch : batches) {
+            send_batch(batch);
+        }
 
-        return pending;
+        if (delivered) {
+            *delivered = undelivered;
+        }
+
+        if (unknown > 0) {
+            AP_LOG_WARN_C(LogComponent::Router, "Skipped ", unknown, " items with unknown IDs");
+        }
+
+        AP_LOG_DEBUG_C(LogComponent::Router, "Routed ", pending_actions.size(), " items to ",
+            open_batch.size(), " mods in ", messages, " messages (", no_action, " without action)");
+
+        return pending_actions;
     }
 
     std::vector<ActionArg> resolve_arguments(const ItemOwnership& item) {
+        return resolve_arguments(item, current_progression_count(item.item_id));
+    }
+
+    std::vector<ActionArg> resolve_arguments(const ItemOwnership& item, int progression_count) {
         std::vector<ActionArg> resolved;
         resolved.reserve(item.args.size());
 
@@ -123,11 +227,7 @@ public:
                 } else if (val == "<GET_ITEM_NAME>") {
                     resolved_arg.value = item.item_name;
                 } else if (val == "<GET_PROGRESSION_COUNT>") {
-                    int count = 0;
-                    if (state_manager_) {
-                        count = state_manager_->get_item_progression_count(item.item_id);
-                    }
-                    resolved_arg.value = count;
+                    resolved_arg.value = progression_count;
                 } else {
                     resolved_arg.value = arg.value;
                 }
@@ -145,24 +245,21 @@ public:
                                  const std::string& location_name,
                                  int instance) {
         if (!capabilities_) {
-            APLogger::instance().log(LogLevel::Error,
-                "Cannot route location check - capabilities not set");
+            AP_LOG_ERROR_C(LogComponent::Router, "Cannot route location check - capabilities not set");
             return 0;
         }
 
         // Look up location ID
         int64_t location_id = capabilities_->get_location_id(mod_id, location_name, instance);
         if (location_id == 0) {
-            APLogger::instance().log(LogLevel::Warn,
-                "Unknown location: " + mod_id + "/" + location_name +
-                " #" + std::to_string(instance));
+            AP_LOG_WARN_C(LogComponent::Router, "Unknown location: ", mod_id, "/", location_name,
+                " #", instance);
             return 0;
         }
 
         // Check if already checked
         if (state_manager_ && state_manager_->is_location_checked(location_id)) {
-            APLogger::instance().log(LogLevel::Debug,
-                "Location already checked: " + location_name);
+            AP_LOG_FMT(LogLevel::Debug, LogComponent::Router, "Location already checked: {}", location_name);
             return 0;
         }
 
@@ -176,8 +273,7 @@ public:
             ap_location_check_({location_id});
         }
 
-        APLogger::instance().log(LogLevel::Info,
-            "Location checked: " + location_name + " (ID: " + std::to_string(location_id) + ")");
+        AP_LOG_INFO_C(LogComponent::Router, "Location checked: ", location_name, " (ID: ", location_id, ")");
 
         return location_id;
     }
@@ -255,21 +351,35 @@ public:
     }
 
     void handle_action_result(const std::string& mod_id, const ActionResult& result) {
+        note_action_result(mod_id, result.item_id);
+
         if (result.success) {
-            APLogger::instance().log(LogLevel::Debug,
-                "Action succeeded for " + mod_id + ": " + result.item_name);
+            AP_LOG_FMT(LogLevel::Debug, LogComponent::Router, "Action succeeded for {}: {}",
+                       mod_id, result.item_name);
 
             // Update progression count
             if (state_manager_ && result.item_id != 0) {
                 state_manager_->increment_item_progression_count(result.item_id);
             }
         } else {
-            APLogger::instance().log(LogLevel::Warn,
-                "Action failed for " + mod_id + ": " + result.item_name +
-                " - " + result.error);
+            AP_LOG_WARN_C(LogComponent::Router, "Action failed for ", mod_id, ": ", result.item_name,
+                " - ", result.error);
         }
     }
 
+    void handle_action_results(const std::string& mod_id, const std::vector<ActionResult>& results) {
+        size_t failed = 0;
+        for (const auto& result : results) {
+            if (!result.success) {
+                ++failed;
+            }
+            handle_action_result(mod_id, result);
+        }
+
+        AP_LOG_DEBUG_C(LogComponent::Router, "Batched action results from ", mod_id, ": ",
+            results.size() - failed, " succeeded, ", failed, " failed");
+    }
+
     void broadcast_lifecycle(LifecycleState state, const std::string& message) {
         if (!ipc_broadcast_) {
             return;
@@ -286,8 +396,7 @@ public:
 
         ipc_broadcast_(msg);
 
-        APLogger::instance().log(LogLevel::Info,
-            "Lifecycle -> " + lifecycle_state_to_string(state) +
+        AP_LOG_INFO_C(LogComponent::Router, "Lifecycle -> ", lifecycle_state_to_string(state),
             (message.empty() ? "" : ": " + message));
     }
 
@@ -310,8 +419,7 @@ public:
 
         ipc_broadcast_(msg);
 
-        APLogger::instance().log(LogLevel::Error,
-            "Error [" + code + "]: " + message +
+        AP_LOG_ERROR_C(LogComponent::Router, "Error [", code, "]: ", message,
             (details.empty() ? "" : " (" + details + ")"));
     }
 
@@ -333,6 +441,76 @@ public:
     }
 
 private:
+    // Keeps each EXECUTE_ACTIONS message, like a get_logs page, well inside
+    // the 64 KiB IPC read buffer once wrapped in the message envelope
+    static constexpr size_t EXECUTE_ACTIONS_MAX_BYTES = 24 * 1024;
+
+    struct ActionBatch {
+        std::string mod_id;
+        nlohmann::json actions;
+        std::vector<size_t> items;      // Position of each action's item in the routed items
+        std::vector<size_t> pending;    // Index of each action in the returned PendingActions
+        size_t bytes = 0;
+    };
+
+    // Send times per (mod, item), matched to results in order, for the
+    // action round-trip histogram
+    void note_action_sent(const PendingAction& pending) {
+        auto& sent = actions_in_flight_[{pending.mod_id, pending.item_id}];
+        if (sent.size() >= MAX_IN_FLIGHT_PER_ITEM) {
+            sent.pop_front();  // Mod is not answering; keep the newest
+        }
+        sent.push_back(pending.started_at);
+    }
+
+    void note_action_result(const std::string& mod_id, int64_t item_id) {
+        auto it = actions_in_flight_.find({mod_id, item_id});
+        if (it == actions_in_flight_.end()) {
+            return;
+        }
+        action_round_trip_.record_since(it->second.front());
+        it->second.pop_front();
+        if (it->second.empty()) {
+            actions_in_flight_.erase(it);
+        }
+    }
+
+    int current_progression_count(int64_t item_id) const {
+        return state_manager_ ? state_manager_->get_item_progression_count(item_id) : 0;
+    }
+
+    PendingAction make_pending_action(const ItemOwnership& item,
+                                      const std::string& item_name,
+                                      int progression_count) {
+        PendingAction pending;
+        pending.mod_id = item.mod_id;
+        pending.item_id = item.item_id;
+        pending.item_name = item_name;
+        pending.action = item.action;
+        pending.resolved_args = resolve_arguments(item, progression_count);
+        pending.started_at = std::chrono::steady_clock::now();
+        return pending;
+    }
+
+    static nlohmann::json action_to_json(const PendingAction& pending, const std::string& sender_name) {
+        nlohmann::json args_json = nlohmann::json::array();
+        for (const auto& arg : pending.resolved_args) {
+            args_json.push_back({
+                {"name", arg.name},
+                {"type", arg_type_to_string(arg.type)},
+                {"value", arg.value}
+            });
+        }
+
+        return {
+            {"item_id", pending.item_id},
+            {"item_name", pending.item_name},
+            {"action", pending.action},
+            {"args", args_json},
+            {"sender", sender_name}
+        };
+    }
+
     APCapabilities* capabilities_ = nullptr;
     APStateManager* state_manager_ = nullptr;
 
@@ -343,6 +521,11 @@ private:
 
     std::mutex scout_mutex_;
     std::unordered_map<int64_t, std::string> pending_scouts_;  // location_id -> mod_id
+
+    static constexpr size_t MAX_IN_FLIGHT_PER_ITEM = 1024;
+    std::map<std::pair<std::string, int64_t>, std::deque<std::chrono::steady_clock::time_point>>
+        actions_in_flight_;
+    MetricHistogram action_round_trip_ = APMetrics::instance().histogram("actions.round_trip_us");
 };
 
 // =============================================================================
@@ -382,6 +565,12 @@ std::optional<PendingAction> APMessageRouter::route_item_receipt(int64_t item_id
     return impl_->route_item_receipt(item_id, item_name, sender_name);
 }
 
+std::vector<PendingAction> APMessageRouter::route_item_receipts(
+    const ItemReceivedEvent* items, size_t count,
+    std::unordered_map<int64_t, int>* progression_counts, size_t* delivered) {
+    return impl_->route_item_receipts(items, count, progression_counts, delivered);
+}
+
 std::vector<ActionArg> APMessageRouter::resolve_arguments(const ItemOwnership& item) {
     return impl_->resolve_arguments(item);
 }
@@ -411,6 +600,10 @@ void APMessageRouter::handle_action_result(const std::string& mod_id, const Acti
     impl_->handle_action_result(mod_id, result);
 }
 
+void APMessageRouter::handle_action_results(const std::string& mod_id, const std::vector<ActionResult>& results) {
+    impl_->handle_action_results(mod_id, results);
+}
+
 void APMessageRouter::broadcast_lifecycle(LifecycleState state, const std::string& message) {
     impl_->broadcast_lifecycle(state, message);
 }
@@ -0,0 +1,313 @@
+#include "ap_metrics.h"
+#include "ap_logger.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace ap {
+
+namespace {
+
+// Log-linear buckets: values below SUB_BUCKETS get one bucket each, then
+// every power of two is split into SUB_BUCKETS equal buckets
+constexpr int SUB_BUCKET_BITS = 4;
+constexpr uint64_t SUB_BUCKETS = 1ull << SUB_BUCKET_BITS;
+constexpr int MAX_VALUE_BITS = 36;
+constexpr uint64_t MAX_VALUE = (1ull << MAX_VALUE_BITS) - 1;
+constexpr size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+int highest_bit(uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+}
+
+size_t bucket_index(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    int exponent = highest_bit(value);
+    uint64_t sub = (value >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+    return static_cast<size_t>((exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub);
+}
+
+/**
+ * @brief Midpoint of the values that fall into a bucket.
+ */
+uint64_t bucket_value(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    int exponent = static_cast<int>(index / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+    uint64_t sub = index % SUB_BUCKETS;
+    uint64_t width = 1ull << (exponent - SUB_BUCKET_BITS);
+    return ((SUB_BUCKETS + sub) << (exponent - SUB_BUCKET_BITS)) + width / 2;
+}
+
+// Single writer per shard: a plain load/store avoids a locked add
+void bump(std::atomic<uint64_t>& cell, uint64_t value) {
+    cell.store(cell.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+} // namespace
+
+// =============================================================================
+// Shards
+// =============================================================================
+
+struct HistogramCells {
+    std::atomic<uint64_t> buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> max;
+};
+
+/**
+ * @brief Per-thread storage. Value-initialized, so every cell starts at zero.
+ */
+struct MetricShard {
+    std::atomic<uint64_t> counters[APMetrics::MAX_COUNTERS];
+    HistogramCells histograms[APMetrics::MAX_HISTOGRAMS];
+    std::atomic<bool> in_use;
+};
+
+namespace {
+
+/**
+ * @brief Hands the shard back to the registry when its thread exits.
+ */
+struct ShardLease {
+    MetricShard* shard = nullptr;
+
+    ~ShardLease();
+};
+
+thread_local ShardLease t_lease;
+
+} // namespace
+
+// =============================================================================
+// APMetrics::Impl
+// =============================================================================
+
+class APMetrics::Impl {
+public:
+    MetricShard& acquire_shard() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Reuse a retired shard so its totals carry on
+        for (auto& shard : shards_) {
+            bool expected = false;
+            if (shard->in_use.compare_exchange_strong(expected, true)) {
+                return *shard;
+            }
+        }
+
+        shards_.push_back(std::make_unique<MetricShard>());
+        shards_.back()->in_use.store(true);
+        return *shards_.back();
+    }
+
+    uint32_t register_name(std::unordered_map<std::string, uint32_t>& ids,
+                           std::vector<std::string>& names,
+                           size_t capacity,
+                           const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        if (names.size() >= capacity) {
+            return UINT32_MAX;
+        }
+
+        auto id = static_cast<uint32_t>(names.size());
+        ids.emplace(name, id);
+        names.push_back(name);
+        return id;
+    }
+
+    nlohmann::json snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        nlohmann::json counters = nlohmann::json::object();
+        for (size_t id = 0; id < counter_names_.size(); ++id) {
+            uint64_t total = 0;
+            for (const auto& shard : shards_) {
+                total += shard->counters[id].load(std::memory_order_relaxed);
+            }
+            counters[counter_names_[id]] = total;
+        }
+
+        nlohmann::json gauges = nlohmann::json::object();
+        for (size_t id = 0; id < gauge_names_.size(); ++id) {
+            gauges[gauge_names_[id]] = gauges_[id].load(std::memory_order_relaxed);
+        }
+
+        nlohmann::json histograms = nlohmann::json::object();
+        std::vector<uint64_t> merged(BUCKET_COUNT);
+        for (size_t id = 0; id < histogram_names_.size(); ++id) {
+            std::fill(merged.begin(), merged.end(), 0);
+            uint64_t count = 0;
+            uint64_t sum = 0;
+            uint64_t max = 0;
+
+            for (const auto& shard : shards_) {
+                const HistogramCells& cells = shard->histograms[id];
+                count += cells.count.load(std::memory_order_relaxed);
+                sum += cells.sum.load(std::memory_order_relaxed);
+                max = std::max(max, cells.max.load(std::memory_order_relaxed));
+                for (size_t b = 0; b < BUCKET_COUNT; ++b) {
+                    merged[b] += cells.buckets[b].load(std::memory_order_relaxed);
+                }
+            }
+
+            histograms[histogram_names_[id]] = {
+                {"count", count},
+                {"sum", sum},
+                {"mean", count > 0 ? static_cast<double>(sum) / static_cast<double>(count) : 0.0},
+                {"max", max},
+                {"p50", percentile(merged, count, 0.50, max)},
+                {"p90", percentile(merged, count, 0.90, max)},
+                {"p99", percentile(merged, count, 0.99, max)}
+            };
+        }
+
+        return {
+            {"counters", std::move(counters)},
+            {"gauges", std::move(gauges)},
+            {"histograms", std::move(histograms)}
+        };
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<MetricShard>> shards_;
+
+    std::unordered_map<std::string, uint32_t> counter_ids_;
+    std::vector<std::string> counter_names_;
+    std::unordered_map<std::string, uint32_t> gauge_ids_;
+    std::vector<std::string> gauge_names_;
+    std::unordered_map<std::string, uint32_t> histogram_ids_;
+    std::vector<std::string> histogram_names_;
+
+    std::atomic<int64_t> gauges_[MAX_GAUGES] = {};
+
+private:
+    static uint64_t percentile(const std::vector<uint64_t>& buckets, uint64_t count,
+                               double quantile, uint64_t max) {
+        if (count == 0) {
+            return 0;
+        }
+        auto rank = static_cast<uint64_t>(quantile * static_cast<double>(count - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t b = 0; b < buckets.size(); ++b) {
+            seen += buckets[b];
+            if (seen >= rank) {
+                return std::min(bucket_value(b), max);
+            }
+        }
+        return max;
+    }
+};
+
+// =============================================================================
+// APMetrics
+// =============================================================================
+
+APMetrics& APMetrics::instance() {
+    // Never destroyed, so threads that exit during static destruction can
+    // still hand their shard back
+    static APMetrics* instance = new APMetrics();
+    return *instance;
+}
+
+APMetrics::APMetrics() : impl_(std::make_unique<Impl>()) {}
+
+APMetrics::~APMetrics() = default;
+
+MetricShard& APMetrics::local_shard() {
+    if (!t_lease.shard) {
+        t_lease.shard = &instance().impl_->acquire_shard();
+    }
+    return *t_lease.shard;
+}
+
+MetricCounter APMetrics::counter(const std::string& name) {
+    uint32_t id = impl_->register_name(impl_->counter_ids_, impl_->counter_names_, MAX_COUNTERS, name);
+    if (id == UINT32_MAX) {
+        AP_LOG_WARN("Metrics registry full, ignoring counter ", name);
+    }
+    return MetricCounter(id);
+}
+
+MetricGauge APMetrics::gauge(const std::string& name) {
+    uint32_t id = impl_->register_name(impl_->gauge_ids_, impl_->gauge_names_, MAX_GAUGES, name);
+    if (id == UINT32_MAX) {
+        AP_LOG_WARN("Metrics registry full, ignoring gauge ", name);
+        return MetricGauge();
+    }
+    return MetricGauge(&impl_->gauges_[id]);
+}
+
+MetricHistogram APMetrics::histogram(const std::string& name) {
+    uint32_t id = impl_->register_name(impl_->histogram_ids_, impl_->histogram_names_,
+                                       MAX_HISTOGRAMS, name);
+    if (id == UINT32_MAX) {
+        AP_LOG_WARN("Metrics registry full, ignoring histogram ", name);
+    }
+    return MetricHistogram(id);
+}
+
+nlohmann::json APMetrics::snapshot() const {
+    return impl_->snapshot();
+}
+
+// =============================================================================
+// Handles
+// =============================================================================
+
+void MetricCounter::add(uint64_t value) const {
+    if (id_ == UINT32_MAX) {
+        return;
+    }
+    bump(APMetrics::local_shard().counters[id_], value);
+}
+
+void MetricHistogram::record(uint64_t value) const {
+    if (id_ == UINT32_MAX) {
+        return;
+    }
+    value = std::min(value, MAX_VALUE);
+
+    HistogramCells& cells = APMetrics::local_shard().histograms[id_];
+    bump(cells.buckets[bucket_index(value)], 1);
+    bump(cells.count, 1);
+    bump(cells.sum, value);
+    if (value > cells.max.load(std::memory_order_relaxed)) {
+        cells.max.store(value, std::memory_order_relaxed);
+    }
+}
+
+void MetricCounterFamily::add(const std::string& label, uint64_t value) {
+    MetricCounter counter;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = counters_.find(label);
+        if (it == counters_.end()) {
+            it = counters_.emplace(label, APMetrics::instance().counter(prefix_ + label)).first;
+        }
+        counter = it->second;
+    }
+    counter.add(value);
+}
+
+ShardLease::~ShardLease() {
+    if (shard) {
+        shard->in_use.store(false);
+    }
+}
+
+} // namespace ap
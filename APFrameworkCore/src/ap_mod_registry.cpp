@@ -14,8 +14,7 @@ public:
         std::lock_guard<std::mutex> lock(mutex_);
 
         if (!APPathUtil::directory_exists(mods_folder)) {
-            APLogger::instance().log(LogLevel::Warn,
-                "Mods folder not found: " + mods_folder.string());
+            AP_LOG_WARN("Mods folder not found: ", mods_folder.string());
             return 0;
         }
 
@@ -35,29 +34,24 @@ public:
 
             auto manifest = APModRegistry::parse_manifest_file(manifest_path);
             if (!manifest) {
-                APLogger::instance().log(LogLevel::Warn,
-                    "Failed to parse manifest: " + manifest_path.string());
+                AP_LOG_WARN("Failed to parse manifest: ", manifest_path.string());
                 continue;
             }
 
             // Skip if mod_id already exists
             if (manifests_.find(manifest->mod_id) != manifests_.end()) {
-                APLogger::instance().log(LogLevel::Warn,
-                    "Duplicate mod_id: " + manifest->mod_id);
+                AP_LOG_WARN("Duplicate mod_id: ", manifest->mod_id);
                 continue;
             }
 
-            APLogger::instance().log(LogLevel::Debug,
-                "Discovered mod: " + manifest->mod_id +
-                " v" + manifest->version +
-                (manifest->enabled ? "" : " (disabled)"));
+            AP_LOG_DEBUG("Discovered mod: ", manifest->mod_id, " v", manifest->version,
+                         (manifest->enabled ? "" : " (disabled)"));
 
             manifests_[manifest->mod_id] = *manifest;
             count++;
         }
 
-        APLogger::instance().log(LogLevel::Info,
-            "Discovered " + std::to_string(count) + " mods");
+        AP_LOG_INFO("Discovered ", count, " mods");
 
         return count;
     }
@@ -88,8 +82,7 @@ public:
 
         registered_.insert(mod_id);
 
-        APLogger::instance().log(LogLevel::Debug,
-            "Mod registered: " + mod_id);
+        AP_LOG_DEBUG("Mod registered: ", mod_id);
 
         return true;
     }
@@ -317,8 +310,7 @@ std::optional<Manifest> APModRegistry::parse_manifest(const std::string& json_co
         return manifest;
 
     } catch (const nlohmann::json::exception& e) {
-        APLogger::instance().log(LogLevel::Error,
-            "JSON parse error: " + std::string(e.what()));
+        AP_LOG_ERROR("JSON parse error: ", e.what());
         return std::nullopt;
     }
 }
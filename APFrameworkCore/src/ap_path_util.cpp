@@ -452,6 +452,17 @@ std::filesystem::path APPathUtil::get_session_state_path() {
     return cached_dll_directory_ / "session_state.json";
 }
 
+std::filesystem::path APPathUtil::get_data_package_cache_path() {
+    auto output_folder = find_output_folder();
+    if (output_folder) {
+        return *output_folder / "datapackage";
+    }
+
+    // Fallback to DLL directory
+    initialize_cache();
+    return cached_dll_directory_ / "datapackage";
+}
+
 // =============================================================================
 // File Operations
 // =============================================================================
@@ -1,9 +1,12 @@
 #include "ap_polling_thread.h"
 #include "ap_logger.h"
+#include "ap_trace.h"
 
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <mutex>
+#include <condition_variable>
 
 namespace ap {
 
@@ -25,18 +28,28 @@ public:
         }
 
         client_ = client;
-        interval_ms_ = interval_ms;
+        {
+            std::lock_guard<std::mutex> lock(policy_mutex_);
+            if (!policy_) {
+                // The default configuration's policy
+                ThreadingConfig defaults;
+                defaults.polling_interval_ms = interval_ms;
+                policy_ = make_polling_policy(defaults);
+            }
+        }
         stop_token_.reset();
+        connection_resets_.clear();
         running_ = true;
 
         // Set up client callbacks to queue events
         setup_client_callbacks();
+        client_->set_wake_callback([this]() { wake(); });
 
         // Start polling thread
         thread_ = std::thread(&Impl::thread_func, this);
 
-        APLogger::instance().log(LogLevel::Info,
-            "Polling thread started with " + std::to_string(interval_ms) + "ms interval");
+        AP_LOG_INFO_C(LogComponent::Polling,
+            "Polling thread started (current interval ", get_interval(), "ms)");
 
         return true;
     }
@@ -48,6 +61,7 @@ public:
 
         running_ = false;
         stop_token_.request_stop();
+        wake();
 
         if (thread_.joinable()) {
             // Wait for thread with timeout
@@ -57,8 +71,7 @@ public:
                     std::chrono::steady_clock::now() - start).count();
 
                 if (elapsed >= timeout_ms) {
-                    APLogger::instance().log(LogLevel::Warn,
-                        "Polling thread stop timeout exceeded");
+                    AP_LOG_WARN_C(LogComponent::Polling, "Polling thread stop timeout exceeded");
                     return false;
                 }
 
@@ -73,10 +86,27 @@ public:
             }
         }
 
-        APLogger::instance().log(LogLevel::Info, "Polling thread stopped");
+        if (client_) {
+            client_->set_wake_callback(nullptr);
+        }
+
+        AP_LOG_INFO_C(LogComponent::Polling, "Polling thread stopped");
         return true;
     }
 
+    void reset_connection(std::function<void(APClient&)> connect) {
+        connection_resets_.push(std::move(connect));
+        wake();
+    }
+
+    void wake() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            wake_pending_ = true;
+        }
+        wake_cv_.notify_one();
+    }
+
     bool is_running() const {
         return running_;
     }
@@ -86,18 +116,36 @@ public:
     }
 
     void process_events(EventHandler handler) {
-        auto events = event_queue_.pop_all();
-        for (const auto& event : events) {
-            handler(event);
-        }
+        // Events are read in place; the slots are recycled by the polling thread
+        event_queue_.consume_all(handler);
+    }
+
+    size_t process_events(ResumableEventHandler handler, const std::function<bool()>& keep_going) {
+        return event_queue_.consume_while(handler, keep_going);
     }
 
     void set_interval(int interval_ms) {
-        interval_ms_ = interval_ms;
+        set_policy(std::make_unique<FixedPollingPolicy>(interval_ms));
     }
 
     int get_interval() const {
-        return interval_ms_;
+        std::lock_guard<std::mutex> lock(policy_mutex_);
+        return policy_ ? static_cast<int>(policy_->current_interval().count()) : 0;
+    }
+
+    void set_policy(std::unique_ptr<PollingPolicy> policy) {
+        {
+            std::lock_guard<std::mutex> lock(policy_mutex_);
+            policy_ = std::move(policy);
+        }
+        wake();
+    }
+
+    void set_lifecycle_state(LifecycleState state) {
+        LifecycleState previous = lifecycle_state_.exchange(state);
+        if (previous != state) {
+            wake();
+        }
     }
 
     EventQueue& get_event_queue() {
@@ -108,139 +156,219 @@ private:
     void thread_func() {
         APLogger::set_thread_name("AP-Polling");
 
+        int immediate_repolls = 0;
+
         while (running_ && !stop_token_.stop_requested()) {
-            auto start = std::chrono::steady_clock::now();
+            // A new connection attempt polls fast until its handshake is done
+            bool active = run_connection_resets();
 
             // Poll the AP client
             if (client_) {
+                AP_TRACE_SCOPE("AP poll");
                 try {
-                    client_->poll();
+                    active = client_->poll() || active;
                 } catch (const std::exception& e) {
-                    APLogger::instance().log(LogLevel::Error,
-                        "Exception in AP poll: " + std::string(e.what()));
+                    AP_LOG_ERROR_C(LogComponent::Polling, "Exception in AP poll: ", e.what());
                 }
             }
 
-            // Sleep for remaining interval
-            auto elapsed = std::chrono::steady_clock::now() - start;
-            auto sleep_time = std::chrono::milliseconds(interval_ms_) - elapsed;
+            std::chrono::milliseconds wait;
+            {
+                std::lock_guard<std::mutex> lock(policy_mutex_);
+                wait = policy_->next_interval(active, lifecycle_state_.load());
+            }
 
-            if (sleep_time > std::chrono::milliseconds(0)) {
-                stop_token_.sleep_for(sleep_time);
+            // Drain packets already buffered behind the ones just handled
+            if (active && ++immediate_repolls < MAX_IMMEDIATE_REPOLLS) {
+                continue;
             }
+            immediate_repolls = 0;
+
+            // Sleep until an outgoing send wakes us or the policy's interval
+            // elapses (this also covers housekeeping: pings, reconnect detection).
+            // apclientpp keeps its socket private, so nothing wakes us when a
+            // packet arrives; the interval bounds how long it waits unread
+            wait_for_wake(wait);
         }
 
         running_ = false;
     }
 
+    /**
+     * @return true if a connection was replaced.
+     */
+    bool run_connection_resets() {
+        if (!client_ || connection_resets_.empty()) {
+            return false;
+        }
+
+        for (auto& connect : connection_resets_.pop_all()) {
+            client_->disconnect();
+            if (connect) {
+                try {
+                    connect(*client_);
+                } catch (const std::exception& e) {
+                    AP_LOG_ERROR_C(LogComponent::Polling, "Exception while reconnecting: ", e.what());
+                }
+            }
+
+            // Everything queued before this came from the replaced connection
+            event_queue_.emplace<LifecycleEvent>([](LifecycleEvent& event) {
+                event.old_state = LifecycleState::RESYNCING;
+                event.new_state = LifecycleState::CONNECTING;
+                event.message = "Connection reset";
+            });
+        }
+        return true;
+    }
+
+    void wait_for_wake(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait_for(lock, timeout, [this] {
+            return wake_pending_ || stop_token_.stop_requested();
+        });
+        wake_pending_ = false;
+    }
+
     void setup_client_callbacks() {
         if (!client_) return;
 
-        // Item received
-        client_->set_item_received_callback([this](const ReceivedItem& item) {
-            ItemReceivedEvent event;
-            event.item_id = item.item_id;
-            event.item_name = item.item_name;
-            event.sender = item.player_name;
-            event.location_id = item.location_id;
-            event.is_self = (item.player_id == client_->get_player_number());
+        // Events are filled in place into recycled queue slots, so every
+        // field must be assigned (slots hold stale data from earlier events)
+
+        // Items received (one ReceivedItems packet at a time)
+        client_->set_items_received_callback([this](const std::vector<ReceivedItem>& items) {
+            int player_number = client_->get_player_number();
+            auto now = std::chrono::steady_clock::now();
+
+            if (items.size() == 1) {
+                event_queue_.emplace<ItemReceivedEvent>([&](ItemReceivedEvent& event) {
+                    fill_item_event(event, items.front(), player_number, now);
+                });
+                return;
+            }
 
-            event_queue_.push(event);
+            // Multi-item packets (history replay on connect, grouped sends)
+            // travel as one event so the main thread can apply them in bulk
+            event_queue_.emplace<ItemBatchReceivedEvent>([&](ItemBatchReceivedEvent& batch) {
+                batch.items.resize(items.size());
+                for (size_t i = 0; i < items.size(); ++i) {
+                    fill_item_event(batch.items[i], items[i], player_number, now);
+                }
+            });
         });
 
         // Location scouted
         client_->set_location_scouted_callback([this](const std::vector<ScoutResult>& results) {
             for (const auto& result : results) {
-                LocationScoutEvent event;
-                event.location_id = result.location_id;
-                event.location_name = client_->get_location_name(result.location_id);
-                event.item_id = result.item_id;
-                event.item_name = result.item_name;
-                event.player_name = result.player_name;
-
-                event_queue_.push(event);
+                event_queue_.emplace<LocationScoutEvent>([&](LocationScoutEvent& event) {
+                    event.location_id = result.location_id;
+                    event.location_name = client_->get_location_name(result.location_id);
+                    event.item_id = result.item_id;
+                    event.item_name = result.item_name;
+                    event.player_name = result.player_name;
+                });
             }
         });
 
         // Slot connected
         client_->set_slot_connected_callback([this](const SlotInfo& info) {
-            LifecycleEvent event;
-            event.old_state = LifecycleState::CONNECTING;
-            event.new_state = LifecycleState::SYNCING;
-            event.message = "Connected to slot: " + info.slot_name;
-
-            event_queue_.push(event);
+            event_queue_.emplace<LifecycleEvent>([&](LifecycleEvent& event) {
+                event.old_state = LifecycleState::CONNECTING;
+                event.new_state = LifecycleState::SYNCING;
+                event.message = "Connected to slot: " + info.slot_name;
+            });
         });
 
         // Slot refused
         client_->set_slot_refused_callback([this](const std::vector<std::string>& errors) {
-            ErrorEvent event;
-            event.code = ErrorCode::CONNECTION_FAILED;
-            event.message = "Slot connection refused";
-
-            if (!errors.empty()) {
-                event.details = errors[0];
-                for (size_t i = 1; i < errors.size(); ++i) {
-                    event.details += "; " + errors[i];
+            event_queue_.emplace<ErrorEvent>([&](ErrorEvent& event) {
+                event.code = ErrorCode::CONNECTION_FAILED;
+                event.message = "Slot connection refused";
+                event.details.clear();
+
+                for (size_t i = 0; i < errors.size(); ++i) {
+                    if (i > 0) {
+                        event.details += "; ";
+                    }
+                    event.details += errors[i];
                 }
-            }
-
-            event_queue_.push(event);
+            });
         });
 
-        // Disconnected
+        // Disconnected (the manager decides whether to reconnect)
         client_->set_disconnected_callback([this]() {
-            LifecycleEvent event;
-            event.old_state = LifecycleState::ACTIVE;
-            event.new_state = LifecycleState::ERROR_STATE;
-            event.message = "Disconnected from server";
-
-            event_queue_.push(event);
+            event_queue_.emplace<LifecycleEvent>([](LifecycleEvent& event) {
+                event.old_state = LifecycleState::ACTIVE;
+                event.new_state = LifecycleState::RESYNCING;
+                event.message = "Disconnected from server";
+            });
         });
 
         // Print messages
         client_->set_print_callback([this](const std::string& msg) {
-            APMessageEvent event;
-            event.type = "print";
-            event.message = msg;
-
-            event_queue_.push(event);
+            event_queue_.emplace<APMessageEvent>([&](APMessageEvent& event) {
+                event.type = "print";
+                event.message = msg;
+                event.data = nullptr;
+            });
         });
 
         // Print JSON messages
         client_->set_print_json_callback([this](const std::string& type, const nlohmann::json& data) {
-            APMessageEvent event;
-            event.type = type;
-            event.data = data;
-
-            // Try to extract message text
-            if (data.is_array()) {
-                for (const auto& node : data) {
-                    if (node.contains("text")) {
-                        event.message += node["text"].get<std::string>();
+            event_queue_.emplace<APMessageEvent>([&](APMessageEvent& event) {
+                event.type = type;
+                event.data = data;
+
+                // Try to extract message text
+                event.message.clear();
+                if (data.is_array()) {
+                    for (const auto& node : data) {
+                        auto text = node.find("text");
+                        if (text != node.end() && text->is_string()) {
+                            event.message += text->get_ref<const std::string&>();
+                        }
                     }
                 }
-            }
-
-            event_queue_.push(event);
+            });
         });
 
         // Bounced packets
         client_->set_bounced_callback([this](const nlohmann::json& data) {
-            APMessageEvent event;
-            event.type = "bounced";
-            event.data = data;
-
-            event_queue_.push(event);
+            event_queue_.emplace<APMessageEvent>([&](APMessageEvent& event) {
+                event.type = "bounced";
+                event.message.clear();
+                event.data = data;
+            });
         });
     }
 
+    static void fill_item_event(ItemReceivedEvent& event, const ReceivedItem& item, int player_number,
+                                std::chrono::steady_clock::time_point received_at) {
+        event.item_id = item.item_id;
+        event.item_name = item.item_name;
+        event.sender = item.player_name;
+        event.location_id = item.location_id;
+        event.is_self = (item.player_id == player_number);
+        event.index = item.index;
+        event.received_at = received_at;
+    }
+
+    static constexpr int MAX_IMMEDIATE_REPOLLS = 64;
+
     APClient* client_ = nullptr;
     std::thread thread_;
     std::atomic<bool> running_{false};
-    std::atomic<int> interval_ms_{16};
+    std::atomic<LifecycleState> lifecycle_state_{LifecycleState::UNINITIALIZED};
+    mutable std::mutex policy_mutex_;
+    std::unique_ptr<PollingPolicy> policy_;
     StopToken stop_token_;
     EventQueue event_queue_;
+    ThreadSafeQueue<std::function<void(APClient&)>> connection_resets_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    bool wake_pending_ = false;
 };
 
 // =============================================================================
@@ -270,6 +398,15 @@ void APPollingThread::process_events(EventHandler handler) {
     impl_->process_events(std::move(handler));
 }
 
+size_t APPollingThread::process_events(ResumableEventHandler handler,
+                                       const std::function<bool()>& keep_going) {
+    return impl_->process_events(std::move(handler), keep_going);
+}
+
+void APPollingThread::reset_connection(std::function<void(APClient&)> connect) {
+    impl_->reset_connection(std::move(connect));
+}
+
 void APPollingThread::set_interval(int interval_ms) {
     impl_->set_interval(interval_ms);
 }
@@ -278,6 +415,18 @@ int APPollingThread::get_interval() const {
     return impl_->get_interval();
 }
 
+void APPollingThread::set_policy(std::unique_ptr<PollingPolicy> policy) {
+    impl_->set_policy(std::move(policy));
+}
+
+void APPollingThread::set_lifecycle_state(LifecycleState state) {
+    impl_->set_lifecycle_state(state);
+}
+
+void APPollingThread::wake() {
+    impl_->wake();
+}
+
 EventQueue& APPollingThread::get_event_queue() {
     return impl_->get_event_queue();
 }
@@ -1,5 +1,7 @@
 #include "ap_state_manager.h"
 #include "ap_logger.h"
+#include "ap_metrics.h"
+#include "ap_trace.h"
 #include "ap_path_util.h"
 
 #include <nlohmann/json.hpp>
@@ -11,18 +13,19 @@ namespace ap {
 class APStateManager::Impl {
 public:
     bool save_state(const std::filesystem::path& path) {
+        AP_TRACE_SCOPE("APStateManager::save_state");
+        auto started = std::chrono::steady_clock::now();
         std::lock_guard<std::mutex> lock(mutex_);
 
         try {
             std::string json_content = state_.to_json().dump(2);
             if (APPathUtil::write_file(path, json_content)) {
-                APLogger::instance().log(LogLevel::Debug,
-                    "Saved session state to: " + path.string());
+                save_duration_.record_since(started);
+                AP_LOG_DEBUG("Saved session state to: ", path.string());
                 return true;
             }
         } catch (const std::exception& e) {
-            APLogger::instance().log(LogLevel::Error,
-                "Failed to save session state: " + std::string(e.what()));
+            AP_LOG_ERROR("Failed to save session state: ", e.what());
         }
 
         return false;
@@ -37,8 +40,7 @@ public:
 
         std::string content = APPathUtil::read_file(path);
         if (content.empty()) {
-            APLogger::instance().log(LogLevel::Debug,
-                "No session state file found: " + path.string());
+            AP_LOG_DEBUG("No session state file found: ", path.string());
             return false;
         }
 
@@ -47,16 +49,14 @@ public:
             state_ = SessionState::from_json(j);
             loaded_ = true;
 
-            APLogger::instance().log(LogLevel::Info,
-                "Loaded session state from: " + path.string() +
-                " (item_index=" + std::to_string(state_.received_item_index) +
-                ", locations=" + std::to_string(state_.checked_locations.size()) + ")");
+            AP_LOG_INFO("Loaded session state from: ", path.string(),
+                        " (item_index=", state_.received_item_index,
+                        ", locations=", state_.checked_locations.size(), ")");
 
             return true;
 
         } catch (const nlohmann::json::exception& e) {
-            APLogger::instance().log(LogLevel::Error,
-                "Failed to parse session state: " + std::string(e.what()));
+            AP_LOG_ERROR("Failed to parse session state: ", e.what());
             return false;
         }
     }
@@ -116,6 +116,37 @@ public:
         state_.checked_locations = locations;
     }
 
+    void add_pending_location_checks(const std::vector<int64_t>& location_ids) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_.pending_location_checks.empty()) {
+            state_.pending_since = std::chrono::system_clock::now();
+        }
+        state_.pending_location_checks.insert(location_ids.begin(), location_ids.end());
+    }
+
+    std::vector<int64_t> get_pending_location_checks() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return {state_.pending_location_checks.begin(), state_.pending_location_checks.end()};
+    }
+
+    size_t get_pending_location_check_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return state_.pending_location_checks.size();
+    }
+
+    std::optional<std::chrono::system_clock::time_point> get_pending_since() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_.pending_location_checks.empty()) {
+            return std::nullopt;
+        }
+        return state_.pending_since;
+    }
+
+    void clear_pending_location_checks() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        state_.pending_location_checks.clear();
+    }
+
     void set_item_progression_count(int64_t item_id, int count) {
         std::lock_guard<std::mutex> lock(mutex_);
         state_.item_progression_counts[item_id] = count;
@@ -157,9 +188,7 @@ public:
 
         bool match = (state_.checksum == current_checksum);
         if (!match) {
-            APLogger::instance().log(LogLevel::Error,
-                "Checksum mismatch! Stored: " + state_.checksum +
-                ", Current: " + current_checksum);
+            AP_LOG_ERROR("Checksum mismatch! Stored: ", state_.checksum, ", Current: ", current_checksum);
         }
         return match;
     }
@@ -220,6 +249,8 @@ private:
     mutable std::mutex mutex_;
     SessionState state_;
     bool loaded_ = false;
+
+    MetricHistogram save_duration_ = APMetrics::instance().histogram("state.save_us");
 };
 
 // =============================================================================
@@ -285,6 +316,26 @@ void APStateManager::set_checked_locations(const std::set<int64_t>& locations) {
     impl_->set_checked_locations(locations);
 }
 
+void APStateManager::add_pending_location_checks(const std::vector<int64_t>& location_ids) {
+    impl_->add_pending_location_checks(location_ids);
+}
+
+std::vector<int64_t> APStateManager::get_pending_location_checks() const {
+    return impl_->get_pending_location_checks();
+}
+
+size_t APStateManager::get_pending_location_check_count() const {
+    return impl_->get_pending_location_check_count();
+}
+
+std::optional<std::chrono::system_clock::time_point> APStateManager::get_pending_since() const {
+    return impl_->get_pending_since();
+}
+
+void APStateManager::clear_pending_location_checks() {
+    impl_->clear_pending_location_checks();
+}
+
 void APStateManager::set_item_progression_count(int64_t item_id, int count) {
     impl_->set_item_progression_count(item_id, count);
 }
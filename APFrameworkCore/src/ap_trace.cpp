@@ -0,0 +1,233 @@
+#include "ap_trace.h"
+#include "ap_logger.h"
+#include "ap_path_util.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ap {
+
+namespace {
+
+// Buffers of exited threads kept for export (e.g. the polling thread of the
+// previous connection); older ones are freed
+constexpr size_t MAX_RETIRED_BUFFERS = 4;
+
+constexpr int TRACE_PID = 1;
+
+struct TraceEvent {
+    const char* name = nullptr;
+    int64_t start_us = 0;
+    int64_t duration_us = 0;
+};
+
+struct ExternalEvent {
+    uint32_t tid = 0;
+    std::string name;
+    int64_t start_us = 0;
+    int64_t duration_us = 0;
+};
+
+} // namespace
+
+/**
+ * @brief One thread's ring of events. Only that thread writes; the mutex is
+ *        uncontended except while an export or clear() reads it.
+ */
+struct TraceBuffer {
+    uint32_t tid = 0;
+    std::string thread_name;
+    std::atomic<bool> retired{false};
+
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    uint64_t written = 0;
+};
+
+namespace {
+
+/**
+ * @brief Marks the buffer retired when its thread exits.
+ */
+struct BufferLease {
+    TraceBuffer* buffer = nullptr;
+
+    ~BufferLease() {
+        if (buffer) {
+            buffer->retired.store(true);
+        }
+    }
+};
+
+thread_local BufferLease t_lease;
+
+} // namespace
+
+// =============================================================================
+// APTracer::Impl
+// =============================================================================
+
+class APTracer::Impl {
+public:
+    TraceBuffer& acquire_buffer() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        prune_retired();
+
+        auto buffer = std::make_unique<TraceBuffer>();
+        buffer->tid = next_tid_++;
+        buffer->thread_name = APLogger::get_thread_name();
+        buffer->events.resize(EVENTS_PER_THREAD);
+        buffers_.push_back(std::move(buffer));
+        return *buffers_.back();
+    }
+
+    void record_external(const std::string& track, const std::string& name,
+                         int64_t start_us, int64_t duration_us) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto [it, inserted] = external_tracks_.try_emplace(track, next_tid_);
+        if (inserted) {
+            ++next_tid_;
+        }
+        if (external_.size() >= EVENTS_PER_THREAD) {
+            external_.erase(external_.begin(), external_.begin() + EVENTS_PER_THREAD / 4);
+        }
+        external_.push_back({it->second, name, start_us, duration_us});
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& buffer : buffers_) {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            buffer->written = 0;
+        }
+        external_.clear();
+    }
+
+    nlohmann::json export_chrome() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        nlohmann::json events = nlohmann::json::array();
+
+        auto add_track = [&](uint32_t tid, const std::string& name) {
+            events.push_back({
+                {"name", "thread_name"}, {"ph", "M"}, {"pid", TRACE_PID}, {"tid", tid},
+                {"args", {{"name", name}}}
+            });
+        };
+
+        for (const auto& buffer : buffers_) {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            if (buffer->written == 0) {
+                continue;
+            }
+            add_track(buffer->tid, buffer->thread_name);
+
+            uint64_t count = std::min<uint64_t>(buffer->written, EVENTS_PER_THREAD);
+            for (uint64_t i = buffer->written - count; i < buffer->written; ++i) {
+                const TraceEvent& event = buffer->events[i % EVENTS_PER_THREAD];
+                events.push_back(complete_event(buffer->tid, event.name, event.start_us, event.duration_us));
+            }
+        }
+
+        for (const auto& [track, tid] : external_tracks_) {
+            add_track(tid, track);
+        }
+        for (const auto& event : external_) {
+            events.push_back(complete_event(event.tid, event.name, event.start_us, event.duration_us));
+        }
+
+        return {
+            {"traceEvents", std::move(events)},
+            {"displayTimeUnit", "ms"}
+        };
+    }
+
+private:
+    static nlohmann::json complete_event(uint32_t tid, const std::string& name,
+                                         int64_t start_us, int64_t duration_us) {
+        return {
+            {"name", name}, {"cat", "apf"}, {"ph", "X"}, {"pid", TRACE_PID}, {"tid", tid},
+            {"ts", start_us}, {"dur", duration_us}
+        };
+    }
+
+    void prune_retired() {
+        size_t retired = 0;
+        for (const auto& buffer : buffers_) {
+            retired += buffer->retired.load() ? 1 : 0;
+        }
+        for (auto it = buffers_.begin(); it != buffers_.end() && retired > MAX_RETIRED_BUFFERS;) {
+            if ((*it)->retired.load()) {
+                it = buffers_.erase(it);
+                --retired;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers_;
+    uint32_t next_tid_ = 1;
+
+    std::unordered_map<std::string, uint32_t> external_tracks_;
+    std::vector<ExternalEvent> external_;
+};
+
+// =============================================================================
+// APTracer
+// =============================================================================
+
+APTracer& APTracer::instance() {
+    // Never destroyed, so threads that exit during static destruction can
+    // still retire their buffer
+    static APTracer* instance = new APTracer();
+    return *instance;
+}
+
+APTracer::APTracer() : impl_(std::make_unique<Impl>()) {}
+
+APTracer::~APTracer() = default;
+
+TraceBuffer& APTracer::local_buffer() {
+    if (!t_lease.buffer) {
+        t_lease.buffer = &impl_->acquire_buffer();
+    }
+    return *t_lease.buffer;
+}
+
+void APTracer::set_enabled(bool enabled) {
+    enabled_.store(enabled);
+}
+
+void APTracer::clear() {
+    impl_->clear();
+}
+
+void APTracer::record(const char* name, int64_t start_us, int64_t duration_us) {
+    TraceBuffer& buffer = local_buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events[buffer.written % EVENTS_PER_THREAD] = {name, start_us, duration_us};
+    ++buffer.written;
+}
+
+void APTracer::record_external(const std::string& track, const std::string& name,
+                               int64_t start_us, int64_t duration_us) {
+    if (is_enabled()) {
+        impl_->record_external(track, name, start_us, duration_us);
+    }
+}
+
+nlohmann::json APTracer::export_chrome() const {
+    return impl_->export_chrome();
+}
+
+long APTracer::write_chrome_trace(const std::filesystem::path& path) const {
+    nlohmann::json trace = export_chrome();
+    long count = static_cast<long>(trace["traceEvents"].size());
+    return APPathUtil::write_file(path, trace.dump()) ? count : -1;
+}
+
+} // namespace ap
@@ -0,0 +1,97 @@
+#include "compression_util.h"
+
+#include <zlib.h>
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+namespace ap {
+
+bool CompressionUtil::zlib_compress(const std::string& data, std::string& out, int level) {
+    uLongf length = compressBound(static_cast<uLong>(data.size()));
+    out.resize(length);
+
+    int result = compress2(reinterpret_cast<Bytef*>(out.data()), &length,
+                           reinterpret_cast<const Bytef*>(data.data()),
+                           static_cast<uLong>(data.size()), level);
+    if (result != Z_OK) {
+        out.clear();
+        return false;
+    }
+
+    out.resize(length);
+    return true;
+}
+
+std::string CompressionUtil::base64_encode(const std::string& data) {
+    static constexpr char ALPHABET[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+
+    size_t i = 0;
+    for (; i + 2 < data.size(); i += 3) {
+        uint32_t chunk = (static_cast<uint8_t>(data[i]) << 16) |
+                         (static_cast<uint8_t>(data[i + 1]) << 8) |
+                         static_cast<uint8_t>(data[i + 2]);
+        out.push_back(ALPHABET[(chunk >> 18) & 0x3F]);
+        out.push_back(ALPHABET[(chunk >> 12) & 0x3F]);
+        out.push_back(ALPHABET[(chunk >> 6) & 0x3F]);
+        out.push_back(ALPHABET[chunk & 0x3F]);
+    }
+
+    size_t remaining = data.size() - i;
+    if (remaining > 0) {
+        uint32_t chunk = static_cast<uint8_t>(data[i]) << 16;
+        if (remaining == 2) {
+            chunk |= static_cast<uint8_t>(data[i + 1]) << 8;
+        }
+        out.push_back(ALPHABET[(chunk >> 18) & 0x3F]);
+        out.push_back(ALPHABET[(chunk >> 12) & 0x3F]);
+        out.push_back(remaining == 2 ? ALPHABET[(chunk >> 6) & 0x3F] : '=');
+        out.push_back('=');
+    }
+    return out;
+}
+
+bool CompressionUtil::gzip_file(const std::filesystem::path& source,
+                                const std::filesystem::path& destination, int level) {
+    std::ifstream in(source, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+
+    std::string mode = "wb" + std::to_string(level);
+#ifdef _WIN32
+    gzFile out = gzopen_w(destination.wstring().c_str(), mode.c_str());
+#else
+    gzFile out = gzopen(destination.string().c_str(), mode.c_str());
+#endif
+    if (!out) {
+        return false;
+    }
+
+    std::vector<char> buffer(64 * 1024);
+    bool ok = true;
+    while (ok && in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        auto count = static_cast<unsigned>(in.gcount());
+        if (count > 0 && gzwrite(out, buffer.data(), count) != static_cast<int>(count)) {
+            ok = false;
+        }
+    }
+    ok = ok && in.eof();
+
+    if (gzclose(out) != Z_OK) {
+        ok = false;
+    }
+    if (!ok) {
+        std::error_code ec;
+        std::filesystem::remove(destination, ec);
+    }
+    return ok;
+}
+
+} // namespace ap
@@ -0,0 +1,184 @@
+#include "data_package_cache.h"
+#include "ap_logger.h"
+#include "ap_path_util.h"
+
+#include <cctype>
+#include <cstdint>
+#include <vector>
+
+namespace ap {
+
+namespace {
+
+constexpr int CACHE_FORMAT_VERSION = 1;
+constexpr const char* CACHE_EXTENSION = ".apdp";
+
+// Keep file names portable; the real game name is stored inside the file
+std::string sanitize(const std::string& value) {
+    std::string result;
+    result.reserve(value.size());
+    for (unsigned char c : value) {
+        result += (std::isalnum(c) || c == '-') ? static_cast<char>(c) : '_';
+    }
+    return result;
+}
+
+// Checks every field load_all() reads, so a damaged or foreign file can
+// never throw out of it
+bool is_valid_record(const nlohmann::json& record) {
+    if (!record.is_object()) {
+        return false;
+    }
+    auto version = record.find("version");
+    auto game = record.find("game");
+    auto checksum = record.find("checksum");
+    auto data = record.find("data");
+    if (version == record.end() || !version->is_number_integer() || *version != CACHE_FORMAT_VERSION ||
+        game == record.end() || !game->is_string() || game->get_ref<const std::string&>().empty() ||
+        checksum == record.end() || !checksum->is_string() ||
+        data == record.end() || !data->is_object()) {
+        return false;
+    }
+    auto data_checksum = data->find("checksum");
+    return data_checksum != data->end() && *data_checksum == *checksum;
+}
+
+} // namespace
+
+DataPackageCache::DataPackageCache(std::filesystem::path folder)
+    : folder_(std::move(folder)) {}
+
+nlohmann::json DataPackageCache::load_all() {
+    nlohmann::json data_package = {{"games", nlohmann::json::object()}};
+    cached_.clear();
+
+    std::error_code ec;
+    if (!std::filesystem::is_directory(folder_, ec)) {
+        return data_package;
+    }
+
+    // Newest file per game wins; older checksums are stale leftovers
+    struct Candidate {
+        std::string checksum;
+        std::filesystem::path path;
+        std::filesystem::file_time_type written;
+        nlohmann::json data;
+    };
+    std::unordered_map<std::string, Candidate> newest;
+    std::vector<std::filesystem::path> stale;
+
+    for (const auto& entry : std::filesystem::directory_iterator(folder_, ec)) {
+        if (ec || !entry.is_regular_file() || entry.path().extension() != CACHE_EXTENSION) {
+            continue;
+        }
+
+        std::string bytes = APPathUtil::read_file(entry.path());
+        nlohmann::json record = nlohmann::json::from_msgpack(bytes, true, false);
+
+        if (record.is_discarded() || !is_valid_record(record)) {
+            AP_LOG_WARN("Discarding unreadable data package cache file: ", entry.path().filename().string());
+            stale.push_back(entry.path());
+            continue;
+        }
+
+        std::string game = record["game"].get<std::string>();
+        std::string checksum = record["checksum"].get<std::string>();
+
+        auto written = entry.last_write_time(ec);
+        auto it = newest.find(game);
+        if (it != newest.end()) {
+            if (it->second.written >= written) {
+                stale.push_back(entry.path());
+                continue;
+            }
+            stale.push_back(it->second.path);
+        }
+
+        newest[game] = {checksum, entry.path(), written, std::move(record["data"])};
+    }
+
+    for (const auto& path : stale) {
+        remove_file(path);
+    }
+
+    for (auto& [game, candidate] : newest) {
+        cached_[game] = {candidate.checksum, candidate.path};
+        data_package["games"][game] = std::move(candidate.data);
+    }
+
+    if (!cached_.empty()) {
+        AP_LOG_INFO("Loaded cached data package for ", cached_.size(), " games");
+    }
+
+    return data_package;
+}
+
+size_t DataPackageCache::store(const nlohmann::json& data_package) {
+    auto games_it = data_package.find("games");
+    if (games_it == data_package.end() || !games_it->is_object()) {
+        return 0;
+    }
+
+    size_t written = 0;
+    for (const auto& [game, game_data] : games_it->items()) {
+        std::string checksum = game_data.value("checksum", "");
+        if (checksum.empty()) {
+            continue;
+        }
+
+        auto cached_it = cached_.find(game);
+        if (cached_it != cached_.end() && cached_it->second.checksum == checksum) {
+            continue;
+        }
+
+        nlohmann::json record = {
+            {"version", CACHE_FORMAT_VERSION},
+            {"game", game},
+            {"checksum", checksum},
+            {"data", game_data}
+        };
+        std::vector<std::uint8_t> bytes = nlohmann::json::to_msgpack(record);
+
+        // Write to a temp file first so a crash never leaves a truncated entry
+        auto path = path_for(game, checksum);
+        auto temp_path = path;
+        temp_path += ".tmp";
+        if (!APPathUtil::write_file(temp_path, std::string(bytes.begin(), bytes.end()))) {
+            AP_LOG_WARN("Failed to write data package cache for ", game);
+            remove_file(temp_path);
+            continue;
+        }
+
+        std::error_code ec;
+        remove_file(path);
+        std::filesystem::rename(temp_path, path, ec);
+        if (ec) {
+            AP_LOG_WARN("Failed to write data package cache for ", game, ": ", ec.message());
+            remove_file(temp_path);
+            continue;
+        }
+
+        if (cached_it != cached_.end() && cached_it->second.path != path) {
+            remove_file(cached_it->second.path);
+        }
+        cached_[game] = {checksum, path};
+        ++written;
+    }
+
+    if (written > 0) {
+        AP_LOG_INFO("Cached data package for ", written, " games");
+    }
+
+    return written;
+}
+
+std::filesystem::path DataPackageCache::path_for(const std::string& game, const std::string& checksum) const {
+    return folder_ / (sanitize(game) + "_" + sanitize(checksum) + CACHE_EXTENSION);
+}
+
+void DataPackageCache::remove_file(const std::filesystem::path& path) {
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+} // namespace ap
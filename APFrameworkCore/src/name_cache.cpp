@@ -0,0 +1,122 @@
+#include "name_cache.h"
+
+#include <algorithm>
+
+namespace ap {
+
+// =============================================================================
+// NameTable
+// =============================================================================
+
+void NameTable::assign(std::vector<NameEntry> entries) {
+    std::sort(entries.begin(), entries.end(),
+              [](const NameEntry& a, const NameEntry& b) { return a.id < b.id; });
+    entries_ = std::move(entries);
+}
+
+std::string_view NameTable::find(int64_t id) const {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), id,
+                               [](const NameEntry& entry, int64_t value) { return entry.id < value; });
+    if (it != entries_.end() && it->id == id) {
+        return it->name;
+    }
+    return {};
+}
+
+// =============================================================================
+// NameCache
+// =============================================================================
+
+std::string_view NameCache::StringPool::intern(std::string_view value) {
+    // unordered_set nodes never move, so views into them stay valid
+    return *strings.emplace(value).first;
+}
+
+std::shared_ptr<const NameCache> NameCache::build(const nlohmann::json& data_package,
+                                                  const std::vector<Player>& players) {
+    auto tables = std::make_shared<GameTables>();
+
+    auto games_it = data_package.find("games");
+    if (games_it != data_package.end() && games_it->is_object()) {
+        for (const auto& [game_name, game_data] : games_it->items()) {
+            GameNames names;
+
+            auto fill = [&](const char* key, NameTable& table) {
+                auto map_it = game_data.find(key);
+                if (map_it == game_data.end() || !map_it->is_object()) {
+                    return;
+                }
+                std::vector<NameEntry> entries;
+                entries.reserve(map_it->size());
+                for (const auto& [name, id] : map_it->items()) {
+                    if (id.is_number_integer()) {
+                        entries.push_back({id.get<int64_t>(), tables->pool.intern(name)});
+                    }
+                }
+                table.assign(std::move(entries));
+            };
+
+            fill("item_name_to_id", names.items);
+            fill("location_name_to_id", names.locations);
+
+            tables->games.emplace(tables->pool.intern(game_name), std::move(names));
+        }
+    }
+
+    auto cache = std::make_shared<NameCache>();
+    cache->games_ = std::move(tables);
+    cache->players_ = build_players(players);
+    return cache;
+}
+
+std::shared_ptr<const NameCache> NameCache::with_players(const std::shared_ptr<const NameCache>& base,
+                                                         const std::vector<Player>& players) {
+    auto cache = std::make_shared<NameCache>();
+    cache->games_ = base ? base->games_ : std::make_shared<GameTables>();
+    cache->players_ = build_players(players);
+    return cache;
+}
+
+std::shared_ptr<const NameCache::PlayerTable> NameCache::build_players(const std::vector<Player>& players) {
+    auto table = std::make_shared<PlayerTable>();
+    table->entries.reserve(players.size());
+    for (const auto& player : players) {
+        table->entries.push_back({player.slot,
+                                  table->pool.intern(player.alias),
+                                  table->pool.intern(player.game)});
+    }
+    std::sort(table->entries.begin(), table->entries.end(),
+              [](const PlayerNames& a, const PlayerNames& b) { return a.slot < b.slot; });
+    return table;
+}
+
+const GameNames* NameCache::game(std::string_view game_name) const {
+    auto it = games_->games.find(game_name);
+    return it != games_->games.end() ? &it->second : nullptr;
+}
+
+std::string_view NameCache::item_name(std::string_view game_name, int64_t item_id) const {
+    const GameNames* names = game(game_name);
+    return names ? names->items.find(item_id) : std::string_view{};
+}
+
+std::string_view NameCache::location_name(std::string_view game_name, int64_t location_id) const {
+    const GameNames* names = game(game_name);
+    return names ? names->locations.find(location_id) : std::string_view{};
+}
+
+const PlayerNames* NameCache::player(int slot) const {
+    const auto& entries = players_->entries;
+    auto it = std::lower_bound(entries.begin(), entries.end(), slot,
+                               [](const PlayerNames& entry, int value) { return entry.slot < value; });
+    if (it != entries.end() && it->slot == slot) {
+        return &*it;
+    }
+    return nullptr;
+}
+
+size_t NameCache::game_count() const {
+    return games_->games.size();
+}
+
+} // namespace ap
@@ -0,0 +1,289 @@
+// Microbenchmark: polling-thread -> main-thread event hand-off.
+//
+// Compares ThreadSafeQueue<FrameworkEvent> (mutex + condition variable)
+// against SPSCRingBuffer<FrameworkEvent> with one producer thread pushing
+// item events and one consumer thread draining with pop_all(), the same
+// pattern APPollingThread and APManager::update() used to follow. The last
+// case is EventQueue as used today: events filled into recycled slots and
+// consumed in place, and the same for item batches routed in chunks the way
+// APManager spreads them over updates. Heap allocations per event are
+// reported for each case, in total and on the consuming (main) thread.
+//
+// The producer pushes bursts (like the events from one ReceivedItems or
+// PrintJSON packet) and waits for the consumer to catch up before the next
+// burst, so the ring does not sit permanently full and spill.
+//
+// Usage: event_queue_bench [events] [runs]
+
+#include "message_queues.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+using namespace ap;
+
+// Count every heap allocation in the process, and per thread
+static std::atomic<size_t> g_allocations{0};
+static thread_local size_t t_allocations = 0;
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    ++t_allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+constexpr int BURST_SIZE = 32;
+constexpr size_t ITEM_CHUNK = 8;
+
+// Long enough to defeat the small-string optimization
+const std::string ITEM_NAME = "Progressive Grappling Hook Upgrade";
+const std::string SENDER = "SomePlayerWithALongName";
+
+FrameworkEvent make_event(int i) {
+    ItemReceivedEvent event;
+    event.item_id = 6942000 + (i % 100);
+    event.item_name = ITEM_NAME;
+    event.sender = SENDER;
+    event.location_id = i;
+    event.is_self = false;
+    event.index = i;
+    return event;
+}
+
+// Producer side: after each burst, wait until the consumer has caught up
+void end_of_burst(int produced, const std::atomic<int>& consumed) {
+    if (produced % BURST_SIZE == 0) {
+        while (consumed.load(std::memory_order_acquire) < produced) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void check_order(const FrameworkEvent& event, int& expected_index) {
+    const auto& item = std::get<ItemReceivedEvent>(event);
+    if (item.index != expected_index) {
+        std::fprintf(stderr, "Order violation: got %d, expected %d\n",
+                     item.index, expected_index);
+        std::exit(1);
+    }
+    ++expected_index;
+}
+
+struct RunResult {
+    double ns_per_event;
+    double allocations_per_event;
+    double main_allocations_per_event;
+};
+
+// Measures one run; the calling thread is the consumer
+class RunTimer {
+public:
+    RunTimer()
+        : allocations_(g_allocations.load()),
+          main_allocations_(t_allocations),
+          start_(std::chrono::steady_clock::now()) {}
+
+    RunResult finish(int events) const {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        return {std::chrono::duration<double, std::nano>(elapsed).count() / events,
+                static_cast<double>(g_allocations.load() - allocations_) / events,
+                static_cast<double>(t_allocations - main_allocations_) / events};
+    }
+
+private:
+    size_t allocations_;
+    size_t main_allocations_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Producer pushes built events, consumer drains copies with pop_all()
+template <typename Queue>
+RunResult run_pop_all(Queue& queue, int events) {
+    RunTimer timer;
+
+    std::atomic<int> consumed{0};
+    std::thread producer([&queue, &consumed, events]() {
+        for (int i = 0; i < events; ++i) {
+            queue.push(make_event(i));
+            end_of_burst(i + 1, consumed);
+        }
+    });
+
+    int expected_index = 0;
+    while (expected_index < events) {
+        auto batch = queue.pop_all();
+        for (const auto& event : batch) {
+            check_order(event, expected_index);
+        }
+        consumed.store(expected_index, std::memory_order_release);
+        if (batch.empty()) {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    return timer.finish(events);
+}
+
+// Producer fills recycled slots, consumer reads them in place
+RunResult run_in_place(EventQueue& queue, int events) {
+    RunTimer timer;
+
+    std::atomic<int> consumed{0};
+    std::thread producer([&queue, &consumed, events]() {
+        for (int i = 0; i < events; ++i) {
+            queue.emplace<ItemReceivedEvent>([i](ItemReceivedEvent& event) {
+                event.item_id = 6942000 + (i % 100);
+                event.item_name = ITEM_NAME;
+                event.sender = SENDER;
+                event.location_id = i;
+                event.is_self = false;
+                event.index = i;
+            });
+            end_of_burst(i + 1, consumed);
+        }
+    });
+
+    int expected_index = 0;
+    while (expected_index < events) {
+        size_t visited = queue.consume_all([&expected_index](const FrameworkEvent& event) {
+            check_order(event, expected_index);
+        });
+        consumed.store(expected_index, std::memory_order_release);
+        if (visited == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    return timer.finish(events);
+}
+
+// Producer fills one batch event per burst, consumer routes it in chunks
+// from the slot, leaving the batch queued between chunks
+RunResult run_batches_in_place(EventQueue& queue, int events) {
+    RunTimer timer;
+
+    std::atomic<int> consumed{0};
+    std::thread producer([&queue, &consumed, events]() {
+        for (int first = 0; first < events; first += BURST_SIZE) {
+            int count = std::min(BURST_SIZE, events - first);
+            queue.emplace<ItemBatchReceivedEvent>([first, count](ItemBatchReceivedEvent& batch) {
+                batch.items.resize(count);
+                for (int i = 0; i < count; ++i) {
+                    auto& event = batch.items[i];
+                    event.item_id = 6942000 + ((first + i) % 100);
+                    event.item_name = ITEM_NAME;
+                    event.sender = SENDER;
+                    event.location_id = first + i;
+                    event.is_self = false;
+                    event.index = first + i;
+                }
+            });
+            end_of_burst(first + count, consumed);
+        }
+    });
+
+    int expected_index = 0;
+    size_t routed = 0;
+    while (expected_index < events) {
+        // One chunk per call, like one update with its budget spent
+        size_t chunks = 0;
+        queue.consume_while([&](const FrameworkEvent& event) {
+            const auto& items = std::get<ItemBatchReceivedEvent>(event).items;
+            size_t end = std::min(items.size(), routed + ITEM_CHUNK);
+            for (; routed < end; ++routed) {
+                if (items[routed].index != expected_index++) {
+                    std::fprintf(stderr, "Order violation at %d\n", expected_index - 1);
+                    std::exit(1);
+                }
+            }
+            ++chunks;
+            if (routed < items.size()) {
+                return false;
+            }
+            routed = 0;
+            return true;
+        }, [&chunks]() { return chunks == 0; });
+
+        consumed.store(expected_index, std::memory_order_release);
+        if (chunks == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    return timer.finish(events);
+}
+
+template <typename MakeQueue, typename Run>
+void bench(const char* name, MakeQueue make_queue, Run run, int events, int runs) {
+    double best = 0.0;
+    double total = 0.0;
+    double allocations = 0.0;
+    double main_allocations = 0.0;
+    for (int r = 0; r < runs; ++r) {
+        auto queue = make_queue();
+        RunResult result = run(*queue, events);
+        total += result.ns_per_event;
+        allocations += result.allocations_per_event;
+        main_allocations += result.main_allocations_per_event;
+        if (r == 0 || result.ns_per_event < best) {
+            best = result.ns_per_event;
+        }
+    }
+    std::printf("%-36s best %8.1f ns/event   mean %8.1f ns/event   %5.2f allocs/event"
+                "   %5.2f on main\n",
+                name, best, total / runs, allocations / runs, main_allocations / runs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int events = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int runs = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::printf("%d events x %d runs\n", events, runs);
+
+    bench("ThreadSafeQueue", []() {
+        return std::make_unique<ThreadSafeQueue<FrameworkEvent>>();
+    }, [](auto& q, int n) { return run_pop_all(q, n); }, events, runs);
+
+    bench("SPSCRingBuffer (1024, Spill)", []() {
+        return std::make_unique<SPSCRingBuffer<FrameworkEvent>>(1024, OverflowPolicy::Spill);
+    }, [](auto& q, int n) { return run_pop_all(q, n); }, events, runs);
+
+    bench("SPSCRingBuffer (64, Spill)", []() {
+        return std::make_unique<SPSCRingBuffer<FrameworkEvent>>(64, OverflowPolicy::Spill);
+    }, [](auto& q, int n) { return run_pop_all(q, n); }, events, runs);
+
+    bench("EventQueue (recycled, in place)", []() {
+        return std::make_unique<EventQueue>();
+    }, [](EventQueue& q, int n) { return run_in_place(q, n); }, events, runs);
+
+    bench("EventQueue (batches, chunked)", []() {
+        return std::make_unique<EventQueue>();
+    }, [](EventQueue& q, int n) { return run_batches_in_place(q, n); }, events, runs);
+
+    return 0;
+}
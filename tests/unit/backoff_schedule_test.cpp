@@ -0,0 +1,120 @@
+#include "retry_util.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+using ap::BackoffSchedule;
+using ap::RetryPolicy;
+using std::chrono::milliseconds;
+
+namespace {
+
+RetryPolicy policy(int max_retries, double jitter = 0.0) {
+    RetryPolicy result;
+    result.max_retries = max_retries;
+    result.initial_delay_ms = 100;
+    result.backoff_multiplier = 2.0;
+    result.max_delay_ms = 1000;
+    result.jitter = jitter;
+    return result;
+}
+
+} // namespace
+
+TEST(BackoffSchedule, DelaysGrowUntilTheCap) {
+    BackoffSchedule backoff(policy(-1));
+
+    std::vector<int64_t> delays;
+    for (int i = 0; i < 6; ++i) {
+        delays.push_back(backoff.schedule()->count());
+        backoff.begin_attempt();
+    }
+    EXPECT_EQ(delays, std::vector<int64_t>({100, 200, 400, 800, 1000, 1000}));
+}
+
+TEST(BackoffSchedule, StopsOnceTheRetryBudgetIsSpent) {
+    BackoffSchedule backoff(policy(2));
+
+    ASSERT_TRUE(backoff.schedule());
+    EXPECT_EQ(backoff.begin_attempt(), 1);
+    ASSERT_TRUE(backoff.schedule());
+    EXPECT_EQ(backoff.begin_attempt(), 2);
+
+    EXPECT_TRUE(backoff.exhausted());
+    EXPECT_EQ(backoff.schedule(), std::nullopt);
+    EXPECT_EQ(backoff.attempts(), 2);
+}
+
+TEST(BackoffSchedule, ZeroRetriesNeverSchedules) {
+    BackoffSchedule backoff(policy(0));
+    EXPECT_TRUE(backoff.exhausted());
+    EXPECT_EQ(backoff.schedule(), std::nullopt);
+}
+
+TEST(BackoffSchedule, NegativeRetriesNeverRunOut) {
+    BackoffSchedule backoff(policy(-1));
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(backoff.schedule());
+        backoff.begin_attempt();
+    }
+    EXPECT_FALSE(backoff.exhausted());
+}
+
+TEST(BackoffSchedule, ResetStartsOverFromTheInitialDelay) {
+    BackoffSchedule backoff(policy(3));
+    backoff.schedule();
+    backoff.begin_attempt();
+    backoff.schedule();
+    backoff.begin_attempt();
+
+    backoff.reset();
+    EXPECT_EQ(backoff.attempts(), 0);
+    EXPECT_EQ(backoff.schedule(), milliseconds(100));
+}
+
+TEST(BackoffSchedule, JitterStaysWithinTheConfiguredFraction) {
+    BackoffSchedule backoff(policy(-1, 0.25));
+
+    bool varied = false;
+    for (int i = 0; i < 200; ++i) {
+        backoff.reset();
+        auto delay = backoff.schedule();
+        ASSERT_TRUE(delay);
+        EXPECT_GE(delay->count(), 75);
+        EXPECT_LE(delay->count(), 125);
+        varied = varied || delay->count() != 100;
+    }
+    EXPECT_TRUE(varied);
+}
+
+TEST(BackoffSchedule, JitterDoesNotCompoundIntoTheBaseDelay) {
+    BackoffSchedule backoff(policy(-1, 0.5));
+    for (int i = 0; i < 10; ++i) {
+        backoff.schedule();
+    }
+
+    // The base has reached the cap; each jittered delay spreads around it
+    for (int i = 0; i < 100; ++i) {
+        auto delay = backoff.schedule();
+        EXPECT_GE(delay->count(), 500);
+        EXPECT_LE(delay->count(), 1500);
+    }
+}
+
+TEST(RetryPolicy, FromConfigCopiesEveryField) {
+    ap::RetryConfig config;
+    config.max_retries = 7;
+    config.initial_delay_ms = 250;
+    config.backoff_multiplier = 1.5;
+    config.max_delay_ms = 4000;
+    config.jitter = 0.1;
+
+    RetryPolicy result = RetryPolicy::from_config(config);
+    EXPECT_EQ(result.max_retries, 7);
+    EXPECT_EQ(result.initial_delay_ms, 250);
+    EXPECT_DOUBLE_EQ(result.backoff_multiplier, 1.5);
+    EXPECT_EQ(result.max_delay_ms, 4000);
+    EXPECT_DOUBLE_EQ(result.jitter, 0.1);
+}
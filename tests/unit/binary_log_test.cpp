@@ -0,0 +1,184 @@
+#include "binary_log.h"
+#include "ap_logger.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace binary_log = ap::binary_log;
+
+namespace {
+
+template <typename... Args>
+std::string format(std::string_view text, const Args&... args) {
+    std::string encoded;
+    binary_log::encode_args(encoded, args...);
+    return binary_log::format_message(text, encoded.data(), encoded.size());
+}
+
+} // namespace
+
+TEST(BinaryLog, ArgumentsRoundTripThroughFormatMessage) {
+    EXPECT_EQ(format("{} {} {}", 42, -7, std::numeric_limits<uint64_t>::max()),
+              "42 -7 18446744073709551615");
+    EXPECT_EQ(format("{} {}", true, false), "true false");
+    EXPECT_EQ(format("{}", 1.5), "1.500000");
+    EXPECT_EQ(format("[{}] [{}] [{}]", std::string("text"), "literal", 'c'), "[text] [literal] [c]");
+
+    const char* null_text = nullptr;
+    EXPECT_EQ(format("{}", null_text), "(null)");
+}
+
+TEST(BinaryLog, MissingArgumentsLeavePlaceholders) {
+    EXPECT_EQ(format("a {} b {}", 1), "a 1 b {}");
+    EXPECT_EQ(format("no placeholders"), "no placeholders");
+}
+
+TEST(BinaryLog, ExtraArgumentsAreAppended) {
+    EXPECT_EQ(format("count {}", 1, "extra", 2), "count 1 extra 2");
+}
+
+TEST(BinaryLog, TruncatedArgumentsAreReportedNotOverread) {
+    std::string encoded;
+    binary_log::encode_args(encoded, 1, std::string("abcdef"));
+    encoded.resize(encoded.size() - 3);
+
+    EXPECT_EQ(binary_log::format_message("{}", encoded.data(), encoded.size()), "1 <corrupt>");
+    EXPECT_EQ(binary_log::format_message("{} {}", encoded.data(), encoded.size()), "1 {} <corrupt>");
+
+    std::string unknown_tag = "?";
+    EXPECT_EQ(binary_log::format_message("x", unknown_tag.data(), unknown_tag.size()), "x <corrupt>");
+}
+
+TEST(BinaryLog, LongStringsAreCappedAtTheFieldLimit) {
+    std::string encoded;
+    binary_log::encode_arg(encoded, std::string(binary_log::MAX_FIELD_LENGTH + 10, 'x'));
+
+    std::string decoded = binary_log::format_message("{}", encoded.data(), encoded.size());
+    EXPECT_EQ(decoded.size(), binary_log::MAX_FIELD_LENGTH);
+}
+
+TEST(BinaryLog, ReaderStopsAtTheEndOfTheBuffer) {
+    std::string data;
+    binary_log::append_raw<uint16_t>(data, 0x1234);
+    binary_log::append_string(data, "hi");
+
+    binary_log::Reader reader(data.data(), data.size());
+    uint16_t value = 0;
+    std::string_view text;
+    ASSERT_TRUE(reader.read(value));
+    EXPECT_EQ(value, 0x1234);
+    ASSERT_TRUE(reader.read_string(text));
+    EXPECT_EQ(text, "hi");
+    EXPECT_TRUE(reader.done());
+
+    uint32_t past_end = 0;
+    EXPECT_FALSE(reader.read(past_end));
+}
+
+// =============================================================================
+// APLogger with the binary log open
+// =============================================================================
+
+class BinaryLogFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        path_ = std::filesystem::temp_directory_path() /
+                ("ap_binary_log_test_" + std::to_string(stamp) + ".aplb");
+    }
+
+    void TearDown() override {
+        ap::APLogger::instance().shutdown();
+        ap::APLogger::instance().set_console_output(true);
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+    }
+
+    // Format text of every record in the file, formatted the way ap_log_decoder does
+    std::vector<std::string> decode() const {
+        std::ifstream in(path_, std::ios::binary);
+        std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        binary_log::Reader reader(data.data(), data.size());
+        char magic[sizeof(binary_log::FILE_MAGIC)] = {};
+        uint16_t version = 0;
+        for (char& c : magic) {
+            reader.read(c);
+        }
+        EXPECT_EQ(std::string(magic, sizeof(magic)), std::string(binary_log::FILE_MAGIC, sizeof(magic)));
+        EXPECT_TRUE(reader.read(version));
+        EXPECT_EQ(version, binary_log::FILE_VERSION);
+
+        std::map<uint32_t, std::string> formats = {{binary_log::PLAIN_FORMAT_ID, "{}"}};
+        std::vector<std::string> messages;
+        while (!reader.done()) {
+            uint8_t tag = 0;
+            reader.read(tag);
+
+            bool ok = true;
+            if (tag == binary_log::TAG_COMPONENT) {
+                uint16_t id = 0;
+                std::string_view name;
+                ok = reader.read(id) && reader.read_string(name);
+            } else if (tag == binary_log::TAG_THREAD) {
+                uint8_t id = 0;
+                std::string_view name;
+                ok = reader.read(id) && reader.read_string(name);
+            } else if (tag == binary_log::TAG_FORMAT) {
+                uint32_t id = 0;
+                uint16_t component = 0;
+                std::string_view text;
+                ok = reader.read(id) && reader.read(component) && reader.read_string(text);
+                formats[id] = std::string(text);
+            } else if (tag == binary_log::TAG_RECORD) {
+                int64_t time = 0;
+                uint8_t level = 0;
+                uint8_t thread = 0;
+                uint16_t component = 0;
+                uint32_t format_id = 0;
+                std::string_view args;
+                ok = reader.read(time) && reader.read(level) && reader.read(thread) &&
+                     reader.read(component) && reader.read(format_id) && reader.read_string(args);
+                messages.push_back(binary_log::format_message(formats[format_id], args.data(), args.size()));
+            } else {
+                ok = false;
+            }
+            EXPECT_TRUE(ok) << "bad entry tag " << static_cast<int>(tag);
+            if (!ok) {
+                break;
+            }
+        }
+        return messages;
+    }
+
+    std::filesystem::path path_;
+};
+
+TEST_F(BinaryLogFileTest, FormatRecordsDecodeAndStillReachTextSinks) {
+    ap::APLogger& logger = ap::APLogger::instance();
+    ASSERT_TRUE(logger.init(ap::LogLevel::Info, "", false, path_.string()));
+    ASSERT_TRUE(logger.is_binary_enabled());
+
+    std::vector<std::string> lines;
+    logger.set_log_callback([&](ap::LogLevel, const std::string& line) { lines.push_back(line); });
+
+    AP_LOG_FMT(ap::LogLevel::Info, ap::LogComponent::Router, "Routed {} items to {}", 3, "mod.a");
+    AP_LOG_FMT(ap::LogLevel::Debug, ap::LogComponent::Router, "Filtered {}", 1);
+    AP_LOG_INFO("plain ", 7);
+    logger.shutdown();
+
+    EXPECT_EQ(decode(), std::vector<std::string>({"Routed 3 items to mod.a", "plain 7"}));
+
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_NE(lines[0].find("[Router] Routed 3 items to mod.a"), std::string::npos) << lines[0];
+    EXPECT_NE(lines[1].find("plain 7"), std::string::npos) << lines[1];
+}
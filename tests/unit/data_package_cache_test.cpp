@@ -0,0 +1,144 @@
+#include "data_package_cache.h"
+#include "ap_logger.h"
+
+#include <gtest/gtest.h>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using ap::DataPackageCache;
+using nlohmann::json;
+
+namespace {
+
+json game_data(const std::string& checksum, int64_t item_id) {
+    return {
+        {"checksum", checksum},
+        {"item_name_to_id", {{"Sword", item_id}}},
+        {"location_name_to_id", {{"Chest", item_id + 1000}}}
+    };
+}
+
+json package(const std::string& game, const json& data) {
+    return {{"games", {{game, data}}}};
+}
+
+} // namespace
+
+class DataPackageCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ap::APLogger::instance().set_console_output(false);
+
+        auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        folder_ = std::filesystem::temp_directory_path() / ("ap_dp_cache_test_" + std::to_string(stamp));
+        std::filesystem::create_directories(folder_);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        std::filesystem::remove_all(folder_, ec);
+        ap::APLogger::instance().set_console_output(true);
+    }
+
+    void write_raw(const std::string& name, const std::vector<std::uint8_t>& bytes) {
+        std::ofstream out(folder_ / name, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    std::vector<std::string> files() const {
+        std::vector<std::string> names;
+        for (const auto& entry : std::filesystem::directory_iterator(folder_)) {
+            names.push_back(entry.path().filename().string());
+        }
+        return names;
+    }
+
+    std::filesystem::path folder_;
+};
+
+TEST_F(DataPackageCacheTest, MissingFolderLoadsNothing) {
+    DataPackageCache cache(folder_ / "missing");
+    EXPECT_EQ(cache.load_all(), json({{"games", json::object()}}));
+}
+
+TEST_F(DataPackageCacheTest, StoredGamesRoundTrip) {
+    json stored = {{"games", {{"Game A", game_data("aaa", 1)}, {"Game B", game_data("bbb", 2)}}}};
+    {
+        DataPackageCache cache(folder_);
+        EXPECT_EQ(cache.store(stored), 2u);
+    }
+
+    DataPackageCache reloaded(folder_);
+    EXPECT_EQ(reloaded.load_all(), stored);
+}
+
+TEST_F(DataPackageCacheTest, SkipsGamesAlreadyCachedOrWithoutChecksum) {
+    DataPackageCache cache(folder_);
+    EXPECT_EQ(cache.store(package("Game A", game_data("aaa", 1))), 1u);
+    EXPECT_EQ(cache.store(package("Game A", game_data("aaa", 1))), 0u);
+
+    json no_checksum = game_data("", 1);
+    no_checksum.erase("checksum");
+    EXPECT_EQ(cache.store(package("Game B", no_checksum)), 0u);
+
+    EXPECT_EQ(cache.store(json::object()), 0u);
+    EXPECT_EQ(files().size(), 1u);
+}
+
+TEST_F(DataPackageCacheTest, NewChecksumReplacesTheOldFile) {
+    DataPackageCache cache(folder_);
+    cache.store(package("Game A", game_data("old", 1)));
+    cache.store(package("Game A", game_data("new", 2)));
+
+    EXPECT_EQ(files().size(), 1u);
+
+    DataPackageCache reloaded(folder_);
+    EXPECT_EQ(reloaded.load_all(), package("Game A", game_data("new", 2)));
+}
+
+TEST_F(DataPackageCacheTest, CorruptFileIsDeletedAndOthersStillLoad) {
+    {
+        DataPackageCache cache(folder_);
+        cache.store(package("Game A", game_data("aaa", 1)));
+    }
+    write_raw("broken.apdp", {0xc1, 0xff, 0x00, 0x13});
+
+    DataPackageCache cache(folder_);
+    EXPECT_EQ(cache.load_all(), package("Game A", game_data("aaa", 1)));
+    EXPECT_FALSE(std::filesystem::exists(folder_ / "broken.apdp"));
+}
+
+TEST_F(DataPackageCacheTest, RecordWithWrongFieldTypesIsDeletedWithoutThrowing) {
+    write_raw("numeric_game.apdp", json::to_msgpack({
+        {"version", 1}, {"game", 42}, {"checksum", "aaa"}, {"data", game_data("aaa", 1)}
+    }));
+    write_raw("array_data.apdp", json::to_msgpack({
+        {"version", 1}, {"game", "Game A"}, {"checksum", "aaa"}, {"data", json::array({1, 2})}
+    }));
+    write_raw("string_version.apdp", json::to_msgpack({
+        {"version", "1"}, {"game", "Game A"}, {"checksum", "aaa"}, {"data", game_data("aaa", 1)}
+    }));
+    write_raw("not_an_object.apdp", json::to_msgpack(json::array({1, 2, 3})));
+
+    DataPackageCache cache(folder_);
+    json loaded;
+    EXPECT_NO_THROW(loaded = cache.load_all());
+    EXPECT_EQ(loaded, json({{"games", json::object()}}));
+    EXPECT_TRUE(files().empty());
+}
+
+TEST_F(DataPackageCacheTest, RecordWhoseDataChecksumDisagreesIsDeleted) {
+    write_raw("mismatch.apdp", json::to_msgpack({
+        {"version", 1}, {"game", "Game A"}, {"checksum", "aaa"}, {"data", game_data("zzz", 1)}
+    }));
+
+    DataPackageCache cache(folder_);
+    EXPECT_EQ(cache.load_all(), json({{"games", json::object()}}));
+    EXPECT_TRUE(files().empty());
+}
@@ -0,0 +1,58 @@
+#include "frame_budget.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+using ap::FrameBudget;
+using namespace std::chrono_literals;
+
+TEST(FrameBudget, FreshBudgetHasTime) {
+    FrameBudget budget(1s);
+    EXPECT_TRUE(budget.has_time());
+    EXPECT_FALSE(budget.spent());
+}
+
+TEST(FrameBudget, RunsOutOnceTheDeadlinePasses) {
+    FrameBudget budget(1ms);
+    std::this_thread::sleep_for(5ms);
+
+    EXPECT_FALSE(budget.has_time());
+    EXPECT_TRUE(budget.spent());
+    EXPECT_GE(budget.elapsed(), 1ms);
+}
+
+TEST(FrameBudget, SpentIsOnlySetByHasTime) {
+    FrameBudget budget(1ms);
+    std::this_thread::sleep_for(5ms);
+
+    // Nobody asked yet, so no work was cut short
+    EXPECT_FALSE(budget.spent());
+    EXPECT_FALSE(budget.has_time());
+    EXPECT_TRUE(budget.spent());
+}
+
+TEST(FrameBudget, StaysSpentForTheRestOfTheUpdate) {
+    FrameBudget budget(1ms);
+    std::this_thread::sleep_for(5ms);
+    ASSERT_FALSE(budget.has_time());
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_FALSE(budget.has_time());
+    }
+    EXPECT_TRUE(budget.spent());
+}
+
+TEST(FrameBudget, ZeroBudgetNeverRunsOut) {
+    FrameBudget budget(0us);
+    std::this_thread::sleep_for(2ms);
+
+    EXPECT_TRUE(budget.has_time());
+    EXPECT_FALSE(budget.spent());
+}
+
+TEST(FrameBudget, NegativeBudgetIsTreatedAsUnlimited) {
+    FrameBudget budget(-5us);
+    EXPECT_TRUE(budget.has_time());
+}
@@ -0,0 +1,195 @@
+#include "ap_capabilities.h"
+#include "ap_logger.h"
+#include "ap_message_router.h"
+#include "ap_state_manager.h"
+#include "frame_budget.h"
+#include "message_queues.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace ap;
+
+namespace {
+
+// Named pipes are read into a buffer this size; a larger message is lost
+constexpr size_t IPC_READ_BUFFER = 64 * 1024;
+
+Manifest make_manifest(const std::string& mod_id, const std::string& item_name, size_t arg_length) {
+    Manifest manifest;
+    manifest.mod_id = mod_id;
+    manifest.name = mod_id;
+    manifest.version = "1.0.0";
+
+    ItemDef item;
+    item.name = item_name;
+    item.action = "Mod.Give";
+    item.args.push_back({"payload", ArgType::String, std::string(arg_length, 'x')});
+    item.args.push_back({"count", ArgType::Number, "<GET_PROGRESSION_COUNT>"});
+    manifest.items.push_back(item);
+    return manifest;
+}
+
+} // namespace
+
+class MessageRouterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        APLogger::instance().set_console_output(false);
+
+        capabilities_.add_manifest(make_manifest("big.mod", "Big Item", 600));
+        capabilities_.add_manifest(make_manifest("small.mod", "Small Item", 4));
+        capabilities_.assign_ids();
+        big_id_ = capabilities_.get_items_for_mod("big.mod").at(0).item_id;
+        small_id_ = capabilities_.get_items_for_mod("small.mod").at(0).item_id;
+
+        router_.set_capabilities(&capabilities_);
+        router_.set_ipc_send_callback([this](const std::string& target, const IPCMessage& msg) {
+            EXPECT_EQ(target, msg.target);
+            if (target == unreachable_mod_) {
+                ++failed_sends_;
+                return false;
+            }
+            sent_.push_back(msg);
+            return true;
+        });
+    }
+
+    void TearDown() override {
+        APLogger::instance().set_console_output(true);
+    }
+
+    std::vector<ItemReceivedEvent> items(int64_t item_id, size_t count) const {
+        std::vector<ItemReceivedEvent> result;
+        for (size_t i = 0; i < count; ++i) {
+            result.push_back({item_id, item_id == big_id_ ? "Big Item" : "Small Item", "Player2", 0, false,
+                              static_cast<int>(i)});
+        }
+        return result;
+    }
+
+    APCapabilities capabilities_;
+    APMessageRouter router_;
+    std::vector<IPCMessage> sent_;
+    std::string unreachable_mod_;
+    int failed_sends_ = 0;
+    int64_t big_id_ = 0;
+    int64_t small_id_ = 0;
+};
+
+TEST_F(MessageRouterTest, SmallBatchIsOneMessagePerMod) {
+    auto batch = items(big_id_, 3);
+    auto small = items(small_id_, 2);
+    batch.insert(batch.begin() + 1, small.begin(), small.end());
+
+    auto pending = router_.route_item_receipts(batch);
+
+    EXPECT_EQ(pending.size(), 5u);
+    ASSERT_EQ(sent_.size(), 2u);
+    EXPECT_EQ(sent_[0].target, "big.mod");
+    EXPECT_EQ(sent_[0].payload["actions"].size(), 3u);
+    EXPECT_EQ(sent_[1].target, "small.mod");
+    EXPECT_EQ(sent_[1].payload["actions"].size(), 2u);
+}
+
+TEST_F(MessageRouterTest, OversizedBatchIsSplitToFitTheIpcBuffer) {
+    // 250 items (the default update_item_chunk) of ~700 bytes each is well past 64 KiB
+    const size_t count = 250;
+    auto pending = router_.route_item_receipts(items(big_id_, count));
+    ASSERT_EQ(pending.size(), count);
+    ASSERT_GT(sent_.size(), 1u);
+
+    // Every action arrives once, in order, each message small enough to read
+    int expected_count = 0;
+    for (const auto& msg : sent_) {
+        EXPECT_EQ(msg.type, IPCMessageType::EXECUTE_ACTIONS);
+        EXPECT_EQ(msg.target, "big.mod");
+        EXPECT_LT(msg.to_json().dump().size() + sizeof(uint32_t), IPC_READ_BUFFER);
+
+        for (const auto& action : msg.payload["actions"]) {
+            EXPECT_EQ(action["args"][1]["value"], expected_count++);
+        }
+    }
+    EXPECT_EQ(expected_count, static_cast<int>(count));
+}
+
+TEST_F(MessageRouterTest, SplittingOneModLeavesOtherModsBatched) {
+    auto batch = items(big_id_, 200);
+    auto small = items(small_id_, 10);
+    batch.insert(batch.end(), small.begin(), small.end());
+
+    router_.route_item_receipts(batch);
+
+    size_t small_messages = 0;
+    size_t big_actions = 0;
+    for (const auto& msg : sent_) {
+        if (msg.target == "small.mod") {
+            ++small_messages;
+            EXPECT_EQ(msg.payload["actions"].size(), 10u);
+        } else {
+            big_actions += msg.payload["actions"].size();
+        }
+    }
+    EXPECT_EQ(small_messages, 1u);
+    EXPECT_EQ(big_actions, 200u);
+}
+
+TEST_F(MessageRouterTest, ChunkedBatchKeepsCountingDuplicateItems) {
+    APStateManager state;
+    state.set_item_progression_count(big_id_, 2);
+    router_.set_state_manager(&state);
+
+    // Routed the way APManager spreads a batch over updates with update_item_chunk=1
+    auto batch = items(big_id_, 3);
+    std::unordered_map<int64_t, int> progression_counts;
+    FrameBudget budget(std::chrono::microseconds(0));
+    for (size_t routed = 0; routed < batch.size() && budget.has_time(); ++routed) {
+        router_.route_item_receipts(batch.data() + routed, 1, &progression_counts);
+    }
+
+    // None is acknowledged yet, so each copy gets the next count
+    ASSERT_EQ(sent_.size(), 3u);
+    for (size_t i = 0; i < sent_.size(); ++i) {
+        EXPECT_EQ(sent_[i].payload["actions"][0]["args"][1]["value"], 2 + static_cast<int>(i));
+    }
+}
+
+TEST_F(MessageRouterTest, DeliveredStopsAtTheFirstFailedSend) {
+    unreachable_mod_ = "small.mod";
+    auto batch = items(big_id_, 2);
+    auto small = items(small_id_, 1);
+    batch.insert(batch.end(), small.begin(), small.end());
+
+    size_t delivered = 0;
+    router_.route_item_receipts(batch.data(), batch.size(), nullptr, &delivered);
+
+    EXPECT_EQ(delivered, 2u);
+    EXPECT_EQ(failed_sends_, 1);
+    ASSERT_EQ(sent_.size(), 1u);
+    EXPECT_EQ(sent_[0].payload["actions"].size(), 2u);
+}
+
+TEST_F(MessageRouterTest, FailedSendStopsAnOversizedBatch) {
+    unreachable_mod_ = "big.mod";
+    auto batch = items(big_id_, 250);
+    auto small = items(small_id_, 1);
+    batch.insert(batch.end(), small.begin(), small.end());
+
+    size_t delivered = batch.size();
+    router_.route_item_receipts(batch.data(), batch.size(), nullptr, &delivered);
+
+    // The first full message fails; nothing after it is sent to anyone
+    EXPECT_EQ(delivered, 0u);
+    EXPECT_EQ(failed_sends_, 1);
+    EXPECT_TRUE(sent_.empty());
+}
+
+TEST_F(MessageRouterTest, EverythingDeliveredWhenAllSendsSucceed) {
+    size_t delivered = 0;
+    router_.route_item_receipts(items(big_id_, 5).data(), 5, nullptr, &delivered);
+    EXPECT_EQ(delivered, 5u);
+}
@@ -0,0 +1,172 @@
+#include "mock_session.h"
+
+#include <gtest/gtest.h>
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <vector>
+
+using ap::mock::MockScenario;
+using ap::mock::MockSession;
+using nlohmann::json;
+
+namespace {
+
+json connect_packet(const std::string& name, const std::string& game = "Mock Game") {
+    return {{"cmd", "Connect"}, {"name", name}, {"game", game}, {"password", ""}};
+}
+
+std::vector<std::string> commands(const json& packets) {
+    std::vector<std::string> cmds;
+    for (const auto& packet : packets) {
+        cmds.push_back(packet.value("cmd", ""));
+    }
+    return cmds;
+}
+
+} // namespace
+
+class MockSessionTest : public ::testing::Test {
+protected:
+    MockSessionTest()
+        : scenario_(make_scenario()), session_(scenario_) {}
+
+    static MockScenario make_scenario() {
+        return MockScenario::from_json({
+            {"slots", {"Player1", "Player2"}},
+            {"item_count", 4},
+            {"location_count", 8},
+            {"starting_items", {1003}},
+            {"placements", {
+                {{"location", 2000}, {"item", 1001}},
+                {{"location", 2001}, {"item", 1002}, {"player", 2}}
+            }}
+        });
+    }
+
+    json connect() {
+        return session_.handle(json::array({connect_packet("Player1")}));
+    }
+
+    MockScenario scenario_;
+    MockSession session_;
+};
+
+TEST(MockScenario, DefaultHasOneSlotAndAChecksummedDataPackage) {
+    MockScenario scenario = MockScenario::make_default();
+
+    ASSERT_EQ(scenario.slots.size(), 1u);
+    EXPECT_EQ(scenario.slots[0].name, "Player1");
+    EXPECT_EQ(scenario.placements.size(), static_cast<size_t>(scenario.location_count));
+
+    const json& game = scenario.data_package()["games"][scenario.game];
+    EXPECT_EQ(game["checksum"], scenario.checksum());
+    EXPECT_EQ(game["item_name_to_id"]["Item 0"], scenario.item_id_base);
+}
+
+TEST_F(MockSessionTest, RoomInfoAdvertisesTheDataPackageChecksum) {
+    json info = session_.room_info();
+    EXPECT_EQ(info["cmd"], "RoomInfo");
+    EXPECT_EQ(info["datapackage_checksums"][scenario_.game], scenario_.checksum());
+    EXPECT_FALSE(info["password"].get<bool>());
+}
+
+TEST_F(MockSessionTest, RejectsMalformedInputAndCommandsBeforeConnect) {
+    EXPECT_EQ(commands(session_.handle(json::object())), std::vector<std::string>({"InvalidPacket"}));
+    EXPECT_EQ(commands(session_.handle(json::array({{{"cmd", "Sync"}}}))),
+              std::vector<std::string>({"InvalidPacket"}));
+    EXPECT_FALSE(session_.connected());
+}
+
+TEST_F(MockSessionTest, RefusesUnknownSlotsAndGames) {
+    json reply = session_.handle(json::array({connect_packet("Nobody")}));
+    ASSERT_EQ(commands(reply), std::vector<std::string>({"ConnectionRefused"}));
+    EXPECT_EQ(reply[0]["errors"], json::array({"InvalidSlot"}));
+
+    reply = session_.handle(json::array({connect_packet("Player1", "Other Game")}));
+    EXPECT_EQ(reply[0]["errors"], json::array({"InvalidGame"}));
+    EXPECT_FALSE(session_.connected());
+}
+
+TEST_F(MockSessionTest, ConnectSendsSlotAndStartingItems) {
+    json reply = connect();
+
+    ASSERT_EQ(commands(reply), std::vector<std::string>({"Connected", "ReceivedItems"}));
+    EXPECT_EQ(reply[0]["slot"], 1);
+    EXPECT_EQ(reply[0]["missing_locations"].size(), 8u);
+    EXPECT_EQ(reply[0]["players"].size(), 2u);
+
+    EXPECT_EQ(reply[1]["index"], 0);
+    ASSERT_EQ(reply[1]["items"].size(), 1u);
+    EXPECT_EQ(reply[1]["items"][0]["item"], 1003);
+    EXPECT_TRUE(session_.connected());
+    EXPECT_EQ(session_.items_received(), 1u);
+}
+
+TEST_F(MockSessionTest, LocationChecksSendOwnItemsOnce) {
+    connect();
+
+    json reply = session_.handle(json::array({{{"cmd", "LocationChecks"}, {"locations", {2000, 2001}}}}));
+    ASSERT_EQ(commands(reply),
+              std::vector<std::string>({"PrintJSON", "PrintJSON", "ReceivedItems", "RoomUpdate"}));
+
+    // Only the item placed for this slot arrives, continuing the index
+    EXPECT_EQ(reply[2]["index"], 1);
+    ASSERT_EQ(reply[2]["items"].size(), 1u);
+    EXPECT_EQ(reply[2]["items"][0]["item"], 1001);
+    EXPECT_EQ(reply[3]["checked_locations"], json::array({2000, 2001}));
+
+    // Checking again changes nothing
+    EXPECT_TRUE(session_.handle(json::array({{{"cmd", "LocationChecks"}, {"locations", {2000}}}})).empty());
+    EXPECT_EQ(session_.items_received(), 2u);
+}
+
+TEST_F(MockSessionTest, GrantedItemsContinueTheIndexAndCycleIds) {
+    connect();
+
+    json packet = session_.grant_items(5);
+    EXPECT_EQ(packet["index"], 1);
+    ASSERT_EQ(packet["items"].size(), 5u);
+    EXPECT_EQ(packet["items"][0]["item"], 1001);
+    EXPECT_EQ(packet["items"][3]["item"], 1000);
+    EXPECT_EQ(packet["items"][0]["location"], -1);
+    EXPECT_EQ(session_.items_received(), 6u);
+
+    // Sync replays the whole history from index 0
+    json sync = session_.handle(json::array({{{"cmd", "Sync"}}}));
+    EXPECT_EQ(sync[0]["index"], 0);
+    EXPECT_EQ(sync[0]["items"].size(), 6u);
+}
+
+TEST_F(MockSessionTest, ReconnectingAsTheSameSlotKeepsProgress) {
+    connect();
+    session_.handle(json::array({{{"cmd", "LocationChecks"}, {"locations", {2000}}}}));
+
+    json reply = connect();
+    EXPECT_EQ(reply[0]["checked_locations"], json::array({2000}));
+    EXPECT_EQ(reply[1]["items"].size(), 2u);
+}
+
+TEST_F(MockSessionTest, DataStorageSetAndGet) {
+    connect();
+
+    json set = {
+        {"cmd", "Set"}, {"key", "counter"}, {"default", 1}, {"want_reply", true},
+        {"operations", {{{"operation", "add"}, {"value", 2}}}}
+    };
+    json reply = session_.handle(json::array({set}));
+    ASSERT_EQ(commands(reply), std::vector<std::string>({"SetReply"}));
+    EXPECT_EQ(reply[0]["value"], 3);
+    EXPECT_TRUE(reply[0]["original_value"].is_null());
+
+    reply = session_.handle(json::array({{{"cmd", "Get"}, {"keys", {"counter", "missing"}}}}));
+    ASSERT_EQ(commands(reply), std::vector<std::string>({"Retrieved"}));
+    EXPECT_EQ(reply[0]["keys"]["counter"], 3);
+    EXPECT_TRUE(reply[0]["keys"]["missing"].is_null());
+}
+
+TEST_F(MockSessionTest, CountsEveryPacketHandled) {
+    session_.handle(json::array({connect_packet("Player1"), {{"cmd", "Bounce"}}, {{"cmd", "Nonsense"}}}));
+    EXPECT_EQ(session_.packets_handled(), 3u);
+}
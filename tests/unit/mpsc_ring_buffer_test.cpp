@@ -0,0 +1,95 @@
+#include "mpsc_ring_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ap::MPSCRingBuffer;
+
+TEST(MPSCRingBuffer, RoundsCapacityUpToPowerOfTwo) {
+    EXPECT_EQ(MPSCRingBuffer<int>(5).capacity(), 8u);
+    EXPECT_EQ(MPSCRingBuffer<int>(1).capacity(), 2u);
+}
+
+TEST(MPSCRingBuffer, ConsumesInOrderAndRejectsWhenFull) {
+    MPSCRingBuffer<int> ring(4);
+    for (int i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(ring.try_emplace_with([i](int& slot) { slot = i; }));
+    }
+    EXPECT_FALSE(ring.try_emplace_with([](int& slot) { slot = 99; }));
+    EXPECT_EQ(ring.size_approx(), 4u);
+
+    std::vector<int> seen;
+    EXPECT_EQ(ring.consume_all([&](int& item) { seen.push_back(item); }), 4u);
+    EXPECT_EQ(seen, std::vector<int>({1, 2, 3, 4}));
+    EXPECT_EQ(ring.size_approx(), 0u);
+
+    // Freed slots are usable again on the next lap
+    EXPECT_TRUE(ring.try_emplace_with([](int& slot) { slot = 5; }));
+    seen.clear();
+    ring.consume_all([&](int& item) { seen.push_back(item); });
+    EXPECT_EQ(seen, std::vector<int>({5}));
+}
+
+TEST(MPSCRingBuffer, SlotsKeepTheirStorageAcrossLaps) {
+    MPSCRingBuffer<std::string> ring(2);
+    ring.try_emplace_with([](std::string& slot) { slot.assign(256, 'x'); });
+
+    const char* buffer = nullptr;
+    ring.consume_all([&](std::string& item) { buffer = item.data(); });
+
+    // Two pushes later the first slot comes round again
+    ring.try_emplace_with([](std::string& slot) { slot = "a"; });
+    ring.consume_all([](std::string&) {});
+    ring.try_emplace_with([&](std::string& slot) {
+        EXPECT_EQ(slot.data(), buffer);
+        slot = "b";
+    });
+}
+
+TEST(MPSCRingBuffer, ProducersKeepTheirOwnOrder) {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 20000;
+
+    struct Entry {
+        int producer = 0;
+        int sequence = 0;
+    };
+    MPSCRingBuffer<Entry> ring(1024);
+
+    std::atomic<bool> go{false};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p] {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < PER_PRODUCER; ++i) {
+                while (!ring.try_emplace_with([&](Entry& e) { e = {p, i}; })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(PRODUCERS, 0);
+    int total = 0;
+    bool in_order = true;
+    go.store(true);
+    while (total < PRODUCERS * PER_PRODUCER) {
+        total += static_cast<int>(ring.consume_all([&](Entry& e) {
+            in_order = in_order && e.sequence == next[e.producer];
+            next[e.producer] = e.sequence + 1;
+        }));
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(next, std::vector<int>(PRODUCERS, PER_PRODUCER));
+    EXPECT_EQ(ring.consume_all([](Entry&) {}), 0u);
+}
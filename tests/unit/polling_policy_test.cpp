@@ -0,0 +1,110 @@
+#include "polling_policy.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace ap;
+using std::chrono::milliseconds;
+
+namespace {
+
+AdaptivePollingPolicy::Settings no_linger() {
+    AdaptivePollingPolicy::Settings settings;
+    settings.min_interval_ms = 4;
+    settings.max_interval_ms = 100;
+    settings.backoff_multiplier = 1.5;
+    settings.activity_linger_ms = 0;
+    return settings;
+}
+
+// Interval the policy settles at after enough idle polls
+milliseconds settle(PollingPolicy& policy, LifecycleState state) {
+    milliseconds interval{};
+    for (int i = 0; i < 50; ++i) {
+        interval = policy.next_interval(false, state);
+    }
+    return interval;
+}
+
+} // namespace
+
+TEST(FixedPollingPolicy, AlwaysReturnsItsInterval) {
+    FixedPollingPolicy policy(16);
+    EXPECT_EQ(policy.next_interval(true, LifecycleState::CONNECTING), milliseconds(16));
+    EXPECT_EQ(policy.next_interval(false, LifecycleState::ACTIVE), milliseconds(16));
+    EXPECT_EQ(policy.current_interval(), milliseconds(16));
+
+    EXPECT_EQ(FixedPollingPolicy(0).current_interval(), milliseconds(1));
+}
+
+TEST(AdaptivePollingPolicy, TrafficPinsTheMinimum) {
+    AdaptivePollingPolicy policy(no_linger());
+    settle(policy, LifecycleState::ACTIVE);
+
+    EXPECT_EQ(policy.next_interval(true, LifecycleState::ACTIVE), milliseconds(4));
+    EXPECT_EQ(policy.current_interval(), milliseconds(4));
+}
+
+TEST(AdaptivePollingPolicy, IdleBacksOffToTheCeiling) {
+    AdaptivePollingPolicy policy(no_linger());
+    policy.next_interval(true, LifecycleState::ACTIVE);
+
+    EXPECT_EQ(policy.next_interval(false, LifecycleState::ACTIVE), milliseconds(6));
+    EXPECT_EQ(policy.next_interval(false, LifecycleState::ACTIVE), milliseconds(9));
+    EXPECT_EQ(policy.next_interval(false, LifecycleState::ACTIVE), milliseconds(13));
+    EXPECT_EQ(settle(policy, LifecycleState::ACTIVE), milliseconds(100));
+}
+
+TEST(AdaptivePollingPolicy, StaysFastForTheLingerAfterTraffic) {
+    AdaptivePollingPolicy::Settings settings = no_linger();
+    settings.activity_linger_ms = 60000;
+    AdaptivePollingPolicy policy(settings);
+
+    policy.next_interval(true, LifecycleState::ACTIVE);
+    EXPECT_EQ(policy.next_interval(false, LifecycleState::ACTIVE), milliseconds(4));
+    EXPECT_EQ(policy.next_interval(false, LifecycleState::ACTIVE), milliseconds(4));
+}
+
+TEST(AdaptivePollingPolicy, HandshakeStatesPinTheMinimum) {
+    AdaptivePollingPolicy policy(no_linger());
+    EXPECT_EQ(settle(policy, LifecycleState::CONNECTING), milliseconds(4));
+    EXPECT_EQ(settle(policy, LifecycleState::SYNCING), milliseconds(4));
+}
+
+TEST(AdaptivePollingPolicy, ResyncingBacksOffWhileWaitingToReconnect) {
+    AdaptivePollingPolicy policy(no_linger());
+    EXPECT_EQ(settle(policy, LifecycleState::RESYNCING), milliseconds(100));
+
+    // A reconnect attempt's traffic still polls fast
+    EXPECT_EQ(policy.next_interval(true, LifecycleState::RESYNCING), milliseconds(4));
+}
+
+TEST(AdaptivePollingPolicy, SettingsAreNormalized) {
+    AdaptivePollingPolicy::Settings settings = no_linger();
+    settings.min_interval_ms = 50;
+    settings.max_interval_ms = 20;
+    settings.backoff_multiplier = 0.5;
+    AdaptivePollingPolicy policy(settings);
+
+    EXPECT_EQ(policy.next_interval(true, LifecycleState::ACTIVE), milliseconds(20));
+    EXPECT_EQ(settle(policy, LifecycleState::ACTIVE), milliseconds(20));
+}
+
+TEST(MakePollingPolicy, AdaptiveIdleCeilingIsSeparateFromTheFixedInterval) {
+    ThreadingConfig config;
+    config.polling_interval_ms = 16;
+    config.polling_idle_interval_ms = 250;
+
+    auto adaptive = make_polling_policy(config);
+    EXPECT_EQ(adaptive->next_interval(true, LifecycleState::ACTIVE),
+              milliseconds(config.polling_min_interval_ms));
+
+    // Once the traffic linger (250ms) has passed, idle polls back off beyond the fixed interval
+    std::this_thread::sleep_for(milliseconds(300));
+    EXPECT_EQ(settle(*adaptive, LifecycleState::ACTIVE), milliseconds(250));
+
+    config.adaptive_polling = false;
+    EXPECT_EQ(make_polling_policy(config)->next_interval(false, LifecycleState::ACTIVE), milliseconds(16));
+}
@@ -0,0 +1,126 @@
+#include "recycling_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <variant>
+#include <vector>
+
+using ap::RecyclingQueue;
+using ap::RecyclingSlot;
+
+namespace {
+
+struct Text {
+    std::string value;
+};
+
+struct Numbers {
+    std::vector<int> values;
+};
+
+using Event = std::variant<Text, Numbers>;
+
+std::string describe(const Event& event) {
+    if (auto* text = std::get_if<Text>(&event)) {
+        return "text:" + text->value;
+    }
+    return "numbers:" + std::to_string(std::get<Numbers>(event).values.size());
+}
+
+} // namespace
+
+TEST(RecyclingSlot, SwitchingAlternativesKeepsTheirBuffers) {
+    RecyclingSlot<Event> slot;
+    std::string& text = slot.reuse_as<Text>().value;
+    text.assign(256, 'x');
+    const char* buffer = text.data();
+
+    slot.reuse_as<Numbers>().values.assign(64, 1);
+
+    // Back to Text: the parked string comes back with its storage
+    Text& reused = slot.reuse_as<Text>();
+    EXPECT_EQ(reused.value.data(), buffer);
+    EXPECT_GE(reused.value.capacity(), 256u);
+    EXPECT_TRUE(std::holds_alternative<Text>(slot.get()));
+}
+
+TEST(RecyclingSlot, ReusingTheSameAlternativeReturnsTheStaleValue) {
+    RecyclingSlot<Event> slot;
+    slot.reuse_as<Text>().value = "old";
+
+    // Callers must overwrite every field; the old contents are still there
+    EXPECT_EQ(slot.reuse_as<Text>().value, "old");
+}
+
+TEST(RecyclingQueue, DeliversEventsInOrder) {
+    RecyclingQueue<Event> queue(4);
+    queue.emplace<Text>([](Text& e) { e.value = "a"; });
+    queue.emplace<Numbers>([](Numbers& e) { e.values = {1, 2}; });
+    queue.push(Text{"b"});
+
+    EXPECT_EQ(queue.size(), 3u);
+
+    std::vector<std::string> seen;
+    size_t visited = queue.consume_all([&](const Event& e) { seen.push_back(describe(e)); });
+
+    EXPECT_EQ(visited, 3u);
+    EXPECT_EQ(seen, std::vector<std::string>({"text:a", "numbers:2", "text:b"}));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(RecyclingQueue, RecyclesPayloadStorageAcrossPasses) {
+    RecyclingQueue<Event> queue(1);
+    queue.emplace<Text>([](Text& e) { e.value.assign(256, 'x'); });
+
+    const char* buffer = nullptr;
+    queue.consume_all([&](const Event& e) { buffer = std::get<Text>(e).value.data(); });
+
+    // Same slot, different alternative, then Text again
+    queue.emplace<Numbers>([](Numbers& e) { e.values = {1}; });
+    queue.clear();
+    queue.emplace<Text>([&](Text& e) {
+        EXPECT_EQ(e.value.data(), buffer);
+        e.value = "short";
+    });
+
+    EXPECT_EQ(queue.pop_all().size(), 1u);
+}
+
+TEST(RecyclingQueue, OverflowsWithoutLosingEvents) {
+    RecyclingQueue<Event> queue(2);
+    for (int i = 0; i < 10; ++i) {
+        queue.emplace<Numbers>([i](Numbers& e) { e.values.assign(i, i); });
+    }
+
+    std::vector<std::string> seen;
+    queue.consume_all([&](const Event& e) { seen.push_back(describe(e)); });
+
+    ASSERT_EQ(seen.size(), 10u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(seen[i], "numbers:" + std::to_string(i));
+    }
+}
+
+TEST(RecyclingQueue, ConsumeWhileHonoursBudgetAndPartialEvents) {
+    RecyclingQueue<Event> queue(8);
+    for (const char* value : {"a", "b", "c"}) {
+        queue.emplace<Text>([value](Text& e) { e.value = value; });
+    }
+
+    // Void handler: stops when keep_going says so
+    std::vector<std::string> seen;
+    size_t budget = 1;
+    EXPECT_EQ(queue.consume_while([&](const Event& e) { seen.push_back(describe(e)); },
+                                  [&] { return budget-- > 0; }), 1u);
+
+    // Bool handler: false leaves the event queued
+    EXPECT_EQ(queue.consume_while([&](const Event& e) {
+        seen.push_back(describe(e));
+        return std::get<Text>(e).value != "b";
+    }, [] { return true; }), 0u);
+
+    EXPECT_EQ(queue.size(), 2u);
+    queue.consume_all([&](const Event& e) { seen.push_back(describe(e)); });
+    EXPECT_EQ(seen, std::vector<std::string>({"text:a", "text:b", "text:b", "text:c"}));
+}
@@ -0,0 +1,210 @@
+#include "spsc_ring_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using ap::OverflowPolicy;
+using ap::SPSCRingBuffer;
+
+namespace {
+
+std::vector<int> drain(SPSCRingBuffer<int>& ring) {
+    std::vector<int> items;
+    ring.consume_all([&](int& item) { items.push_back(item); });
+    return items;
+}
+
+std::vector<int> sequence(int first, int last) {
+    std::vector<int> items;
+    for (int i = first; i <= last; ++i) {
+        items.push_back(i);
+    }
+    return items;
+}
+
+} // namespace
+
+TEST(SPSCRingBuffer, RoundsCapacityUpToPowerOfTwo) {
+    SPSCRingBuffer<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+}
+
+TEST(SPSCRingBuffer, PopsInPushOrder) {
+    SPSCRingBuffer<int> ring(4);
+    for (int i = 1; i <= 3; ++i) {
+        ASSERT_TRUE(ring.push(i));
+    }
+
+    EXPECT_EQ(ring.size(), 3u);
+    EXPECT_EQ(ring.try_pop(), 1);
+    EXPECT_EQ(ring.pop_all(), std::vector<int>({2, 3}));
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.try_pop(), std::nullopt);
+}
+
+TEST(SPSCRingBuffer, DropNewestRejectsPushesWhenFull) {
+    SPSCRingBuffer<int> ring(2, OverflowPolicy::DropNewest);
+    EXPECT_TRUE(ring.push(1));
+    EXPECT_TRUE(ring.push(2));
+    EXPECT_FALSE(ring.push(3));
+
+    EXPECT_EQ(ring.dropped_count(), 1u);
+    EXPECT_EQ(drain(ring), std::vector<int>({1, 2}));
+}
+
+TEST(SPSCRingBuffer, SpillKeepsOrderPastCapacity) {
+    SPSCRingBuffer<int> ring(4, OverflowPolicy::Spill);
+    for (int i = 1; i <= 10; ++i) {
+        ASSERT_TRUE(ring.push(i));
+    }
+
+    EXPECT_EQ(ring.size(), 10u);
+    EXPECT_EQ(ring.dropped_count(), 0u);
+    EXPECT_EQ(drain(ring), sequence(1, 10));
+}
+
+TEST(SPSCRingBuffer, SpillKeepsOrderWhileTheRingFreesUp) {
+    SPSCRingBuffer<int> ring(4, OverflowPolicy::Spill);
+    for (int i = 1; i <= 6; ++i) {
+        ring.push(i);
+    }
+
+    // Freeing ring slots must not let new pushes overtake the overflow list
+    EXPECT_EQ(ring.try_pop(), 1);
+    EXPECT_EQ(ring.try_pop(), 2);
+    ring.push(7);
+    ring.push(8);
+
+    EXPECT_EQ(drain(ring), sequence(3, 8));
+
+    // Once drained the ring is used again
+    ring.push(9);
+    EXPECT_EQ(drain(ring), std::vector<int>({9}));
+}
+
+TEST(SPSCRingBuffer, EmplaceWithReusesSlots) {
+    SPSCRingBuffer<std::string> ring(2);
+    ring.emplace_with([](std::string& slot) { slot.assign(64, 'a'); });
+    ring.emplace_with([](std::string& slot) { slot.assign(64, 'z'); });
+    ring.consume_all([](std::string&) {});
+
+    // The slot comes back with its old contents; fill overwrites it
+    std::string seen;
+    ring.emplace_with([&](std::string& slot) {
+        seen = slot;
+        slot = "b";
+    });
+    ring.emplace_with([](std::string& slot) { slot = "c"; });
+
+    EXPECT_EQ(seen, std::string(64, 'a'));
+    EXPECT_EQ(ring.pop_all(), std::vector<std::string>({"b", "c"}));
+}
+
+TEST(SPSCRingBuffer, ConsumeWhileStopsAndResumesInOrder) {
+    SPSCRingBuffer<int> ring(8);
+    for (int i = 1; i <= 6; ++i) {
+        ring.push(i);
+    }
+
+    std::vector<int> seen;
+    size_t budget = 4;
+    size_t released = ring.consume_while([&](int& item) { seen.push_back(item); },
+                                         [&] { return budget-- > 0; });
+
+    EXPECT_EQ(released, 4u);
+    EXPECT_EQ(seen, sequence(1, 4));
+    EXPECT_EQ(ring.size(), 2u);
+    EXPECT_EQ(drain(ring), std::vector<int>({5, 6}));
+}
+
+TEST(SPSCRingBuffer, ConsumeWhileKeepsAPartlyHandledElementAtTheFront) {
+    SPSCRingBuffer<int> ring(8);
+    for (int i = 1; i <= 3; ++i) {
+        ring.push(i);
+    }
+
+    // Returning false leaves the element queued, e.g. half of a batch routed
+    std::vector<int> seen;
+    size_t released = ring.consume_while([&](int& item) {
+        seen.push_back(item);
+        if (item == 2) {
+            item = 20;
+            return false;
+        }
+        return true;
+    }, [] { return true; });
+
+    EXPECT_EQ(released, 1u);
+    EXPECT_EQ(seen, std::vector<int>({1, 2}));
+    EXPECT_EQ(drain(ring), std::vector<int>({20, 3}));
+}
+
+TEST(SPSCRingBuffer, ConsumeWhileCarriesTheOverflowListAcrossCalls) {
+    SPSCRingBuffer<int> ring(2, OverflowPolicy::Spill);
+    for (int i = 1; i <= 6; ++i) {
+        ring.push(i);
+    }
+
+    // Drains the ring, takes the overflow list, then stops part way into it
+    std::vector<int> seen;
+    size_t budget = 4;
+    ring.consume_while([&](int& item) { seen.push_back(item); }, [&] { return budget-- > 0; });
+    EXPECT_EQ(seen, sequence(1, 4));
+    EXPECT_EQ(ring.size(), 2u);
+
+    // New pushes land behind what was carried
+    ring.push(7);
+
+    // A partly handled carried element stays first
+    seen.clear();
+    ring.consume_while([&](int& item) {
+        seen.push_back(item);
+        return item != 5;
+    }, [] { return true; });
+    EXPECT_EQ(seen, std::vector<int>({5}));
+
+    EXPECT_EQ(drain(ring), std::vector<int>({5, 6, 7}));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SPSCRingBuffer, ClearDropsRingAndOverflow) {
+    SPSCRingBuffer<int> ring(2, OverflowPolicy::Spill);
+    for (int i = 1; i <= 5; ++i) {
+        ring.push(i);
+    }
+
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+
+    ring.push(6);
+    EXPECT_EQ(drain(ring), std::vector<int>({6}));
+}
+
+TEST(SPSCRingBuffer, ProducerThreadSpillsWithoutLosingOrder) {
+    constexpr int COUNT = 200000;
+    SPSCRingBuffer<int> ring(64, OverflowPolicy::Spill);
+
+    std::thread producer([&] {
+        for (int i = 0; i < COUNT; ++i) {
+            ring.push(i);
+        }
+    });
+
+    // Small budgets so the consumer often stops inside the overflow list
+    std::vector<int> seen;
+    seen.reserve(COUNT);
+    while (static_cast<int>(seen.size()) < COUNT) {
+        size_t budget = 7;
+        ring.consume_while([&](int& item) { seen.push_back(item); }, [&] { return budget-- > 0; });
+    }
+    producer.join();
+
+    ASSERT_EQ(seen.size(), static_cast<size_t>(COUNT));
+    for (int i = 0; i < COUNT; ++i) {
+        ASSERT_EQ(seen[i], i);
+    }
+    EXPECT_TRUE(ring.empty());
+}
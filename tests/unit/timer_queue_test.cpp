@@ -0,0 +1,154 @@
+#include "timer_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+using ap::TimerQueue;
+using namespace std::chrono_literals;
+
+namespace {
+
+// A fixed origin keeps every test independent of the wall clock
+const TimerQueue::Clock::time_point T0 = TimerQueue::Clock::time_point() + 1h;
+
+} // namespace
+
+TEST(TimerQueue, IdsAreNeverZero) {
+    TimerQueue timers;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_NE(timers.schedule(T0, [] {}), 0u);
+    }
+    EXPECT_EQ(timers.size(), 4u);
+}
+
+TEST(TimerQueue, FiresOnlyTimersThatAreDue) {
+    TimerQueue timers;
+    int fired = 0;
+    timers.schedule(T0 + 10ms, [&] { ++fired; });
+    timers.schedule(T0 + 20ms, [&] { ++fired; });
+
+    EXPECT_EQ(timers.run_due(T0), 0u);
+    EXPECT_EQ(timers.run_due(T0 + 10ms), 1u);
+    EXPECT_EQ(fired, 1);
+    EXPECT_EQ(timers.size(), 1u);
+
+    EXPECT_EQ(timers.run_due(T0 + 1s), 1u);
+    EXPECT_EQ(fired, 2);
+    EXPECT_EQ(timers.size(), 0u);
+}
+
+TEST(TimerQueue, FiresEarliestFirstAndTiesInSchedulingOrder) {
+    TimerQueue timers;
+    std::vector<int> order;
+    timers.schedule(T0 + 30ms, [&] { order.push_back(3); });
+    timers.schedule(T0 + 10ms, [&] { order.push_back(1); });
+    timers.schedule(T0 + 20ms, [&] { order.push_back(2); });
+    timers.schedule(T0 + 20ms, [&] { order.push_back(22); });
+
+    EXPECT_EQ(timers.run_due(T0 + 1s), 4u);
+    EXPECT_EQ(order, std::vector<int>({1, 2, 22, 3}));
+}
+
+TEST(TimerQueue, CancelledTimersDoNotFire) {
+    TimerQueue timers;
+    bool fired = false;
+    auto id = timers.schedule(T0, [&] { fired = true; });
+
+    EXPECT_TRUE(timers.cancel(id));
+    EXPECT_FALSE(timers.cancel(id));
+    EXPECT_EQ(timers.size(), 0u);
+    EXPECT_EQ(timers.run_due(T0 + 1s), 0u);
+    EXPECT_FALSE(fired);
+}
+
+TEST(TimerQueue, CancelAfterFiringReturnsFalse) {
+    TimerQueue timers;
+    auto id = timers.schedule(T0, [] {});
+    timers.run_due(T0);
+
+    EXPECT_FALSE(timers.cancel(id));
+}
+
+TEST(TimerQueue, NextDeadlineSkipsCancelledTimers) {
+    TimerQueue timers;
+    EXPECT_FALSE(timers.next_deadline().has_value());
+
+    auto first = timers.schedule(T0 + 10ms, [] {});
+    timers.schedule(T0 + 20ms, [] {});
+    EXPECT_EQ(timers.next_deadline(), T0 + 10ms);
+
+    timers.cancel(first);
+    EXPECT_EQ(timers.next_deadline(), T0 + 20ms);
+}
+
+TEST(TimerQueue, ClearDisarmsEverything) {
+    TimerQueue timers;
+    bool fired = false;
+    timers.schedule(T0, [&] { fired = true; });
+    timers.schedule(T0 + 10ms, [&] { fired = true; });
+    timers.clear();
+
+    EXPECT_EQ(timers.size(), 0u);
+    EXPECT_FALSE(timers.next_deadline().has_value());
+    EXPECT_EQ(timers.run_due(T0 + 1s), 0u);
+    EXPECT_FALSE(fired);
+}
+
+TEST(TimerQueue, ScheduleAfterIsRelativeToNow) {
+    TimerQueue timers;
+    auto before = TimerQueue::Clock::now();
+    timers.schedule_after(1h, [] {});
+
+    ASSERT_TRUE(timers.next_deadline().has_value());
+    EXPECT_GE(*timers.next_deadline(), before + 1h);
+    EXPECT_EQ(timers.run_due(), 0u);
+}
+
+// =============================================================================
+// Callbacks changing the queue
+// =============================================================================
+
+TEST(TimerQueue, CallbackCanRescheduleItself) {
+    TimerQueue timers;
+    int fired = 0;
+    std::function<void()> tick = [&] {
+        ++fired;
+        timers.schedule(T0 + 10ms * (fired + 1), tick);
+    };
+    timers.schedule(T0 + 10ms, tick);
+
+    // A timer scheduled during run_due() fires in the same call if it is due
+    EXPECT_EQ(timers.run_due(T0 + 30ms), 3u);
+    EXPECT_EQ(fired, 3);
+    EXPECT_EQ(timers.size(), 1u);
+}
+
+TEST(TimerQueue, CallbackCanCancelALaterTimer) {
+    TimerQueue timers;
+    bool second_fired = false;
+    TimerQueue::TimerId second = 0;
+    timers.schedule(T0, [&] { EXPECT_TRUE(timers.cancel(second)); });
+    second = timers.schedule(T0 + 10ms, [&] { second_fired = true; });
+
+    EXPECT_EQ(timers.run_due(T0 + 1s), 1u);
+    EXPECT_FALSE(second_fired);
+}
+
+TEST(TimerQueue, CallbackCanClearTheQueue) {
+    TimerQueue timers;
+    int fired = 0;
+    timers.schedule(T0, [&] {
+        ++fired;
+        timers.clear();
+        timers.schedule(T0 + 1s, [&] { ++fired; });
+    });
+    timers.schedule(T0 + 10ms, [&] { ++fired; });
+
+    EXPECT_EQ(timers.run_due(T0 + 100ms), 1u);
+    EXPECT_EQ(fired, 1);
+    EXPECT_EQ(timers.size(), 1u);
+    EXPECT_EQ(timers.next_deadline(), T0 + 1s);
+}
@@ -0,0 +1,261 @@
+// Decoder for APLogger binary logs (see APFrameworkCore/include/binary_log.h).
+//
+// Prints every record in the same layout as the text log:
+//   [YYYY-MM-DD HH:MM:SS.mmm][thread][LEVEL] [component] message
+//
+// Usage: ap_log_decoder <file> [--min-level LEVEL] [--component NAME]
+//                              [--utc]
+
+#include "binary_log.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace ap::binary_log;
+
+namespace {
+
+constexpr const char* LEVEL_NAMES[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+constexpr int LEVEL_COUNT = 6;
+
+struct Options {
+    std::string path;
+    int min_level = 0;
+    std::string component;
+    bool utc = false;
+};
+
+struct Format {
+    uint16_t component = NO_COMPONENT_ID;
+    std::string text;
+};
+
+/**
+ * @brief Definitions of the current session; reset at every file header.
+ */
+struct Tables {
+    std::map<uint16_t, std::string> components;
+    std::map<uint8_t, std::string> threads;
+    std::map<uint32_t, Format> formats;
+
+    void reset() {
+        components.clear();
+        threads.clear();
+        formats.clear();
+        formats[PLAIN_FORMAT_ID] = {NO_COMPONENT_ID, "{}"};
+    }
+};
+
+int parse_level(const std::string& name) {
+    for (int i = 0; i < LEVEL_COUNT; ++i) {
+        std::string upper = LEVEL_NAMES[i];
+        std::string lower;
+        for (char c : upper) {
+            lower.push_back(static_cast<char>(c - 'A' + 'a'));
+        }
+        if (name == upper || name == lower) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+std::string format_time(int64_t micros, bool utc) {
+    int64_t seconds = micros / 1000000;
+    int millis = static_cast<int>((micros / 1000) % 1000);
+    if (millis < 0) {
+        millis += 1000;
+        --seconds;
+    }
+
+    std::time_t time = static_cast<std::time_t>(seconds);
+    std::tm tm_buf{};
+#ifdef _WIN32
+    utc ? gmtime_s(&tm_buf, &time) : localtime_s(&tm_buf, &time);
+#else
+    utc ? gmtime_r(&time, &tm_buf) : localtime_r(&time, &tm_buf);
+#endif
+
+    char buffer[40];
+    size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm_buf);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%03d", millis);
+    return buffer;
+}
+
+bool parse_args(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--min-level" && has_value) {
+            options.min_level = parse_level(argv[++i]);
+            if (options.min_level < 0) {
+                return false;
+            }
+        } else if (arg == "--component" && has_value) {
+            options.component = argv[++i];
+        } else if (arg == "--utc") {
+            options.utc = true;
+        } else if (options.path.empty() && arg.rfind("--", 0) != 0) {
+            options.path = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options.path.empty();
+}
+
+/**
+ * @brief Decode the whole file to stdout.
+ * @return Number of records printed, or -1 if the file is not a binary log.
+ */
+long decode(const std::vector<char>& data, const Options& options) {
+    Reader reader(data.data(), data.size());
+    Tables tables;
+    tables.reset();
+    long printed = 0;
+
+    auto read_header = [&]() {
+        char magic[sizeof(FILE_MAGIC)];
+        uint16_t version = 0;
+        for (char& c : magic) {
+            if (!reader.read(c)) {
+                return false;
+            }
+        }
+        if (std::memcmp(magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || !reader.read(version)) {
+            return false;
+        }
+        if (version != FILE_VERSION) {
+            std::fprintf(stderr, "Unsupported binary log version %u\n", version);
+            return false;
+        }
+        tables.reset();
+        return true;
+    };
+
+    if (!read_header()) {
+        return -1;
+    }
+
+    while (!reader.done()) {
+        uint8_t tag = 0;
+        reader.read(tag);
+
+        bool ok = true;
+        switch (tag) {
+            case static_cast<uint8_t>(FILE_MAGIC[0]): {
+                // Next session appended to the same file; the tag byte was 'A'
+                char rest[sizeof(FILE_MAGIC) - 1];
+                uint16_t version = 0;
+                for (char& c : rest) {
+                    ok = ok && reader.read(c);
+                }
+                ok = ok && std::memcmp(rest, FILE_MAGIC + 1, sizeof(rest)) == 0 &&
+                     reader.read(version) && version == FILE_VERSION;
+                tables.reset();
+                break;
+            }
+            case TAG_COMPONENT: {
+                uint16_t id = 0;
+                std::string_view name;
+                ok = reader.read(id) && reader.read_string(name);
+                if (ok) tables.components[id] = std::string(name);
+                break;
+            }
+            case TAG_THREAD: {
+                uint8_t id = 0;
+                std::string_view name;
+                ok = reader.read(id) && reader.read_string(name);
+                if (ok) tables.threads[id] = std::string(name);
+                break;
+            }
+            case TAG_FORMAT: {
+                uint32_t id = 0;
+                uint16_t component = 0;
+                std::string_view text;
+                ok = reader.read(id) && reader.read(component) && reader.read_string(text);
+                if (ok) tables.formats[id] = {component, std::string(text)};
+                break;
+            }
+            case TAG_RECORD: {
+                int64_t time = 0;
+                uint8_t level = 0;
+                uint8_t thread = 0;
+                uint16_t component = 0;
+                uint32_t format_id = 0;
+                std::string_view args;
+                ok = reader.read(time) && reader.read(level) && reader.read(thread) &&
+                     reader.read(component) && reader.read(format_id) && reader.read_string(args);
+                if (!ok || level < options.min_level) {
+                    break;
+                }
+
+                const std::string& component_name = tables.components[component];
+                if (!options.component.empty() && component_name != options.component) {
+                    break;
+                }
+
+                auto format = tables.formats.find(format_id);
+                std::string message = format != tables.formats.end()
+                    ? format_message(format->second.text, args.data(), args.size())
+                    : "<unknown format " + std::to_string(format_id) + "> " +
+                      format_message("", args.data(), args.size());
+
+                auto thread_name = tables.threads.find(thread);
+                std::printf("[%s][%s][%s] %s%s%s%s\n",
+                            format_time(time, options.utc).c_str(),
+                            thread_name != tables.threads.end() ? thread_name->second.c_str() : "?",
+                            level < LEVEL_COUNT ? LEVEL_NAMES[level] : "UNKNOWN",
+                            component_name.empty() ? "" : "[",
+                            component_name.c_str(),
+                            component_name.empty() ? "" : "] ",
+                            message.c_str());
+                ++printed;
+                break;
+            }
+            default:
+                ok = false;
+                break;
+        }
+
+        if (!ok) {
+            // A crash can leave a partial record at the end; stop there
+            std::fprintf(stderr, "Stopped at a truncated or corrupt entry (tag 0x%02x)\n", tag);
+            break;
+        }
+    }
+
+    return printed;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        std::fprintf(stderr,
+            "Usage: %s <file> [--min-level LEVEL] [--component NAME] [--utc]\n", argv[0]);
+        return 2;
+    }
+
+    std::ifstream file(options.path, std::ios::binary);
+    if (!file) {
+        std::fprintf(stderr, "Cannot open %s\n", options.path.c_str());
+        return 1;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    long printed = decode(data, options);
+    if (printed < 0) {
+        std::fprintf(stderr, "%s is not an APLogger binary log\n", options.path.c_str());
+        return 1;
+    }
+    return 0;
+}
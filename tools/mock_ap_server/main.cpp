@@ -0,0 +1,313 @@
+// Mock Archipelago server for local integration tests and benchmarks.
+//
+// Speaks enough of the AP websocket protocol (RoomInfo, Connect/Connected,
+// GetDataPackage, Sync, ReceivedItems, LocationChecks, LocationScouts,
+// PrintJSON, Bounce, Get/Set) for APClient, APPollingThread and
+// APMessageRouter to run end to end without a real server. A scenario file
+// describes the room and a script of timed actions (item floods, prints,
+// disconnects) that runs for every client once it has connected to a slot.
+//
+// Usage: mock_ap_server [--port N] [--scenario file.json]
+//                       [--flood COUNT] [--batch SIZE] [--interval MS]
+//                       [--quiet]
+//
+// --flood appends an "items" step to the scenario script. Each flood reports
+// how long it took to send and the resulting item rate.
+
+#include "mock_scenario.h"
+#include "mock_session.h"
+
+#include <websocketpp/config/asio_no_tls.hpp>
+#include <websocketpp/server.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace ap::mock;
+
+namespace {
+
+using Server = websocketpp::server<websocketpp::config::asio>;
+using Clock = std::chrono::steady_clock;
+
+constexpr uint16_t DEFAULT_PORT = 38281;
+constexpr long SHUTDOWN_GRACE_MS = 500;
+
+struct Options {
+    uint16_t port = DEFAULT_PORT;
+    std::string scenario_path;
+    int flood_count = 0;
+    int flood_batch = 100;
+    int flood_interval_ms = 0;
+    bool quiet = false;
+};
+
+struct Client {
+    explicit Client(const MockScenario& scenario) : session(scenario) {}
+
+    MockSession session;
+    bool script_started = false;
+};
+
+class MockServer {
+public:
+    MockServer(MockScenario scenario, bool quiet)
+        : scenario_(std::move(scenario)), quiet_(quiet) {
+        server_.clear_access_channels(websocketpp::log::alevel::all);
+        server_.set_error_channels(websocketpp::log::elevel::warn | websocketpp::log::elevel::rerror |
+                                   websocketpp::log::elevel::fatal);
+        server_.init_asio();
+        server_.set_reuse_addr(true);
+
+        server_.set_open_handler([this](websocketpp::connection_hdl hdl) { on_open(hdl); });
+        server_.set_close_handler([this](websocketpp::connection_hdl hdl) { on_close(hdl); });
+        server_.set_fail_handler([this](websocketpp::connection_hdl hdl) { on_close(hdl); });
+        server_.set_message_handler([this](websocketpp::connection_hdl hdl, Server::message_ptr msg) {
+            on_message(hdl, msg);
+        });
+    }
+
+    void run(uint16_t port) {
+        server_.listen(port);
+        server_.start_accept();
+        std::printf("[mock] Listening on ws://localhost:%u (seed %s, %zu slots, %zu script steps)\n",
+                    port, scenario_.seed_name.c_str(), scenario_.slots.size(), scenario_.script.size());
+        std::fflush(stdout);
+        server_.run();
+    }
+
+    void stop() {
+        server_.stop_listening();
+        for (auto& [hdl, client] : clients_) {
+            websocketpp::lib::error_code ec;
+            server_.close(hdl, websocketpp::close::status::going_away, "server shutdown", ec);
+        }
+
+        // Give the close handshakes a moment, then drop any pending script timers
+        server_.set_timer(SHUTDOWN_GRACE_MS, [this](const websocketpp::lib::error_code&) {
+            server_.stop();
+        });
+    }
+
+    asio::io_service& io_service() {
+        return server_.get_io_service();
+    }
+
+private:
+    using ClientMap = std::map<websocketpp::connection_hdl, std::unique_ptr<Client>,
+                               std::owner_less<websocketpp::connection_hdl>>;
+
+    // =========================================================================
+    // Connection Handlers
+    // =========================================================================
+
+    void on_open(websocketpp::connection_hdl hdl) {
+        auto& client = clients_[hdl];
+        client = std::make_unique<Client>(scenario_);
+        log("Client connected (" + std::to_string(clients_.size()) + " open)");
+        send(hdl, nlohmann::json::array({client->session.room_info()}));
+    }
+
+    void on_close(websocketpp::connection_hdl hdl) {
+        auto it = clients_.find(hdl);
+        if (it == clients_.end()) {
+            return;
+        }
+        log("Client disconnected after " + std::to_string(it->second->session.packets_handled()) +
+            " packets, " + std::to_string(it->second->session.items_received()) + " items");
+        clients_.erase(it);
+    }
+
+    void on_message(websocketpp::connection_hdl hdl, Server::message_ptr msg) {
+        Client* client = find(hdl);
+        if (!client) {
+            return;
+        }
+
+        nlohmann::json packets = nlohmann::json::parse(msg->get_payload(), nullptr, false);
+        nlohmann::json replies = client->session.handle(packets);
+        if (!replies.empty()) {
+            send(hdl, replies);
+        }
+
+        if (client->session.connected() && !client->script_started) {
+            client->script_started = true;
+            log("Slot " + std::to_string(client->session.slot()) + " connected");
+            run_step(hdl, 0);
+        }
+    }
+
+    // =========================================================================
+    // Script
+    // =========================================================================
+
+    void run_step(websocketpp::connection_hdl hdl, size_t index) {
+        if (index >= scenario_.script.size()) {
+            return;
+        }
+
+        server_.set_timer(scenario_.script[index].delay_ms,
+            [this, hdl, index](const websocketpp::lib::error_code& ec) {
+                if (ec || !find(hdl)) {
+                    return;
+                }
+
+                const MockScriptStep& step = scenario_.script[index];
+                if (step.action == "items") {
+                    send_items(hdl, index, step.count, Clock::now());
+                    return;
+                }
+
+                if (step.action == "print") {
+                    send(hdl, nlohmann::json::array({find(hdl)->session.print(step.text)}));
+                } else if (step.action == "disconnect") {
+                    websocketpp::lib::error_code close_ec;
+                    server_.close(hdl, websocketpp::close::status::normal, "scripted disconnect", close_ec);
+                    return;
+                } else {
+                    log("Unknown script action: " + step.action);
+                }
+                run_step(hdl, index + 1);
+            });
+    }
+
+    void send_items(websocketpp::connection_hdl hdl, size_t index, int remaining, Clock::time_point started) {
+        Client* client = find(hdl);
+        if (!client) {
+            return;
+        }
+
+        const MockScriptStep& step = scenario_.script[index];
+        int batch = std::min(remaining, step.batch_size);
+        send(hdl, nlohmann::json::array({client->session.grant_items(batch)}));
+        remaining -= batch;
+
+        if (remaining > 0) {
+            server_.set_timer(step.interval_ms,
+                [this, hdl, index, remaining, started](const websocketpp::lib::error_code& ec) {
+                    if (!ec) {
+                        send_items(hdl, index, remaining, started);
+                    }
+                });
+            return;
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+        double rate = ms > 0.0 ? step.count * 1000.0 / ms : 0.0;
+        std::printf("[mock] Flood: %d items in batches of %d, %.2f ms (%.0f items/s)\n",
+                    step.count, step.batch_size, ms, rate);
+        std::fflush(stdout);
+        run_step(hdl, index + 1);
+    }
+
+    // =========================================================================
+    // Helpers
+    // =========================================================================
+
+    Client* find(websocketpp::connection_hdl hdl) {
+        auto it = clients_.find(hdl);
+        return it != clients_.end() ? it->second.get() : nullptr;
+    }
+
+    void send(websocketpp::connection_hdl hdl, const nlohmann::json& packets) {
+        websocketpp::lib::error_code ec;
+        server_.send(hdl, packets.dump(), websocketpp::frame::opcode::text, ec);
+        if (ec) {
+            log("Send failed: " + ec.message());
+        }
+    }
+
+    void log(const std::string& message) const {
+        if (!quiet_) {
+            std::printf("[mock] %s\n", message.c_str());
+            std::fflush(stdout);
+        }
+    }
+
+    MockScenario scenario_;
+    bool quiet_;
+    Server server_;
+    ClientMap clients_;
+};
+
+bool parse_args(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--port" && has_value) {
+            options.port = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--scenario" && has_value) {
+            options.scenario_path = argv[++i];
+        } else if (arg == "--flood" && has_value) {
+            options.flood_count = std::atoi(argv[++i]);
+        } else if (arg == "--batch" && has_value) {
+            options.flood_batch = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--interval" && has_value) {
+            options.flood_interval_ms = std::atoi(argv[++i]);
+        } else if (arg == "--quiet") {
+            options.quiet = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        std::fprintf(stderr,
+            "Usage: %s [--port N] [--scenario file.json] [--flood COUNT] [--batch SIZE] "
+            "[--interval MS] [--quiet]\n", argv[0]);
+        return 2;
+    }
+
+    MockScenario scenario = MockScenario::make_default();
+    if (!options.scenario_path.empty()) {
+        std::ifstream file(options.scenario_path);
+        nlohmann::json config = nlohmann::json::parse(file, nullptr, false);
+        if (config.is_discarded()) {
+            std::fprintf(stderr, "Failed to parse scenario: %s\n", options.scenario_path.c_str());
+            return 1;
+        }
+        try {
+            scenario = MockScenario::from_json(config);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "Invalid scenario %s: %s\n", options.scenario_path.c_str(), e.what());
+            return 1;
+        }
+    }
+
+    if (options.flood_count > 0) {
+        MockScriptStep flood;
+        flood.action = "items";
+        flood.count = options.flood_count;
+        flood.batch_size = options.flood_batch;
+        flood.interval_ms = options.flood_interval_ms;
+        scenario.script.push_back(flood);
+    }
+
+    try {
+        MockServer server(std::move(scenario), options.quiet);
+
+        asio::signal_set signals(server.io_service(), SIGINT, SIGTERM);
+        signals.async_wait([&server](const std::error_code&, int) { server.stop(); });
+
+        server.run(options.port);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Mock server error: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
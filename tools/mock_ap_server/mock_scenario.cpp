@@ -0,0 +1,154 @@
+#include "mock_scenario.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace ap::mock {
+
+namespace {
+
+// FNV-1a is plenty for a mock; the real server uses SHA-1
+std::string hash_hex(const std::string& data) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return buffer;
+}
+
+} // namespace
+
+MockScenario MockScenario::make_default() {
+    MockScenario scenario;
+    scenario.finalize();
+    return scenario;
+}
+
+MockScenario MockScenario::from_json(const nlohmann::json& config) {
+    MockScenario scenario;
+
+    scenario.seed_name = config.value("seed_name", scenario.seed_name);
+    scenario.game = config.value("game", scenario.game);
+    scenario.password = config.value("password", scenario.password);
+    scenario.item_count = config.value("item_count", scenario.item_count);
+    scenario.location_count = config.value("location_count", scenario.location_count);
+    scenario.item_id_base = config.value("item_id_base", scenario.item_id_base);
+    scenario.location_id_base = config.value("location_id_base", scenario.location_id_base);
+
+    if (config.contains("slots")) {
+        int next_slot = 1;
+        for (const auto& entry : config["slots"]) {
+            MockSlot slot;
+            slot.slot = next_slot++;
+            slot.name = entry.is_string() ? entry.get<std::string>() : entry.at("name").get<std::string>();
+            slot.game = scenario.game;
+            scenario.slots.push_back(std::move(slot));
+        }
+    }
+
+    if (config.contains("placements")) {
+        for (const auto& entry : config["placements"]) {
+            MockPlacement placement;
+            placement.location = entry.at("location").get<int64_t>();
+            placement.item = entry.at("item").get<int64_t>();
+            placement.receiver = entry.value("player", 1);
+            placement.flags = entry.value("flags", 0);
+            scenario.placements.push_back(placement);
+        }
+    }
+
+    if (config.contains("starting_items")) {
+        scenario.starting_items = config["starting_items"].get<std::vector<int64_t>>();
+    }
+
+    if (config.contains("slot_data")) {
+        scenario.slot_data = config["slot_data"];
+    }
+
+    if (config.contains("script")) {
+        for (const auto& entry : config["script"]) {
+            MockScriptStep step;
+            step.action = entry.at("action").get<std::string>();
+            step.delay_ms = entry.value("delay_ms", 0);
+            step.count = entry.value("count", 0);
+            step.batch_size = std::max(1, entry.value("batch_size", 1));
+            step.interval_ms = entry.value("interval_ms", 0);
+            step.text = entry.value("text", "");
+            scenario.script.push_back(std::move(step));
+        }
+    }
+
+    scenario.finalize();
+    return scenario;
+}
+
+void MockScenario::finalize() {
+    if (slots.empty()) {
+        slots.push_back({1, "Player1", game});
+    }
+
+    if (placements.empty() && item_count > 0) {
+        placements.reserve(location_count);
+        for (int i = 0; i < location_count; ++i) {
+            placements.push_back({location_id_base + i, item_id_base + (i % item_count), 1, 0});
+        }
+    }
+
+    nlohmann::json items = nlohmann::json::object();
+    for (int i = 0; i < item_count; ++i) {
+        items[item_name(item_id_base + i)] = item_id_base + i;
+    }
+
+    nlohmann::json locations = nlohmann::json::object();
+    for (int i = 0; i < location_count; ++i) {
+        locations[location_name(location_id_base + i)] = location_id_base + i;
+    }
+
+    nlohmann::json game_data = {
+        {"item_name_to_id", std::move(items)},
+        {"location_name_to_id", std::move(locations)}
+    };
+    checksum_ = hash_hex(game_data.dump());
+    game_data["checksum"] = checksum_;
+
+    data_package_ = {{"games", {{game, std::move(game_data)}}}};
+}
+
+const nlohmann::json& MockScenario::data_package() const {
+    return data_package_;
+}
+
+const std::string& MockScenario::checksum() const {
+    return checksum_;
+}
+
+const MockSlot* MockScenario::find_slot(const std::string& name) const {
+    for (const auto& slot : slots) {
+        if (slot.name == name) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+const MockPlacement* MockScenario::find_placement(int64_t location) const {
+    for (const auto& placement : placements) {
+        if (placement.location == location) {
+            return &placement;
+        }
+    }
+    return nullptr;
+}
+
+std::string MockScenario::item_name(int64_t item) const {
+    return "Item " + std::to_string(item - item_id_base);
+}
+
+std::string MockScenario::location_name(int64_t location) const {
+    return "Location " + std::to_string(location - location_id_base);
+}
+
+} // namespace ap::mock
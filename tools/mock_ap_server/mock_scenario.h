@@ -0,0 +1,108 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ap::mock {
+
+/**
+ * @brief One slot in the mock multiworld.
+ */
+struct MockSlot {
+    int slot = 0;               // 1-based slot number
+    std::string name;
+    std::string game;
+};
+
+/**
+ * @brief Item placed at a location.
+ */
+struct MockPlacement {
+    int64_t location = 0;
+    int64_t item = 0;
+    int receiver = 0;           // Slot that receives the item
+    int flags = 0;
+};
+
+/**
+ * @brief Timed action run for each connected client.
+ *
+ * Actions:
+ * - "items": send `count` items in ReceivedItems packets of `batch_size`,
+ *   `interval_ms` apart.
+ * - "print": send a PrintJSON packet with `text`.
+ * - "disconnect": close the connection.
+ */
+struct MockScriptStep {
+    std::string action;
+    int delay_ms = 0;           // Delay after the previous step
+    int count = 0;
+    int batch_size = 1;
+    int interval_ms = 0;
+    std::string text;
+};
+
+/**
+ * @brief Everything the mock server needs to impersonate a room.
+ *
+ * Every slot plays `game`. Items are numbered item_id_base + i and
+ * locations location_id_base + i; by default location i holds item
+ * (i % item_count) for slot 1.
+ */
+struct MockScenario {
+    std::string seed_name = "mock-seed";
+    std::string game = "Mock Game";
+    std::string password;
+    std::vector<MockSlot> slots;
+
+    int item_count = 100;
+    int location_count = 100;
+    int64_t item_id_base = 1000;
+    int64_t location_id_base = 2000;
+
+    std::vector<MockPlacement> placements;
+    std::vector<int64_t> starting_items;
+    nlohmann::json slot_data = nlohmann::json::object();
+    std::vector<MockScriptStep> script;
+
+    /**
+     * @brief Default scenario: one slot ("Player1") and no script.
+     */
+    static MockScenario make_default();
+
+    /**
+     * @brief Build a scenario from JSON (missing keys keep their defaults).
+     * @throws nlohmann::json::exception on malformed input.
+     */
+    static MockScenario from_json(const nlohmann::json& config);
+
+    /**
+     * @brief Data package for `game` ({"games": {game: {...}}}).
+     */
+    const nlohmann::json& data_package() const;
+
+    const std::string& checksum() const;
+
+    const MockSlot* find_slot(const std::string& name) const;
+    const MockPlacement* find_placement(int64_t location) const;
+
+    std::string item_name(int64_t item) const;
+    std::string location_name(int64_t location) const;
+
+    /**
+     * @brief Fill in generated slots/placements and build the data package.
+     *
+     * Called by make_default() and from_json(); call again after editing
+     * fields by hand.
+     */
+    void finalize();
+
+private:
+    nlohmann::json data_package_;
+    std::string checksum_;
+};
+
+} // namespace ap::mock
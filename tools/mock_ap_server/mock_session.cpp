@@ -0,0 +1,344 @@
+#include "mock_session.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace ap::mock {
+
+namespace {
+
+constexpr int TEAM = 0;
+constexpr int CLIENT_GOAL = 30;
+
+nlohmann::json network_item(int64_t item, int64_t location, int player, int flags) {
+    return {
+        {"item", item},
+        {"location", location},
+        {"player", player},
+        {"flags", flags},
+        {"class", "NetworkItem"}
+    };
+}
+
+} // namespace
+
+MockSession::MockSession(const MockScenario& scenario)
+    : scenario_(scenario) {}
+
+nlohmann::json MockSession::room_info() const {
+    double now = std::chrono::duration<double>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    return {
+        {"cmd", "RoomInfo"},
+        {"version", {{"major", 0}, {"minor", 5}, {"build", 0}, {"class", "Version"}}},
+        {"generator_version", {{"major", 0}, {"minor", 5}, {"build", 0}, {"class", "Version"}}},
+        {"tags", nlohmann::json::array({"MockServer"})},
+        {"password", !scenario_.password.empty()},
+        {"permissions", {{"release", 2}, {"collect", 2}, {"remaining", 2}}},
+        {"hint_cost", 10},
+        {"location_check_points", 1},
+        {"games", nlohmann::json::array({scenario_.game})},
+        {"datapackage_checksums", {{scenario_.game, scenario_.checksum()}}},
+        {"seed_name", scenario_.seed_name},
+        {"time", now}
+    };
+}
+
+nlohmann::json MockSession::handle(const nlohmann::json& packets) {
+    nlohmann::json out = nlohmann::json::array();
+
+    if (!packets.is_array()) {
+        out.push_back(invalid_packet("cmd", "expected a list of packets"));
+        return out;
+    }
+
+    for (const auto& packet : packets) {
+        ++packets_handled_;
+        handle_packet(packet, out);
+    }
+    return out;
+}
+
+void MockSession::handle_packet(const nlohmann::json& packet, nlohmann::json& out) {
+    std::string cmd = packet.is_object() ? packet.value("cmd", "") : "";
+
+    if (cmd == "Connect") {
+        on_connect(packet, out);
+        return;
+    }
+    if (cmd == "GetDataPackage") {
+        out.push_back({{"cmd", "DataPackage"}, {"data", scenario_.data_package()}});
+        return;
+    }
+
+    // Everything below requires a connected slot
+    if (!slot_) {
+        out.push_back(invalid_packet("cmd", cmd + " before Connect"));
+        return;
+    }
+
+    if (cmd == "Sync") {
+        out.push_back(received_items_packet(0));
+    } else if (cmd == "LocationChecks") {
+        on_location_checks(packet, out);
+    } else if (cmd == "LocationScouts") {
+        on_location_scouts(packet, out);
+    } else if (cmd == "StatusUpdate") {
+        client_status_ = packet.value("status", client_status_);
+        if (client_status_ == CLIENT_GOAL) {
+            out.push_back(print(slot_->name + " has completed their goal."));
+        }
+    } else if (cmd == "Say") {
+        on_say(packet, out);
+    } else if (cmd == "Bounce") {
+        nlohmann::json bounced = packet;
+        bounced["cmd"] = "Bounced";
+        out.push_back(std::move(bounced));
+    } else if (cmd == "Get") {
+        on_get(packet, out);
+    } else if (cmd == "Set") {
+        on_set(packet, out);
+    } else {
+        out.push_back(invalid_packet("cmd", "unknown command: " + cmd));
+    }
+}
+
+// =============================================================================
+// Packet Handlers
+// =============================================================================
+
+void MockSession::on_connect(const nlohmann::json& packet, nlohmann::json& out) {
+    nlohmann::json errors = nlohmann::json::array();
+
+    const MockSlot* slot = scenario_.find_slot(packet.value("name", ""));
+    if (!slot) {
+        errors.push_back("InvalidSlot");
+    } else if (packet.value("game", "") != slot->game) {
+        errors.push_back("InvalidGame");
+    }
+    if (!scenario_.password.empty() && packet.value("password", "") != scenario_.password) {
+        errors.push_back("InvalidPassword");
+    }
+
+    if (!errors.empty()) {
+        out.push_back({{"cmd", "ConnectionRefused"}, {"errors", std::move(errors)}});
+        return;
+    }
+
+    // Connecting again as the same slot keeps its items and checked locations
+    if (slot_ != slot) {
+        slot_ = slot;
+        received_.clear();
+        checked_.clear();
+        for (int64_t item : scenario_.starting_items) {
+            received_.push_back({item, -2, 0, 0});
+        }
+    }
+
+    nlohmann::json players = nlohmann::json::array();
+    nlohmann::json slot_info = nlohmann::json::object();
+    for (const auto& entry : scenario_.slots) {
+        players.push_back({
+            {"team", TEAM},
+            {"slot", entry.slot},
+            {"alias", entry.name},
+            {"name", entry.name},
+            {"class", "NetworkPlayer"}
+        });
+        slot_info[std::to_string(entry.slot)] = {
+            {"name", entry.name},
+            {"game", entry.game},
+            {"type", 1},
+            {"group_members", nlohmann::json::array()},
+            {"class", "NetworkSlot"}
+        };
+    }
+
+    nlohmann::json missing = nlohmann::json::array();
+    nlohmann::json checked = nlohmann::json::array();
+    for (int i = 0; i < scenario_.location_count; ++i) {
+        int64_t location = scenario_.location_id_base + i;
+        (checked_.count(location) ? checked : missing).push_back(location);
+    }
+
+    out.push_back({
+        {"cmd", "Connected"},
+        {"team", TEAM},
+        {"slot", slot_->slot},
+        {"players", std::move(players)},
+        {"missing_locations", std::move(missing)},
+        {"checked_locations", std::move(checked)},
+        {"slot_data", scenario_.slot_data},
+        {"slot_info", std::move(slot_info)},
+        {"hint_points", 0}
+    });
+    out.push_back(received_items_packet(0));
+}
+
+void MockSession::on_location_checks(const nlohmann::json& packet, nlohmann::json& out) {
+    nlohmann::json newly_checked = nlohmann::json::array();
+    size_t first_new_item = received_.size();
+
+    for (const auto& value : packet.value("locations", nlohmann::json::array())) {
+        int64_t location = value.get<int64_t>();
+        if (!checked_.insert(location).second) {
+            continue;
+        }
+        newly_checked.push_back(location);
+
+        const MockPlacement* placement = scenario_.find_placement(location);
+        if (!placement) {
+            continue;
+        }
+        if (placement->receiver == slot_->slot) {
+            received_.push_back({placement->item, location, slot_->slot, placement->flags});
+        }
+        out.push_back(item_send_packet(*placement));
+    }
+
+    if (received_.size() > first_new_item) {
+        out.push_back(received_items_packet(first_new_item));
+    }
+    if (!newly_checked.empty()) {
+        out.push_back({{"cmd", "RoomUpdate"}, {"checked_locations", std::move(newly_checked)}});
+    }
+}
+
+void MockSession::on_location_scouts(const nlohmann::json& packet, nlohmann::json& out) {
+    nlohmann::json locations = nlohmann::json::array();
+
+    for (const auto& value : packet.value("locations", nlohmann::json::array())) {
+        if (const MockPlacement* placement = scenario_.find_placement(value.get<int64_t>())) {
+            locations.push_back(network_item(placement->item, placement->location,
+                                             placement->receiver, placement->flags));
+        }
+    }
+
+    out.push_back({{"cmd", "LocationInfo"}, {"locations", std::move(locations)}});
+}
+
+void MockSession::on_say(const nlohmann::json& packet, nlohmann::json& out) {
+    std::string text = packet.value("text", "");
+    out.push_back({
+        {"cmd", "PrintJSON"},
+        {"type", "Chat"},
+        {"team", TEAM},
+        {"slot", slot_->slot},
+        {"message", text},
+        {"data", nlohmann::json::array({{{"text", slot_->name + ": " + text}}})}
+    });
+}
+
+void MockSession::on_get(const nlohmann::json& packet, nlohmann::json& out) {
+    nlohmann::json keys = nlohmann::json::object();
+    for (const auto& key : packet.value("keys", nlohmann::json::array())) {
+        auto it = storage_.find(key.get<std::string>());
+        keys[key.get<std::string>()] = it != storage_.end() ? it->second : nlohmann::json();
+    }
+
+    nlohmann::json reply = packet;
+    reply["cmd"] = "Retrieved";
+    reply["keys"] = std::move(keys);
+    out.push_back(std::move(reply));
+}
+
+void MockSession::on_set(const nlohmann::json& packet, nlohmann::json& out) {
+    std::string key = packet.value("key", "");
+    nlohmann::json& value = storage_[key];
+    nlohmann::json original = value;
+
+    if (value.is_null()) {
+        value = packet.value("default", nlohmann::json());
+    }
+
+    // Only the operations mods commonly use; anything else acts as replace
+    for (const auto& op : packet.value("operations", nlohmann::json::array())) {
+        std::string operation = op.value("operation", "replace");
+        const nlohmann::json& operand = op.contains("value") ? op["value"] : nlohmann::json();
+        if (operation == "default") {
+            // Value already defaulted above
+        } else if (operation == "add" && value.is_number_integer() && operand.is_number_integer()) {
+            value = value.get<int64_t>() + operand.get<int64_t>();
+        } else if (operation == "add" && value.is_number() && operand.is_number()) {
+            value = value.get<double>() + operand.get<double>();
+        } else {
+            value = operand;
+        }
+    }
+
+    if (packet.value("want_reply", false)) {
+        nlohmann::json reply = packet;
+        reply["cmd"] = "SetReply";
+        reply["value"] = value;
+        reply["original_value"] = std::move(original);
+        out.push_back(std::move(reply));
+    }
+}
+
+// =============================================================================
+// Server-Initiated Packets
+// =============================================================================
+
+nlohmann::json MockSession::grant_items(int count) {
+    size_t first = received_.size();
+    for (int i = 0; i < count; ++i) {
+        int64_t item = scenario_.item_id_base +
+            static_cast<int64_t>((first + i) % std::max(scenario_.item_count, 1));
+        received_.push_back({item, -1, 0, 0});
+    }
+    return received_items_packet(first);
+}
+
+nlohmann::json MockSession::print(const std::string& text) const {
+    return {
+        {"cmd", "PrintJSON"},
+        {"data", nlohmann::json::array({{{"text", text}}})}
+    };
+}
+
+nlohmann::json MockSession::received_items_packet(size_t from_index) const {
+    nlohmann::json items = nlohmann::json::array();
+    for (size_t i = from_index; i < received_.size(); ++i) {
+        const auto& entry = received_[i];
+        items.push_back(network_item(entry.item, entry.location, entry.finder, entry.flags));
+    }
+
+    return {
+        {"cmd", "ReceivedItems"},
+        {"index", from_index},
+        {"items", std::move(items)}
+    };
+}
+
+nlohmann::json MockSession::item_send_packet(const MockPlacement& placement) const {
+    int finder = slot_->slot;
+    return {
+        {"cmd", "PrintJSON"},
+        {"type", "ItemSend"},
+        {"receiving", placement.receiver},
+        {"item", network_item(placement.item, placement.location, finder, placement.flags)},
+        {"data", nlohmann::json::array({
+            {{"type", "player_id"}, {"text", std::to_string(finder)}},
+            {{"text", " sent "}},
+            {{"type", "item_id"}, {"text", std::to_string(placement.item)},
+             {"player", placement.receiver}, {"flags", placement.flags}},
+            {{"text", " to "}},
+            {{"type", "player_id"}, {"text", std::to_string(placement.receiver)}},
+            {{"text", " ("}},
+            {{"type", "location_id"}, {"text", std::to_string(placement.location)}, {"player", finder}},
+            {{"text", ")"}}
+        })}
+    };
+}
+
+nlohmann::json MockSession::invalid_packet(const std::string& type, const std::string& text) {
+    return {
+        {"cmd", "InvalidPacket"},
+        {"type", type},
+        {"original_cmd", nullptr},
+        {"text", text}
+    };
+}
+
+} // namespace ap::mock
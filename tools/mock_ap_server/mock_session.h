@@ -0,0 +1,92 @@
+#pragma once
+
+#include "mock_scenario.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ap::mock {
+
+/**
+ * @brief Archipelago protocol state for one client connection.
+ *
+ * Transport-agnostic: handle() takes the packets a client sent and returns
+ * the packets to send back, so the same logic serves the websocket server
+ * and any in-process harness.
+ *
+ * Supported client packets: Connect, GetDataPackage, Sync, LocationChecks,
+ * LocationScouts, StatusUpdate, Say, Bounce, Get, Set. Anything else is
+ * answered with InvalidPacket.
+ */
+class MockSession {
+public:
+    explicit MockSession(const MockScenario& scenario);
+
+    /**
+     * @brief The RoomInfo packet sent when a client opens the socket.
+     */
+    nlohmann::json room_info() const;
+
+    /**
+     * @brief Handle a message from the client.
+     * @param packets JSON array of client packets.
+     * @return JSON array of server packets (may be empty).
+     */
+    nlohmann::json handle(const nlohmann::json& packets);
+
+    /**
+     * @brief Grant `count` more items to the connected slot.
+     * @return A ReceivedItems packet continuing the item index.
+     *
+     * Items cycle through the scenario's item IDs and are sent by the
+     * server (player 0, location -1), as when an admin uses /send.
+     */
+    nlohmann::json grant_items(int count);
+
+    /**
+     * @brief Build a server PrintJSON packet.
+     */
+    nlohmann::json print(const std::string& text) const;
+
+    bool connected() const { return slot_ != nullptr; }
+    int slot() const { return slot_ ? slot_->slot : 0; }
+    size_t items_received() const { return received_.size(); }
+    uint64_t packets_handled() const { return packets_handled_; }
+
+private:
+    struct ReceivedItem {
+        int64_t item = 0;
+        int64_t location = 0;
+        int finder = 0;
+        int flags = 0;
+    };
+
+    void handle_packet(const nlohmann::json& packet, nlohmann::json& out);
+
+    void on_connect(const nlohmann::json& packet, nlohmann::json& out);
+    void on_location_checks(const nlohmann::json& packet, nlohmann::json& out);
+    void on_location_scouts(const nlohmann::json& packet, nlohmann::json& out);
+    void on_say(const nlohmann::json& packet, nlohmann::json& out);
+    void on_get(const nlohmann::json& packet, nlohmann::json& out);
+    void on_set(const nlohmann::json& packet, nlohmann::json& out);
+
+    nlohmann::json received_items_packet(size_t from_index) const;
+    nlohmann::json item_send_packet(const MockPlacement& placement) const;
+    static nlohmann::json invalid_packet(const std::string& type, const std::string& text);
+
+    const MockScenario& scenario_;
+    const MockSlot* slot_ = nullptr;
+
+    std::vector<ReceivedItem> received_;
+    std::set<int64_t> checked_;
+    std::map<std::string, nlohmann::json> storage_;
+    int client_status_ = 0;
+    uint64_t packets_handled_ = 0;
+};
+
+} // namespace ap::mock